@@ -0,0 +1,639 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <PIDController.h>
+#include <CompactPIDController.h>
+#include <PIDBank.h>
+#include <PIDBankFloat.h>
+#include <LaplaceInversion.h>
+#include <DiscretePlant.h>
+#include <CascadeController.h>
+#include <StaticPIDController.h>
+#include <GainSchedule.h>
+#include <RelayAutoTuner.h>
+#include <SharedControllerState.h>
+#if defined(__cpp_impl_coroutine)
+#include <PIDCoroutine.h>
+#include <atomic>
+#include <thread>
+#endif
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <vector>
+#include <cmath>
+
+//------------------------------------------------------------------------------
+// Microbenchmarks for the PID controllers and the simulation helpers.
+//
+// Run with --benchmark_format=json (or --benchmark_out=<file>
+// --benchmark_out_format=json) for machine-readable results.
+//------------------------------------------------------------------------------
+
+static constexpr double SAMPLING_TIME = 0.001;
+
+static void configure(PIDController& pid, bool limits) {
+    pid.setGains(1.5, 0.8, 0.01);
+    if(limits) {
+        pid.setInputLimits(-100, 100);
+        pid.setOutputLimits(-10, 10);
+    }
+    pid.on();
+    pid.targetSetpoint(1.0);
+}
+
+//------------------------------------------------------------------------------
+// PIDController::calc, sampling time measured with the clock. Arg: limits.
+//------------------------------------------------------------------------------
+
+static void BM_CalcMeasured(benchmark::State& state) {
+    PIDController pid;
+    configure(pid, state.range(0) != 0);
+    double processVariable = 0;
+    for(auto _ : state) {
+        processVariable += 1e-6;
+        benchmark::DoNotOptimize(pid.calc(processVariable));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CalcMeasured)->ArgName("limits")->Arg(0)->Arg(1);
+
+//------------------------------------------------------------------------------
+// PIDController::calc with a fixed sampling time. Arg: limits.
+//------------------------------------------------------------------------------
+
+static void BM_CalcFixed(benchmark::State& state) {
+    PIDController pid;
+    configure(pid, state.range(0) != 0);
+    double processVariable = 0;
+    for(auto _ : state) {
+        processVariable += 1e-6;
+        benchmark::DoNotOptimize(pid.calc(processVariable, SAMPLING_TIME));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CalcFixed)->ArgName("limits")->Arg(0)->Arg(1);
+
+//------------------------------------------------------------------------------
+// PIDController::calc with a fixed sampling time on a cold cache: each call
+// goes to a different controller out of a set much larger than the last level
+// cache, visited in a scattered order. Arg: limits.
+//------------------------------------------------------------------------------
+
+static void BM_CalcFixedColdCache(benchmark::State& state) {
+    const size_t count = 1 << 18;
+    std::vector<PIDController> pids(count);
+    for(size_t i = 0; i < count; i++) {
+        configure(pids[i], state.range(0) != 0);
+    }
+    // Odd stride, so every controller is visited once per round.
+    const size_t stride = 40503;
+    size_t i = 0;
+    double processVariable = 0;
+    for(auto _ : state) {
+        processVariable += 1e-6;
+        benchmark::DoNotOptimize(pids[i].calc(processVariable, SAMPLING_TIME));
+        i = (i + stride) & (count - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CalcFixedColdCache)->ArgName("limits")->Arg(0)->Arg(1);
+
+//------------------------------------------------------------------------------
+// PIDBank::calcAll over N lanes with the best kernel. Arg: lanes.
+//------------------------------------------------------------------------------
+
+static void setUpBank(PIDBank& bank, size_t lanes) {
+    bank.resize(lanes);
+    for(size_t i = 0; i < lanes; i++) {
+        bank.setGains(i, 1.5, 0.8, 0.01);
+        bank.setOutputLimits(i, -10, 10);
+        bank.on(i);
+        bank.targetSetpoint(i, 1.0);
+    }
+}
+
+static void runBank(benchmark::State& state, PIDBank& bank) {
+    size_t lanes = bank.size();
+    std::vector<double> processVariable(lanes, 0.5);
+    std::vector<double> controlVariable(lanes);
+    for(auto _ : state) {
+        bank.calcAll(&processVariable[0], &controlVariable[0], lanes, SAMPLING_TIME);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * lanes);
+    state.counters["lanes"] = lanes;
+}
+
+static void BM_BankCalcAll(benchmark::State& state) {
+    PIDBank bank;
+    setUpBank(bank, state.range(0));
+    runBank(state, bank);
+}
+BENCHMARK(BM_BankCalcAll)->ArgName("lanes")->RangeMultiplier(4)->Range(1, 1 << 20);
+
+//------------------------------------------------------------------------------
+// PIDBank::calcAll over 4096 lanes with each kernel. Arg: PIDBank::Isa.
+//------------------------------------------------------------------------------
+
+static void BM_BankCalcAllIsa(benchmark::State& state) {
+    PIDBank bank;
+    if(!bank.setIsa((PIDBank::Isa)state.range(0))) {
+        state.SkipWithError("kernel not available on this CPU");
+        return;
+    }
+    setUpBank(bank, 4096);
+    runBank(state, bank);
+}
+BENCHMARK(BM_BankCalcAllIsa)->ArgName("isa")
+    ->Arg(PIDBank::ISA_SCALAR)->Arg(PIDBank::ISA_AVX2)->Arg(PIDBank::ISA_AVX512)->Arg(PIDBank::ISA_NEON);
+
+//------------------------------------------------------------------------------
+// PIDBank::calcAll over 4096 lanes with the best kernel and each anti-windup
+// mode. Arg: PIDBank::AntiWindup.
+//------------------------------------------------------------------------------
+
+static void BM_BankCalcAllAntiWindup(benchmark::State& state) {
+    PIDBank bank;
+    setUpBank(bank, 4096);
+    bank.setAntiWindup((PIDBank::AntiWindup)state.range(0));
+    for(size_t i = 0; i < bank.size(); i++) {
+        bank.setIntegratorLimits(i, -5, 5);
+    }
+    runBank(state, bank);
+}
+BENCHMARK(BM_BankCalcAllAntiWindup)->ArgName("antiWindup")
+    ->Arg(PIDBank::OUTPUT_CLAMP)->Arg(PIDBank::CONDITIONAL_INTEGRATION)
+    ->Arg(PIDBank::BACK_CALCULATION)->Arg(PIDBank::INTEGRATOR_CLAMP);
+
+//------------------------------------------------------------------------------
+// PIDBankFloat::calcAll with the best kernel, to compare with BM_BankCalcAll.
+// Arg: lanes.
+//------------------------------------------------------------------------------
+
+static void BM_BankFloatCalcAll(benchmark::State& state) {
+    size_t lanes = state.range(0);
+    PIDBankFloat bank(lanes);
+    for(size_t i = 0; i < lanes; i++) {
+        bank.setGains(i, 1.5f, 0.8f, 0.01f);
+        bank.setOutputLimits(i, -10, 10);
+        bank.on(i);
+        bank.targetSetpoint(i, 1.0f);
+    }
+    std::vector<float> processVariable(lanes, 0.5f);
+    std::vector<float> controlVariable(lanes);
+    for(auto _ : state) {
+        bank.calcAll(&processVariable[0], &controlVariable[0], lanes, (float)SAMPLING_TIME);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * lanes);
+    state.counters["lanes"] = lanes;
+}
+BENCHMARK(BM_BankFloatCalcAll)->ArgName("lanes")->RangeMultiplier(4)->Range(1, 1 << 20);
+
+//------------------------------------------------------------------------------
+// Accuracy of PIDBankFloat against the double PIDController over a long run:
+// both close a loop around their own copy of a first-order plant with a large
+// offset, so the integrator carries a big value while the error that feeds it
+// stays small, tracking a slow sine. Reports the largest output deviation
+// after 2^24 samples (4.6 hours at 1 kHz). Arg: Kahan summation.
+//------------------------------------------------------------------------------
+
+static void BM_BankFloatAccuracy(benchmark::State& state) {
+    PIDController pid;
+    pid.setGains(1.5, 0.8, 0);
+    pid.on();
+    PIDBankFloat bank(1);
+    bank.setCompensatedSummation(state.range(0) != 0);
+    bank.setGains(0, 1.5f, 0.8f, 0);
+    bank.on(0);
+    
+    double processVariable = 0;
+    float floatProcessVariable = 0;
+    float floatControlVariable;
+    double maximumDeviation = 0;
+    double t = 0;
+    for(auto _ : state) {
+        double setpoint = 1 + 0.5 * std::sin(0.01 * t);
+        pid.targetSetpoint(setpoint);
+        bank.targetSetpoint(0, (float)setpoint);
+        double controlVariable = pid.calc(processVariable, SAMPLING_TIME);
+        bank.calcAll(&floatProcessVariable, &floatControlVariable, 1, (float)SAMPLING_TIME);
+        processVariable += 0.01 * (controlVariable - 100 - processVariable);
+        floatProcessVariable += 0.01f * (floatControlVariable - 100 - floatProcessVariable);
+        maximumDeviation = std::fmax(maximumDeviation, std::fabs(controlVariable - floatControlVariable));
+        t += SAMPLING_TIME;
+    }
+    state.counters["maxDeviation"] = maximumDeviation;
+}
+BENCHMARK(BM_BankFloatAccuracy)->ArgName("kahan")->Arg(0)->Arg(1)->Iterations(1 << 24);
+
+//------------------------------------------------------------------------------
+// LaplaceInversion, one evaluation of the example's closed-loop response.
+//------------------------------------------------------------------------------
+
+static cmplex closedLoop(const cmplex& s) {
+    cmplex pid = 11.5 + 19.0/s;
+    cmplex plant = 1.0/((s+2.0)*(s+3.0));
+    return 10.0*(1.0/s)*(pid*plant)/(1.0+pid*plant);
+}
+
+static void BM_LaplaceInversion(benchmark::State& state) {
+    double t = 0.01;
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(LaplaceInversion(closedLoop, t, 1e-8));
+        t += 0.01;
+        if(t > 20) {
+            t = 0.01;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LaplaceInversion);
+
+//------------------------------------------------------------------------------
+// LaplaceInverter, one evaluation from precomputed coefficients, and one
+// interpolation from a tabulated response. Arg: interpolate.
+//------------------------------------------------------------------------------
+
+static void BM_LaplaceInverter(benchmark::State& state) {
+    LaplaceInverter inverter(closedLoop, 20, 1e-8);
+    bool interpolate = state.range(0) != 0;
+    if(interpolate) {
+        inverter.tabulate(0, 20, 20001);
+    }
+    double t = 0.01;
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(interpolate ? inverter.interpolate(t) : inverter(t));
+        t += 0.01;
+        if(t > 20) {
+            t = 0.01;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LaplaceInverter)->ArgName("interpolate")->Arg(0)->Arg(1);
+
+//------------------------------------------------------------------------------
+// One closed-loop sample against a discrete plant: calc() then plant step.
+// Arg: 0 transfer function, 1 ZOH state space.
+//------------------------------------------------------------------------------
+
+template <class Plant>
+static void runClosedLoop(benchmark::State& state, Plant plant) {
+    PIDController pid(1.5, 0.8, 0.01, SAMPLING_TIME);
+    pid.on();
+    pid.targetSetpoint(1.0);
+    double processVariable = 0;
+    for(auto _ : state) {
+        processVariable = plant.step(pid.calc(processVariable));
+        benchmark::DoNotOptimize(processVariable);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_ClosedLoopDiscretePlant(benchmark::State& state) {
+    if(state.range(0) == 0) {
+        runClosedLoop(state, pid::twoPolePlant(1, 2, 3, SAMPLING_TIME));
+    }
+    else {
+        double A[2][2] = { { 0, 1 }, { -6, -5 } };
+        double B[2] = { 0, 1 };
+        double C[2] = { 1, 0 };
+        runClosedLoop(state, pid::zeroOrderHold(A, B, C, SAMPLING_TIME));
+    }
+}
+BENCHMARK(BM_ClosedLoopDiscretePlant)->ArgName("stateSpace")->Arg(0)->Arg(1);
+
+//------------------------------------------------------------------------------
+// Windup recovery on the example plant with the output limited to +-20: a
+// setpoint the plant cannot reach for 20 s, then one it can. Reports the
+// simulated time to settle within 2% of the second setpoint as "recovery",
+// in seconds, alongside the cost per sample. Arg: PIDController::AntiWindup.
+//------------------------------------------------------------------------------
+
+static void BM_AntiWindupRecovery(benchmark::State& state) {
+    const int saturated = 20000;
+    const int steps = 40000;
+    double recovery = 0;
+    for(auto _ : state) {
+        PIDController pid(11.5, 19, 0, SAMPLING_TIME);
+        pid.setOutputLimits(-20, 20);
+        pid.setIntegratorLimits(-20, 20);
+        pid.setAntiWindup((PIDController::AntiWindup)state.range(0));
+        pid.on();
+        pid.targetSetpoint(10);
+        pid::DiscreteTransferFunction<2> plant = pid::twoPolePlant(1, 2, 3, SAMPLING_TIME);
+        double processVariable = 0;
+        recovery = 0;
+        for(int k = 0; k < steps; k++) {
+            if(k == saturated) {
+                pid.targetSetpoint(1);
+            }
+            processVariable = plant.step(pid.calc(processVariable));
+            if(k >= saturated && std::fabs(processVariable - 1) > 0.02) {
+                recovery = (k - saturated + 1) * SAMPLING_TIME;
+            }
+        }
+        benchmark::DoNotOptimize(processVariable);
+    }
+    state.SetItemsProcessed(state.iterations() * steps);
+    state.counters["recovery"] = recovery;
+}
+BENCHMARK(BM_AntiWindupRecovery)->ArgName("antiWindup")
+    ->Arg(PIDController::OUTPUT_CLAMP)->Arg(PIDController::CONDITIONAL_INTEGRATION)
+    ->Arg(PIDController::BACK_CALCULATION)->Arg(PIDController::INTEGRATOR_CLAMP);
+
+//------------------------------------------------------------------------------
+// One sample of a two-loop cascade. Arg: 0 chains two PIDControllers through
+// targetSetpoint() and calc() as callers used to, 1 is a CascadeController of
+// them, 2 a CascadeController of header-only controllers, fused into one
+// inlined step.
+//------------------------------------------------------------------------------
+
+typedef pid::PIDController<double, pid::OutputLimits, pid::FixedTimestep> CascadeLoop;
+
+static void BM_Cascade(benchmark::State& state) {
+    double outerProcessVariable = 0;
+    double innerProcessVariable = 0;
+    if(state.range(0) == 0) {
+        PIDController outer(1.5, 0.8, 0, -10, 10);
+        PIDController inner(3, 2, 0);
+        outer.on();
+        inner.on();
+        outer.targetSetpoint(1.0);
+        for(auto _ : state) {
+            outerProcessVariable += 1e-6;
+            innerProcessVariable += 1e-6;
+            inner.targetSetpoint(outer.calc(outerProcessVariable, SAMPLING_TIME));
+            benchmark::DoNotOptimize(inner.calc(innerProcessVariable, SAMPLING_TIME));
+        }
+    }
+    else if(state.range(0) == 1) {
+        pid::CascadeController<PIDController, PIDController> cascade;
+        cascade.outer().setGains(1.5, 0.8, 0);
+        cascade.outer().setOutputLimits(-10, 10);
+        cascade.inner().setGains(3, 2, 0);
+        cascade.on();
+        cascade.targetSetpoint(1.0);
+        for(auto _ : state) {
+            outerProcessVariable += 1e-6;
+            innerProcessVariable += 1e-6;
+            benchmark::DoNotOptimize(cascade.calc(outerProcessVariable, innerProcessVariable, SAMPLING_TIME));
+        }
+    }
+    else {
+        pid::CascadeController<CascadeLoop, CascadeLoop> cascade;
+        cascade.outer().setGains(1.5, 0.8, 0);
+        cascade.outer().setOutputLimits(-10, 10);
+        cascade.inner().setGains(3, 2, 0);
+        cascade.on();
+        cascade.targetSetpoint(1.0);
+        for(auto _ : state) {
+            outerProcessVariable += 1e-6;
+            innerProcessVariable += 1e-6;
+            benchmark::DoNotOptimize(cascade.calc(outerProcessVariable, innerProcessVariable, SAMPLING_TIME));
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Cascade)->ArgName("kind")->Arg(0)->Arg(1)->Arg(2);
+
+//------------------------------------------------------------------------------
+// 4096 PI loops with output limits stepped in a row. Arg: 0 the header-only
+// pid::PIDController with runtime gains, 1 pid::StaticPIDController with the
+// same gains as compile-time constants.
+//------------------------------------------------------------------------------
+
+static constexpr pid::StaticGains<double> STATIC_GAINS = { 1.5, 0.8, 0, -10, 10, SAMPLING_TIME };
+
+template <class Loop>
+static void runLoops(benchmark::State& state, std::vector<Loop>& loops) {
+    double processVariable = 0.5;
+    for(auto _ : state) {
+        double sum = 0;
+        for(size_t i = 0; i < loops.size(); i++) {
+            sum += loops[i].calc(processVariable);
+        }
+        benchmark::DoNotOptimize(sum);
+        processVariable += 1e-6;
+    }
+    state.SetItemsProcessed(state.iterations() * loops.size());
+    state.counters["bytesPerLoop"] = sizeof(Loop);
+}
+
+static void BM_StaticLoops(benchmark::State& state) {
+    if(state.range(0) == 0) {
+        std::vector<CascadeLoop> loops(4096, CascadeLoop(1.5, 0.8, 0));
+        for(size_t i = 0; i < loops.size(); i++) {
+            loops[i].setOutputLimits(-10, 10);
+            loops[i].setSamplingPeriod(SAMPLING_TIME);
+            loops[i].on();
+            loops[i].targetSetpoint(1.0);
+        }
+        runLoops(state, loops);
+    }
+    else {
+        std::vector<pid::StaticPIDController<STATIC_GAINS> > loops(4096);
+        for(size_t i = 0; i < loops.size(); i++) {
+            loops[i].on();
+            loops[i].targetSetpoint(1.0);
+        }
+        runLoops(state, loops);
+    }
+}
+BENCHMARK(BM_StaticLoops)->ArgName("static")->Arg(0)->Arg(1);
+
+//------------------------------------------------------------------------------
+// 4096 loops with limits stepped in a row, and copied to another array as
+// when a shard is handed to another worker. Arg: 0 PIDController, 1
+// CompactPIDController.
+//------------------------------------------------------------------------------
+
+template <class Loop>
+static std::vector<Loop> packedLoops() {
+    std::vector<Loop> loops(4096, Loop(1.5, 0.8, 0.01, -100, 100, -10, 10));
+    for(size_t i = 0; i < loops.size(); i++) {
+        loops[i].setSamplingPeriod(SAMPLING_TIME);
+        loops[i].on();
+        loops[i].targetSetpoint(1.0);
+    }
+    return loops;
+}
+
+static void BM_PackedLoops(benchmark::State& state) {
+    if(state.range(0) == 0) {
+        std::vector<PIDController> loops = packedLoops<PIDController>();
+        runLoops(state, loops);
+    }
+    else {
+        std::vector<CompactPIDController> loops = packedLoops<CompactPIDController>();
+        runLoops(state, loops);
+    }
+}
+BENCHMARK(BM_PackedLoops)->ArgName("compact")->Arg(0)->Arg(1);
+
+template <class Loop>
+static void copyLoops(benchmark::State& state) {
+    std::vector<Loop> loops = packedLoops<Loop>();
+    std::vector<Loop> shard(loops.size());
+    for(auto _ : state) {
+        std::copy(loops.begin(), loops.end(), shard.begin());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * loops.size());
+    state.counters["bytesPerLoop"] = sizeof(Loop);
+}
+
+static void BM_CopyLoops(benchmark::State& state) {
+    if(state.range(0) == 0) {
+        copyLoops<PIDController>(state);
+    }
+    else {
+        copyLoops<CompactPIDController>(state);
+    }
+}
+BENCHMARK(BM_CopyLoops)->ArgName("compact")->Arg(0)->Arg(1);
+
+//------------------------------------------------------------------------------
+// PIDController::calc with a 64-row gain schedule on the process variable.
+// Arg: 0 evenly spaced rows (constant-time lookup), 1 uneven rows (binary
+// search).
+//------------------------------------------------------------------------------
+
+static void BM_CalcGainSchedule(benchmark::State& state) {
+    std::vector<GainSchedulePoint> points(64);
+    double variable = 0;
+    for(size_t i = 0; i < points.size(); i++) {
+        variable += state.range(0) == 0 ? 0.1 : 0.05 + 0.1 * (i % 3);
+        points[i].variable = variable;
+        points[i].kp = 1.5 + 0.01 * i;
+        points[i].ki = 0.8 + 0.005 * i;
+        points[i].kd = 0.01;
+    }
+    GainSchedule schedule;
+    schedule.setPoints(&points[0], points.size());
+    
+    PIDController pid;
+    configure(pid, true);
+    pid.setGainSchedule(&schedule, PIDController::SCHEDULE_ON_PROCESS_VARIABLE);
+    double processVariable = 0;
+    for(auto _ : state) {
+        processVariable += 1e-4;
+        benchmark::DoNotOptimize(pid.calc(processVariable, SAMPLING_TIME));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CalcGainSchedule)->ArgName("uneven")->Arg(0)->Arg(1);
+
+//------------------------------------------------------------------------------
+// PIDBank::calcAll over 4096 lanes while some of them auto-tune. Arg: number of
+// tuning lanes.
+//------------------------------------------------------------------------------
+
+static void BM_BankCalcAllAutoTune(benchmark::State& state) {
+    PIDBank bank;
+    setUpBank(bank, 4096);
+    std::vector<RelayAutoTuner> tuners(state.range(0), RelayAutoTuner(1.0, 0.01));
+    for(size_t i = 0; i < tuners.size(); i++) {
+        bank.autoTune(i * (4096 / tuners.size()), &tuners[i]);
+    }
+    runBank(state, bank);
+}
+BENCHMARK(BM_BankCalcAllAutoTune)->ArgName("tuning")->Arg(0)->Arg(64)->Arg(4096);
+
+//------------------------------------------------------------------------------
+// PIDController::calc at steady state, with the process variable jittering
+// within 1e-4 of the setpoint. Arg: 0 computes every sample, 1 event-driven
+// with a 1e-3 deadband, which skips them.
+//------------------------------------------------------------------------------
+
+static void BM_CalcEventDriven(benchmark::State& state) {
+    PIDController pid;
+    configure(pid, true);
+    if(state.range(0) != 0) {
+        pid.setEventThresholds(1e-3, 1e-3);
+    }
+    double jitter = 1e-4;
+    for(auto _ : state) {
+        jitter = -jitter;
+        benchmark::DoNotOptimize(pid.calc(1.0 + jitter, SAMPLING_TIME));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CalcEventDriven)->ArgName("eventDriven")->Arg(0)->Arg(1);
+
+//------------------------------------------------------------------------------
+// PIDController::calc followed by SharedControllerState::publish, the cost the
+// real-time side pays to make a loop visible to other processes.
+//------------------------------------------------------------------------------
+
+static void BM_CalcSharedPublish(benchmark::State& state) {
+    SharedControllerState shared;
+    if(!shared.create("/pid-bench", 1)) {
+        state.SkipWithError("cannot create shared memory segment");
+        return;
+    }
+    PIDController pid;
+    configure(pid, true);
+    pid.setParameterChannel(shared.getChannel(0));
+    double processVariable = 0;
+    for(auto _ : state) {
+        processVariable += 1e-6;
+        benchmark::DoNotOptimize(pid.calc(processVariable, SAMPLING_TIME));
+        shared.publish(0, pid);
+    }
+    state.SetItemsProcessed(state.iterations());
+    shared.close();
+    SharedControllerState::remove("/pid-bench");
+}
+BENCHMARK(BM_CalcSharedPublish);
+
+#if defined(__cpp_impl_coroutine)
+//------------------------------------------------------------------------------
+// pid::ControlExecutor with two workers: one sample is posted to every task
+// and the iteration ends when all outputs have been delivered. Each task
+// steps its controller with every sample, using the nominal period for the
+// first one. Arg: number of tasks.
+//------------------------------------------------------------------------------
+
+static pid::ControlTask benchLoop(PIDController& pid) {
+    for(;;) {
+        pid::Sample sample = co_await pid::nextSample();
+        double samplingTime = sample.samplingTime > 0 ? sample.samplingTime : SAMPLING_TIME;
+        co_yield pid.calc(sample.value, samplingTime);
+    }
+}
+
+static void BM_ControlExecutor(benchmark::State& state) {
+    size_t tasks = state.range(0);
+    std::vector<PIDController> pids(tasks);
+    std::atomic<long> outputs(0);
+    pid::ControlExecutor executor(2);
+    for(size_t i = 0; i < tasks; i++) {
+        configure(pids[i], true);
+        executor.spawn(benchLoop(pids[i]), [&outputs](double) {
+            outputs.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+    executor.start();
+    
+    double timestamp = 0;
+    long expected = 0;
+    for(auto _ : state) {
+        timestamp += SAMPLING_TIME;
+        for(size_t i = 0; i < tasks; i++) {
+            executor.post(i, 0.5, timestamp);
+        }
+        expected += tasks;
+        while(outputs.load(std::memory_order_relaxed) < expected) {
+            std::this_thread::yield();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * tasks);
+    executor.stop();
+}
+BENCHMARK(BM_ControlExecutor)->ArgName("tasks")->Arg(1024)->Arg(16384)->UseRealTime();
+#endif
+
+BENCHMARK_MAIN();
@@ -9,6 +9,8 @@
 #include <complex>
 #include <iostream>
 #include <fstream>
+#include <vector>
+#include <thread>
 
 using namespace std;
 
@@ -21,83 +23,113 @@ int test_case=1;
 inline void  upperswap(double &u,const double v){if (v>u){u=v;}}
 
 /***********************************************************************
-        LaplaceInversion
+        LaplaceWorkspace
 ************************************************************************
-Returns Inverse Laplace transform f(t) of function F(s), 
-where s is complex, evaluated at time t
-
-  f(t) = 1/2*PI*i \intfrmto{gamma-i\infty}{gamma+i\infty} exp(st)*F(s) ds
-
-Based upon De Hoog et al., 1982, An improved method for numerical inversion of 
-Laplace transforms, SIAM J. Sci. Stat. Comput.
-
-Speed of algorithm is primarily a function of M, the order of the 
-Taylor series expansion. 
+Scratch storage for one De Hoog inversion of order M: the F(s) samples, the
+quotient-difference tables e and q, the continued fraction coefficients d and
+the recurrence terms A, B. Sized to the actual order: e and q hold
+(2M+1)(M+1) complex doubles each, and the rest 8M+6 more, so about 111 KB
+for M=40, 106 KB of it in e and q.
 
-Inputs: F(s), a function pointer to some complex function of a single 
-        complex variable
-        t is the desired time of evaluation of f(t)
-        tolerance is the required accuracy of f(t)
+A workspace belongs to one caller at a time. Give each thread its own and any
+number of inversions can run in parallel.
 -----------------------------------------------------------------------*/
-double LaplaceInversion(cmplex       (*F)(const cmplex &s),
-                        const double &t,
-                        const double tolerance)
+struct LaplaceWorkspace
 {
-  //--Variable declaration---------------------------------
-  int    i,n,m,r;          //counters & intermediate array indices
-  int    M(40);            //order of Taylor Expansion (must be less than MAX_LAPORDER)
-  double DeHoogFactor(4.0);//DeHoog time factor
-  double T;                //Period of DeHoog Inversion formula
-  double gamma;            //Integration limit parameter
-  cmplex h2M,R2M,z,dz,s;   //Temporary variables
+  int            M;        //order of Taylor Expansion
+  vector<cmplex> Fctrl;
+  vector<cmplex> e;        //e[i][r] stored as e[i*(M+1)+r]
+  vector<cmplex> q;        //q[i][r] stored as q[i*(M+1)+r]
+  vector<cmplex> d;
+  vector<cmplex> A;
+  vector<cmplex> B;
 
-  static cmplex Fctrl [2*MAX_LAPORDER+1];
-  static cmplex e     [2*MAX_LAPORDER][MAX_LAPORDER];
-  static cmplex q     [2*MAX_LAPORDER][MAX_LAPORDER];
-  static cmplex d     [2*MAX_LAPORDER+1];
-  static cmplex A     [2*MAX_LAPORDER+2]; 
-  static cmplex B     [2*MAX_LAPORDER+2]; 
+  explicit LaplaceWorkspace(const int order=40)
+    : M(order),
+      Fctrl(2*order+1),
+      e((2*order+1)*(order+1)),
+      q((2*order+1)*(order+1)),
+      d(2*order+1),
+      A(2*order+2),
+      B(2*order+2)
+  {}
+};
 
-  //Calculate period and integration limits------------------------------------
-  T    =DeHoogFactor*t;    
-  gamma=-0.5*log(tolerance)/T;
+/***********************************************************************
+        LaplaceCoefficients
+************************************************************************
+Fills w.d with the continued fraction coefficients of F for De Hoog period T
+and integration limit gamma: the part of the inversion that does not depend
+on t. This is likely the most time consuming portion of the algorithm.
+-----------------------------------------------------------------------*/
+template <class Function>
+void LaplaceCoefficients(Function         &F,
+                         const double     T,
+                         const double     gamma,
+                         LaplaceWorkspace &w)
+{
+  int    i,m,r;
+  const int M=w.M;
+  cmplex s;
+#define LAP_E(i,r) w.e[(i)*(M+1)+(r)]
+#define LAP_Q(i,r) w.q[(i)*(M+1)+(r)]
 
   //Calculate F(s) at evalution points gamma+IM*i*PI/T for i=0 to 2*M-1--------
-  //This is likely the most time consuming portion of the DeHoog algorithm
-  Fctrl[0]=0.5*F(gamma); 
+  w.Fctrl[0]=0.5*F(gamma); 
   for (i=1; i<=2*M;i++)
   {
     s=cmplex(gamma,i*PI/T);
-    Fctrl[i]=F(s);
+    w.Fctrl[i]=F(s);
   }
 
   //Evaluate e and q ----------------------------------------------------------
   //eqn 20 of De Hoog et al 1982
   for (i=0;i<2*M;i++)
   {
-    e[i][0]=0.0;
-    q[i][1]=Fctrl[i+1]/Fctrl[i];
+    LAP_E(i,0)=0.0;
+    LAP_Q(i,1)=w.Fctrl[i+1]/w.Fctrl[i];
   }
-  e[2*M][0]=0.0;
+  LAP_E(2*M,0)=0.0;
 
   for (r=1;r<=M-1;r++) //one minor correction - does not work for r<=M, as suggested in paper
   {
     for (i=2*(M-r);i>=0;i--)
     {     
       if ((i<2*(M-r)) && (r>1)){
-      q[i][r]=q[i+1][r-1]*e[i+1][r-1]/e[i  ][r-1];
+      LAP_Q(i,r)=LAP_Q(i+1,r-1)*LAP_E(i+1,r-1)/LAP_E(i,r-1);
       }
-      e[i][r]=q[i+1][r  ]-q[i  ][r  ]+e[i+1][r-1];
+      LAP_E(i,r)=LAP_Q(i+1,r)-LAP_Q(i,r)+LAP_E(i+1,r-1);
     }
   }
 
   //Populate d vector----------------------------------------------------------- 
-  d[0]=Fctrl[0];
+  w.d[0]=w.Fctrl[0];
   for (m=1;m<=M;m++)
   {
-    d[2*m-1]=-q[0][m];
-    d[2*m  ]=-e[0][m];
+    w.d[2*m-1]=-LAP_Q(0,m);
+    w.d[2*m  ]=-LAP_E(0,m);
   }
+#undef LAP_E
+#undef LAP_Q
+}
+
+/***********************************************************************
+        LaplaceContinuedFraction
+************************************************************************
+Evaluates f(t) from the coefficients d of order M found by
+LaplaceCoefficients() for period T and integration limit gamma. A and B must
+hold 2*M+2 values each.
+-----------------------------------------------------------------------*/
+inline double LaplaceContinuedFraction(const cmplex *d,
+                                       const int    M,
+                                       const double T,
+                                       const double gamma,
+                                       const double t,
+                                       cmplex       *A,
+                                       cmplex       *B)
+{
+  int    n;
+  cmplex h2M,R2M,z,dz;
 
   //Evaluate A, B---------------------------------------------------------------
   //Eqn. 21 in De Hoog et al.
@@ -123,6 +155,221 @@ double LaplaceInversion(cmplex       (*F)(const cmplex &s),
   //Final result: A[2*M]/B[2*M]=sum [F(gamma+itheta)*exp(itheta)]-------------
   return 1.0/T*exp(gamma*t)*(A[2*M+1]/B[2*M+1]).real();
 }
+
+/***********************************************************************
+        LaplaceInversion
+************************************************************************
+Returns Inverse Laplace transform f(t) of function F(s), 
+where s is complex, evaluated at time t
+
+  f(t) = 1/2*PI*i \intfrmto{gamma-i\infty}{gamma+i\infty} exp(st)*F(s) ds
+
+Based upon De Hoog et al., 1982, An improved method for numerical inversion of 
+Laplace transforms, SIAM J. Sci. Stat. Comput.
+
+Speed of algorithm is primarily a function of M, the order of the 
+Taylor series expansion, which is taken from the workspace.
+
+Reentrant: all scratch storage lives in the caller-owned workspace w.
+
+Inputs: F(s), any callable mapping a complex variable to a complex value
+        t is the desired time of evaluation of f(t)
+        tolerance is the required accuracy of f(t)
+        w is the scratch storage, used by one caller at a time
+-----------------------------------------------------------------------*/
+template <class Function>
+double LaplaceInversion(Function         F,
+                        const double     &t,
+                        const double     tolerance,
+                        LaplaceWorkspace &w)
+{
+  double DeHoogFactor(4.0);//DeHoog time factor
+  double T;                //Period of DeHoog Inversion formula
+  double gamma;            //Integration limit parameter
+
+  //Calculate period and integration limits------------------------------------
+  T    =DeHoogFactor*t;    
+  gamma=-0.5*log(tolerance)/T;
+
+  LaplaceCoefficients(F,T,gamma,w);
+  return LaplaceContinuedFraction(&w.d[0],w.M,T,gamma,t,&w.A[0],&w.B[0]);
+}
+
+/***********************************************************************
+        LaplaceInversion
+************************************************************************
+As above with M=40, using a workspace private to the calling thread, so it
+is safe to call from several threads at once.
+-----------------------------------------------------------------------*/
+inline double LaplaceInversion(cmplex       (*F)(const cmplex &s),
+                               const double &t,
+                               const double tolerance)
+{
+  static thread_local LaplaceWorkspace w(40);
+  return LaplaceInversion(F,t,tolerance,w);
+}
+
+/***********************************************************************
+        LaplaceInversionSweep
+************************************************************************
+Evaluates f(t[k]) for k=0 to n-1 with LaplaceInversion(), splitting the
+times across 'threads' threads (0 for one per hardware thread), each with
+its own workspace of order M.
+-----------------------------------------------------------------------*/
+template <class Function>
+void LaplaceInversionSweep(Function       F,
+                           const double   *t,
+                           double         *f,
+                           const size_t   n,
+                           const double   tolerance,
+                           unsigned       threads=0,
+                           const int      M=40)
+{
+  if (threads==0){threads=thread::hardware_concurrency();}
+  if (threads==0){threads=1;}
+  if (threads>n) {threads=(unsigned)n;}
+
+  vector<thread> workers;
+  for (unsigned j=0;j<threads;j++)
+  {
+    size_t begin=n*j/threads, end=n*(j+1)/threads;
+    workers.push_back(thread([=]()
+    {
+      LaplaceWorkspace w(M);
+      for (size_t k=begin;k<end;k++){f[k]=LaplaceInversion(F,t[k],tolerance,w);}
+    }));
+  }
+  for (size_t j=0;j<workers.size();j++){workers[j].join();}
+}
+//-----------------------------------------------------------------------
+
+/***********************************************************************
+        LaplaceInverter
+************************************************************************
+Inverse Laplace transform of a fixed F(s) at many times.
+
+LaplaceInversion() picks the De Hoog period T from t, so every call
+evaluates F(s) at 2M+1 points and rebuilds the e/q tables. LaplaceInverter
+instead splits the horizon (0, tmax] into octaves (tmax/2^(k+1), tmax/2^k]
+and fixes one period per octave, T = DeHoogFactor/2 * tmax/2^k. Within an
+octave, the F(s) samples, the quotient-difference tables and the continued
+fraction coefficients d no longer depend on t, so they are computed once in
+the constructor. Each evaluation is then a single O(M) continued fraction
+recurrence with no calls to F. Keeping t/T within (1/4, 1/2] holds the
+results to the accuracy of LaplaceInversion(). Times below the last octave,
+t<=0 included, use the last octave, and times from tmax on use the first.
+
+For a fixed horizon, tabulate() additionally samples f(t) on a uniform grid
+so that interpolate() costs one linear interpolation. interpolate() returns
+NaN while there is no table, i.e. before tabulate() or after a tabulate()
+with fewer than two times.
+
+Inputs: F, any callable mapping const cmplex & to cmplex
+        tmax is the end of the time horizon of interest
+        tolerance is the required accuracy of f(t)
+        octaves is the number of octaves below tmax to precompute, at least 1
+        M is the order of the Taylor expansion, clamped to 1..MAX_LAPORDER
+        since evaluation keeps its recurrence terms on the stack
+-----------------------------------------------------------------------*/
+class LaplaceInverter
+{
+public:
+  template <class Function>
+  LaplaceInverter(Function      F,
+                  const double  tmax,
+                  const double  tolerance,
+                  const int     octaves=24,
+                  const int     order=40)
+  {
+    M   =order;
+    if (M<1)           {M=1;}
+    if (M>MAX_LAPORDER){M=MAX_LAPORDER;}
+    Tmax=tmax;
+    for (int k=0;k<octaves || k<1;k++)
+    {
+      segments.push_back(Segment());
+      precompute(F,0.5*DeHoogFactor*tmax/pow(2.0,k),tolerance,segments.back());
+    }
+    tableStart=0.0; tableStep=1.0;
+  }
+
+  //f(t) for one time, from the precomputed coefficients
+  double operator()(const double t) const
+  {
+    int k=(int)segments.size()-1;
+    if (t>=Tmax)    {k=0;}
+    else if (t>0.0)
+    {
+      frexp(Tmax/t,&k);  // Tmax/t in [2^(k-1), 2^k), so t is in octave k-1
+      k=k-1;
+      if (k>=(int)segments.size()){k=(int)segments.size()-1;}
+    }
+    return evaluate(segments[k],t);
+  }
+
+  //f(t[k]) for k=0 to n-1
+  void evaluate(const double *t, double *f, const size_t n) const
+  {
+    for (size_t k=0;k<n;k++){f[k]=(*this)(t[k]);}
+  }
+
+  //Samples f(t) at n>=2 evenly spaced times from t0 to t1 for interpolate();
+  //a smaller n leaves no table
+  void tabulate(const double t0, const double t1, const size_t n)
+  {
+    if (n<2){table.clear();return;}
+    tableStart=t0;
+    tableStep =(t1-t0)/(n-1);
+    table.resize(n);
+    for (size_t k=0;k<n;k++){table[k]=(*this)(t0+k*tableStep);}
+  }
+
+  //Linear interpolation in the table built by tabulate(), clamped to its ends
+  double interpolate(const double t) const
+  {
+    if (table.empty())        {return NAN;}
+    double x=(t-tableStart)/tableStep;
+    if (x<=0.0)               {return table.front();}
+    if (x>=table.size()-1.0)  {return table.back();}
+    size_t k=(size_t)x;
+    double w=x-k;
+    return table[k]+w*(table[k+1]-table[k]);
+  }
+
+private:
+  static constexpr double DeHoogFactor=4.0;
+
+  struct Segment
+  {
+    double         T;      //Period of DeHoog Inversion formula
+    double         gamma;  //Integration limit parameter
+    vector<cmplex> d;      //continued fraction coefficients
+  };
+
+  int             M;       //order of Taylor Expansion
+  double          Tmax;    //end of the horizon
+  vector<Segment> segments;
+  double          tableStart,tableStep;
+  vector<double>  table;
+
+  //Everything in LaplaceInversion() that does not depend on t, for period T
+  template <class Function>
+  void precompute(Function &F, const double T, const double tolerance, Segment &seg)
+  {
+    LaplaceWorkspace w(M);
+    seg.T    =T;
+    seg.gamma=-0.5*log(tolerance)/T;
+    LaplaceCoefficients(F,seg.T,seg.gamma,w);
+    seg.d=w.d;
+  }
+
+  //The t-dependent part of LaplaceInversion(): eqns. 21, 23 and 24
+  double evaluate(const Segment &seg, const double t) const
+  {
+    cmplex A[2*MAX_LAPORDER+2],B[2*MAX_LAPORDER+2];
+    return LaplaceContinuedFraction(&seg.d[0],M,seg.T,seg.gamma,t,A,B);
+  }
+};
 //-----------------------------------------------------------------------
 
 #endif /* LAP_INV_H */
@@ -1,7 +1,8 @@
 #include <PIDController.h>
 #include <LaplaceInversion.h>
+#include <Telemetry.h>
 #include <iostream>
-#include <fstream>
+#include <unistd.h>
 
 using namespace std;
 
@@ -35,25 +36,31 @@ int main(int argc, char *argv[])
 
     double controlVariable = 0; // Init with zero actuation
     double processVariable = 0; // Init with zero position
+    
+    LaplaceInverter plant(xferFn, 20, 1e-8); // Precompute the plant response up to 20s
    
     cout << "Simulation running..." << endl;
     
-    ofstream writeToCsv;
-    writeToCsv.open("PIDexample.csv");
-    writeToCsv << "Time,Setpoint,Output" << endl;
+    TelemetryRecorder telemetry;
+    telemetry.open("PIDexample.tlm");
 
     while(t < 20) {
-        writeToCsv << t << "," << pid->getSetpoint() << "," << processVariable << endl;
+        PIDOutput output = pid->calcDetailed(processVariable); // Calculate next controlVariable
+        controlVariable = output.output;
+        telemetry.record(t, 0, output); // Queued for the writer thread, never blocks
         
-        controlVariable = pid->calc(processVariable); // Calculate next controlVariable
-        processVariable = LaplaceInversion(xferFn, t, 1e-8); // Simulate plant with TF 1/((s+a)(s+b))
+        processVariable = plant(t); // Simulate plant with TF 1/((s+a)(s+b))
 
         usleep(T*pow(10,6)); // 100ms delay to simulate actuation time
         t += T; // Increment time variable by 100ms
     }
 
-	writeToCsv.close();
-    cout << "Simulation complete! Output saved to PIDexample.csv." << endl;
+	if(!telemetry.close()) {
+        cout << "Could not write " << telemetry.getWriteErrors() << " samples to PIDexample.tlm." << endl;
+        return 1;
+    }
+    cout << "Simulation complete! Output saved to PIDexample.tlm." << endl;
+    cout << "Convert it with: telemetry2csv PIDexample.tlm PIDexample.csv" << endl;
 	
     return 0;
 }
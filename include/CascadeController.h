@@ -0,0 +1,131 @@
+/* 
+ * File:   CascadeController.h
+ * Author: User
+ *
+ * Created on October 14, 2026
+ */
+
+#ifndef CASCADECONTROLLER_H
+#define CASCADECONTROLLER_H
+
+#include "PIDControllerTemplate.h"
+
+// Composition of controllers into cascades and feed-forward stages.
+//
+// A stage is any controller with
+//
+//     value track(value setpoint, value processVariable, value samplingTime);
+//
+// which sets the setpoint and computes the output in one call without
+// reading a clock: pid::PIDController, ::PIDController, and the combinators
+// below. With header-only stages the whole chain is one inlinable function
+// sharing a single sampling time.
+namespace pid {
+
+//------------------------------------------------------------------------------
+// CascadeController
+//------------------------------------------------------------------------------
+//
+// Two loops in cascade: the output of the outer loop is the setpoint of the
+// inner one.
+//
+//     pid::CascadeController<Outer, Inner> loop;
+//     loop.outer().setGains(...);              // e.g. temperature
+//     loop.inner().setGains(...);              // e.g. flow
+//     loop.on();
+//     loop.targetSetpoint(80);
+//     valve = loop.calc(temperature, flow, T);
+//
+// The outer loop is stepped with calc(processVariable, samplingTime) and the
+// inner one with track(), so neither reads a clock. Scalar is the value type
+// of both loops.
+//------------------------------------------------------------------------------
+
+template <class Outer, class Inner, class Scalar = double>
+class CascadeController {
+    public:
+        Outer& outer() { return outerLoop; }
+        Inner& inner() { return innerLoop; }
+        
+        void targetSetpoint(Scalar setpoint) { outerLoop.targetSetpoint(setpoint); }
+        
+        void on() {
+            outerLoop.on();
+            innerLoop.on();
+        }
+        
+        void off() {
+            outerLoop.off();
+            innerLoop.off();
+        }
+        
+        // Steps both loops with one sampling time and returns the inner
+        // loop's output.
+        Scalar calc(Scalar outerProcessVariable, Scalar innerProcessVariable, Scalar samplingTime) {
+            Scalar innerSetpoint = Scalar(outerLoop.calc(outerProcessVariable, samplingTime));
+            return Scalar(innerLoop.track(innerSetpoint, innerProcessVariable, samplingTime));
+        }
+        
+    private:
+        Outer outerLoop;
+        Inner innerLoop;
+};
+
+//------------------------------------------------------------------------------
+// FeedForward
+//------------------------------------------------------------------------------
+//
+// A stage whose output is the feedback output of Stage plus feed-forward:
+//
+//     output = limit(stage + setpointGain * setpoint + feedForward)
+//
+// setpointGain is a static feed-forward of the setpoint, e.g. the inverse of
+// the plant's DC gain, and feedForward a term refreshed by the caller each
+// sample, e.g. from a measured disturbance. The limits apply to the sum, so
+// give Stage itself no output limits (or wider ones) to avoid clamping twice.
+// A FeedForward is a stage, so it can be the inner loop of a cascade.
+//------------------------------------------------------------------------------
+
+template <class Stage, class Scalar = double>
+class FeedForward {
+    public:
+        FeedForward()
+            : setpointGain(0), feedForward(0), lowerOutputLimit(-1), upperOutputLimit(-1) {}
+        
+        Stage& controller() { return stage; }
+        
+        void setSetpointGain(Scalar setpointGain) { this->setpointGain = setpointGain; }
+        void setFeedForward(Scalar feedForward) { this->feedForward = feedForward; }
+        void setOutputLimits(Scalar lowerLimit, Scalar upperLimit) {
+            lowerOutputLimit = lowerLimit;
+            upperOutputLimit = upperLimit;
+        }
+        
+        void targetSetpoint(Scalar setpoint) { stage.targetSetpoint(setpoint); }
+        void on() { stage.on(); }
+        void off() { stage.off(); }
+        
+        Scalar track(Scalar setpoint, Scalar processVariable, Scalar samplingTime) {
+            Scalar output = Scalar(stage.track(setpoint, processVariable, samplingTime));
+            Scalar setpointTerm = setpointGain * setpoint;
+            output = output + setpointTerm;
+            output = output + feedForward;
+            return detail::limiter(output, lowerOutputLimit, upperOutputLimit);
+        }
+        
+        // Steps the stage at the setpoint given to targetSetpoint().
+        Scalar calc(Scalar processVariable, Scalar samplingTime) {
+            return track(Scalar(stage.getSetpoint()), processVariable, samplingTime);
+        }
+        
+    private:
+        Stage stage;
+        Scalar setpointGain;
+        Scalar feedForward;
+        Scalar lowerOutputLimit, upperOutputLimit;
+};
+
+} // namespace pid
+
+#endif  /* CASCADECONTROLLER_H */
+
@@ -0,0 +1,82 @@
+/* 
+ * File:   CompactPIDController.h
+ * Author: User
+ *
+ * Created on October 14, 2026
+ */
+
+#ifndef COMPACTPIDCONTROLLER_H
+#define COMPACTPIDCONTROLLER_H
+
+#include "PIDController.h"
+#include <type_traits>
+
+// A PIDController reduced to its configuration and running state, for loops
+// that are packed into arrays, checkpointed with memcpy, or moved between
+// threads.
+//
+// Its only member is a PIDState, so the object is plain data: it has no
+// vtable, copies and moves are memcpy and keep the running state, and it
+// converts to and from a PIDController with getState() and setState(). It is
+// aligned to a cache line and padded to whole lines (192 bytes, against 304
+// for a PIDController), so neighbours in an array that are stepped by
+// different threads never share a line.
+//
+// calc() computes exactly what PIDController::calc() does with the same
+// settings, in every algorithm, derivative mode, and anti-windup mode: both
+// run the one step on a PIDState in src/PIDStep.h. What needs more than the
+// state is left out: there is no clock, so calc(processVariable) needs a
+// fixed sampling period, and no parameter channel, instrumentation,
+// analyzer, gain schedule, auto-tuner, or event thresholds can be attached. Like PIDController, it is meant to be used
+// from one thread at a time.
+class alignas(64) CompactPIDController {
+    public:
+        CompactPIDController();
+        CompactPIDController(double kp, double ki, double kd);
+        CompactPIDController(double kp, double ki, double kd, double samplingPeriod);
+        CompactPIDController(double kp, double ki, double kd, double lowerOutputLimit, double upperOutputLimit);
+        CompactPIDController(double kp, double ki, double kd, double lowerInputLimit, double upperInputLimit, double lowerOutputLimit, double upperOutputLimit);
+        explicit CompactPIDController(const PIDState& state);
+
+        void targetSetpoint(double setpoint);
+        void setGains(double kp, double ki, double kd);
+        void off();
+        void on();
+        void setInputLimits(double lowerLimit, double upperLimit);
+        void setOutputLimits(double lowerLimit, double upperLimit);
+        void setSamplingPeriod(double samplingPeriod);
+        void setAlgorithm(PIDController::Algorithm algorithm);
+        void setDerivativeMode(PIDController::DerivativeMode mode);
+        void setDerivativeFilter(double timeConstant);
+        void setAntiWindup(PIDController::AntiWindup antiWindup);
+        void setTrackingGain(double trackingGain);
+        void setIntegratorLimits(double lowerLimit, double upperLimit);
+        double getSetpoint();
+        double getKp();
+        double getKi();
+        double getKd();
+        double getSamplingPeriod();
+        PIDController::Algorithm getAlgorithm();
+        PIDController::DerivativeMode getDerivativeMode();
+        double getDerivativeFilter();
+        PIDController::AntiWindup getAntiWindup();
+        double getOutputIncrement();
+        const PIDState& getState();
+        void setState(const PIDState& snapshot);
+
+        void reset();
+        bool hasSettled();
+        double calc(double feedback);
+        double calc(double feedback, double samplingTime);
+        double track(double setpoint, double feedback, double samplingTime);
+
+    private:
+        PIDState state;
+
+        void init(double kp, double ki, double kd, double lowerInputLimit, double upperInputLimit, double lowerOutputLimit, double upperOutputLimit, double samplingPeriod);
+};
+
+static_assert(std::is_trivially_copyable<CompactPIDController>::value, "CompactPIDController must be memcpy-able");
+static_assert(sizeof(CompactPIDController) % 64 == 0, "CompactPIDController must fill whole cache lines");
+
+#endif  /* COMPACTPIDCONTROLLER_H */
@@ -0,0 +1,94 @@
+/* 
+ * File:   ControlScheduler.h
+ * Author: User
+ *
+ * Created on October 14, 2026
+ */
+
+#ifndef CONTROLSCHEDULER_H
+#define CONTROLSCHEDULER_H
+
+#include "PIDController.h"
+#include "PIDInstrumentation.h"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <vector>
+
+// Steps many PIDControllers at fixed rates on a pool of worker threads.
+//
+// Each controller is added with its rate, a feedback source that returns the
+// current process variable, and an actuator sink that receives the output.
+// Controllers are sharded across the workers so that every worker carries a
+// similar load, and each worker is pinned to its own core and owns its shard
+// exclusively. Ticks are driven by absolute deadlines on CLOCK_MONOTONIC, so
+// loops do not drift the way a relative sleep after each step does, and calc()
+// is given the interval between deadlines as its sampling time.
+//
+// Each worker steps copies of its shard's controllers, which it makes on its
+// own core in cache-line-aligned storage, so that a shard's state stays local
+// to its core and controllers stepped on different cores never share a line.
+// stop() writes the copies back to the added controllers, so these must not
+// be used while the scheduler runs; change their parameters through an
+// attached PIDParameterChannel instead, which the copies share. A source and
+// a sink are only ever called from one worker thread.
+//
+// A worker whose clock_nanosleep() fails stops, and getError() returns the
+// error.
+class ControlScheduler {
+    public:
+        typedef std::function<double()> FeedbackSource;
+        typedef std::function<void(double)> ActuatorSink;
+        
+        ControlScheduler();
+        ControlScheduler(unsigned workers);
+        virtual ~ControlScheduler();
+        
+        size_t add(PIDController* controller, double rate, FeedbackSource source, ActuatorSink sink);
+        size_t add(PIDController* controller, double rate, FeedbackSource source, ActuatorSink sink, PIDInstrumentation* instrumentation);
+        void setCores(const std::vector<int>& cores);
+        unsigned getWorkers();
+        int getError();
+        
+        bool start();
+        void stop();
+        bool isRunning();
+        
+    private:
+        struct Task {
+            PIDController* controller;
+            long long period;
+            FeedbackSource source;
+            ActuatorSink sink;
+            PIDInstrumentation* instrumentation;
+        };
+        
+        struct Shard {
+            std::vector<Task> tasks;
+            double load;
+            int core;
+            std::thread thread;
+        };
+        
+        // A worker's copy of a controller, on cache lines of its own.
+        struct alignas(64) LocalController {
+            PIDController controller;
+            
+            LocalController(const PIDController& controller) : controller(controller) {}
+        };
+        
+        std::vector<Shard> shards;
+        std::vector<int> cores;
+        std::atomic<bool> running;
+        std::atomic<int> error;
+        size_t taskCount;
+        
+        void run(Shard* shard);
+        
+        ControlScheduler(const ControlScheduler&);
+        ControlScheduler& operator=(const ControlScheduler&);
+};
+
+#endif  /* CONTROLSCHEDULER_H */
+
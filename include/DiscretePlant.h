@@ -0,0 +1,429 @@
+/* 
+ * File:   DiscretePlant.h
+ * Author: User
+ *
+ * Created on October 14, 2026
+ */
+
+#ifndef DISCRETEPLANT_H
+#define DISCRETEPLANT_H
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// Discrete-time plant models for simulating closed loops faster than real
+// time. A plant is any copyable type with
+//
+//     double step(double input);   // apply input for one sample, return output
+//     void reset();                // back to rest
+//
+// where step() holds the input for one sample and returns the output at the
+// end of it, which is what the controller sees at its next calc(). All state
+// is fixed-size and inline, so plants can be copied per thread or per
+// candidate and stepped millions of times per second.
+namespace pid {
+
+namespace detail {
+
+// result = x * y for N x N matrices.
+template <size_t N>
+inline void matrixMultiply(const double (&x)[N][N], const double (&y)[N][N], double (&result)[N][N]) {
+    for(size_t i = 0; i < N; i++) {
+        for(size_t j = 0; j < N; j++) {
+            double sum = 0;
+            for(size_t k = 0; k < N; k++) {
+                sum += x[i][k] * y[k][j];
+            }
+            result[i][j] = sum;
+        }
+    }
+}
+
+// result = exp(m) by scaling and squaring: m is scaled by 2^-s until its
+// norm is below 1/2, where an 18 term Taylor series is accurate to double
+// precision, and the result is squared s times. A matrix with an infinite or
+// NaN element, which would never scale below 1/2, gives a NaN result.
+template <size_t N>
+inline void matrixExponential(const double (&m)[N][N], double (&result)[N][N]) {
+    double norm = 0;
+    for(size_t i = 0; i < N; i++) {
+        double row = 0;
+        for(size_t j = 0; j < N; j++) {
+            row += std::fabs(m[i][j]);
+        }
+        // Unlike std::fmax, this keeps a NaN row.
+        norm = row > norm || std::isnan(row) ? row : norm;
+    }
+    if(!std::isfinite(norm)) {
+        for(size_t i = 0; i < N; i++) {
+            for(size_t j = 0; j < N; j++) {
+                result[i][j] = NAN;
+            }
+        }
+        return;
+    }
+    int squarings = 0;
+    double scale = 1;
+    while(norm * scale > 0.5) {
+        scale *= 0.5;
+        squarings++;
+    }
+    
+    double term[N][N], product[N][N];
+    for(size_t i = 0; i < N; i++) {
+        for(size_t j = 0; j < N; j++) {
+            term[i][j] = (i == j) ? 1 : 0;
+            result[i][j] = term[i][j];
+        }
+    }
+    double scaled[N][N];
+    for(size_t i = 0; i < N; i++) {
+        for(size_t j = 0; j < N; j++) {
+            scaled[i][j] = m[i][j] * scale;
+        }
+    }
+    for(int k = 1; k <= 18; k++) {
+        matrixMultiply(term, scaled, product);
+        for(size_t i = 0; i < N; i++) {
+            for(size_t j = 0; j < N; j++) {
+                term[i][j] = product[i][j] / k;
+                result[i][j] += term[i][j];
+            }
+        }
+    }
+    for(int k = 0; k < squarings; k++) {
+        matrixMultiply(result, result, product);
+        for(size_t i = 0; i < N; i++) {
+            for(size_t j = 0; j < N; j++) {
+                result[i][j] = product[i][j];
+            }
+        }
+    }
+}
+
+} // namespace detail
+
+//------------------------------------------------------------------------------
+// DiscreteTransferFunction
+//------------------------------------------------------------------------------
+//
+// Strictly proper SISO plant given by its z-domain transfer function
+//
+//            b[0] z^-1 + b[1] z^-2 + ... + b[Order-1] z^-Order
+//     G(z) = -------------------------------------------------
+//            1 + a[0] z^-1 + a[1] z^-2 + ... + a[Order-1] z^-Order
+//
+// evaluated as a difference equation with fixed-size, inline state. step(u)
+// applies u[k] and returns y[k+1], so the output never depends on an input
+// that has not been held for a full sample, as with any zero-order hold.
+//------------------------------------------------------------------------------
+
+template <size_t Order>
+class DiscreteTransferFunction {
+    public:
+        DiscreteTransferFunction() {
+            for(size_t i = 0; i < Order; i++) {
+                a[i] = 0;
+                b[i] = 0;
+            }
+            reset();
+        }
+        
+        DiscreteTransferFunction(const double (&numerator)[Order], const double (&denominator)[Order]) {
+            for(size_t i = 0; i < Order; i++) {
+                b[i] = numerator[i];
+                a[i] = denominator[i];
+            }
+            reset();
+        }
+        
+        void reset() {
+            for(size_t i = 0; i < Order; i++) {
+                inputs[i] = 0;
+                outputs[i] = 0;
+            }
+        }
+        
+        double step(double input) {
+            for(size_t i = Order - 1; i > 0; i--) {
+                inputs[i] = inputs[i - 1];
+            }
+            inputs[0] = input;
+            
+            double output = 0;
+            for(size_t i = 0; i < Order; i++) {
+                output += b[i] * inputs[i] - a[i] * outputs[i];
+            }
+            
+            for(size_t i = Order - 1; i > 0; i--) {
+                outputs[i] = outputs[i - 1];
+            }
+            outputs[0] = output;
+            return output;
+        }
+        
+    private:
+        double a[Order];
+        double b[Order];
+        double inputs[Order];   // u[k], u[k-1], ...
+        double outputs[Order];  // y[k], y[k-1], ...
+};
+
+//------------------------------------------------------------------------------
+// twoPolePlant
+//------------------------------------------------------------------------------
+//
+// Return Value : DiscreteTransferFunction<2>
+// Parameters   : gain, a, b, samplingTime
+//
+// This function returns the zero-order-hold discretization of
+// gain/((s+a)(s+b)), the plant of the example, for distinct poles -a and -b.
+//------------------------------------------------------------------------------
+
+inline DiscreteTransferFunction<2> twoPolePlant(double gain, double a, double b, double samplingTime) {
+    double pa = std::exp(-a * samplingTime);
+    double pb = std::exp(-b * samplingTime);
+    double ca = gain * (1 - pa) / (a * (b - a));
+    double cb = gain * (1 - pb) / (b * (b - a));
+    
+    double numerator[2] = { ca - cb, cb * pa - ca * pb };
+    double denominator[2] = { -(pa + pb), pa * pb };
+    return DiscreteTransferFunction<2>(numerator, denominator);
+}
+
+//------------------------------------------------------------------------------
+// StateSpacePlant
+//------------------------------------------------------------------------------
+//
+// SISO plant of N states in discrete state-space form
+//
+//     x[k+1] = A x[k] + B u[k]
+//     y[k+1] = C x[k+1]
+//
+// step(u) applies u[k] and returns y[k+1]. Use zeroOrderHold() to build one
+// from a continuous-time model.
+//------------------------------------------------------------------------------
+
+template <size_t N>
+class StateSpacePlant {
+    public:
+        StateSpacePlant() {
+            for(size_t i = 0; i < N; i++) {
+                for(size_t j = 0; j < N; j++) {
+                    A[i][j] = 0;
+                }
+                B[i] = 0;
+                C[i] = 0;
+            }
+            reset();
+        }
+        
+        StateSpacePlant(const double (&A)[N][N], const double (&B)[N], const double (&C)[N]) {
+            for(size_t i = 0; i < N; i++) {
+                for(size_t j = 0; j < N; j++) {
+                    this->A[i][j] = A[i][j];
+                }
+                this->B[i] = B[i];
+                this->C[i] = C[i];
+            }
+            reset();
+        }
+        
+        void reset() {
+            for(size_t i = 0; i < N; i++) {
+                state[i] = 0;
+            }
+        }
+        
+        double step(double input) {
+            double next[N];
+            for(size_t i = 0; i < N; i++) {
+                double sum = B[i] * input;
+                for(size_t j = 0; j < N; j++) {
+                    sum += A[i][j] * state[j];
+                }
+                next[i] = sum;
+            }
+            
+            double output = 0;
+            for(size_t i = 0; i < N; i++) {
+                state[i] = next[i];
+                output += C[i] * next[i];
+            }
+            return output;
+        }
+        
+        const double* getState() const { return state; }
+        void setState(const double (&state)[N]) {
+            for(size_t i = 0; i < N; i++) {
+                this->state[i] = state[i];
+            }
+        }
+        
+    private:
+        double A[N][N];
+        double B[N];
+        double C[N];
+        double state[N];
+};
+
+//------------------------------------------------------------------------------
+// zeroOrderHold
+//------------------------------------------------------------------------------
+//
+// Return Value : StateSpacePlant<N>
+// Parameters   : A, B, C, samplingTime
+//
+// This function discretizes the continuous-time plant dx/dt = Ax + Bu,
+// y = Cx with the input held over each sample. Both exp(AT) and the input
+// matrix integral of exp(As)B over [0, T] come from one exponential of the
+// augmented matrix [A B; 0 0]T. An infinite or NaN element of A, B, or T gives
+// a plant whose matrices, and so outputs, are NaN.
+//------------------------------------------------------------------------------
+
+template <size_t N>
+StateSpacePlant<N> zeroOrderHold(const double (&A)[N][N], const double (&B)[N], const double (&C)[N], double samplingTime) {
+    double augmented[N + 1][N + 1];
+    for(size_t i = 0; i <= N; i++) {
+        for(size_t j = 0; j <= N; j++) {
+            if(i == N) {
+                augmented[i][j] = 0;
+            }
+            else if(j == N) {
+                augmented[i][j] = B[i] * samplingTime;
+            }
+            else {
+                augmented[i][j] = A[i][j] * samplingTime;
+            }
+        }
+    }
+    
+    double exponential[N + 1][N + 1];
+    detail::matrixExponential(augmented, exponential);
+    
+    double discreteA[N][N];
+    double discreteB[N];
+    for(size_t i = 0; i < N; i++) {
+        for(size_t j = 0; j < N; j++) {
+            discreteA[i][j] = exponential[i][j];
+        }
+        discreteB[i] = exponential[i][N];
+    }
+    return StateSpacePlant<N>(discreteA, discreteB, C);
+}
+
+//------------------------------------------------------------------------------
+// BiquadCascade
+//------------------------------------------------------------------------------
+//
+// Plant made of Sections second-order sections in series, each
+//
+//            b0 + b1 z^-1 + b2 z^-2
+//     H(z) = ----------------------
+//            1 + a1 z^-1 + a2 z^-2
+//
+// evaluated in transposed direct form II, which keeps high-order plants
+// numerically well behaved where a single long difference equation is not.
+// step(u[k]) returns the cascade's response to u[k], feedthrough included, so
+// a strictly proper plant G(z) is entered with one z^-1 factored out, as
+// z G(z): step() then returns y[k+1], as the plant concept expects.
+//------------------------------------------------------------------------------
+
+struct Biquad {
+    double b0, b1, b2;
+    double a1, a2;
+};
+
+template <size_t Sections>
+class BiquadCascade {
+    public:
+        BiquadCascade() {
+            Biquad passThrough = { 1, 0, 0, 0, 0 };
+            for(size_t i = 0; i < Sections; i++) {
+                sections[i] = passThrough;
+            }
+            reset();
+        }
+        
+        explicit BiquadCascade(const Biquad (&sections)[Sections]) {
+            for(size_t i = 0; i < Sections; i++) {
+                this->sections[i] = sections[i];
+            }
+            reset();
+        }
+        
+        void reset() {
+            for(size_t i = 0; i < Sections; i++) {
+                s1[i] = 0;
+                s2[i] = 0;
+            }
+        }
+        
+        double step(double input) {
+            double value = input;
+            for(size_t i = 0; i < Sections; i++) {
+                const Biquad& q = sections[i];
+                double output = q.b0 * value + s1[i];
+                s1[i] = q.b1 * value - q.a1 * output + s2[i];
+                s2[i] = q.b2 * value - q.a2 * output;
+                value = output;
+            }
+            return value;
+        }
+        
+    private:
+        Biquad sections[Sections];
+        double s1[Sections];
+        double s2[Sections];
+};
+
+//------------------------------------------------------------------------------
+// PlantBatch
+//------------------------------------------------------------------------------
+//
+// Many independent plants stepped together, one input and one output per
+// plant, for closing many loops at once against a PIDBank:
+//
+//     bank.calcAll(pv, cv, n, T);
+//     plants.stepAll(cv, pv, n);
+//
+// The plants are stored contiguously, so stepping them streams through
+// memory once per sample.
+//------------------------------------------------------------------------------
+
+template <class Plant>
+class PlantBatch {
+    public:
+        PlantBatch() {}
+        PlantBatch(size_t count, const Plant& plant) : plants(count, plant) {}
+        
+        size_t size() const { return plants.size(); }
+        void resize(size_t count, const Plant& plant) { plants.resize(count, plant); }
+        Plant& operator[](size_t index) { return plants[index]; }
+        const Plant& operator[](size_t index) const { return plants[index]; }
+        
+        void reset() {
+            for(size_t i = 0; i < plants.size(); i++) {
+                plants[i].reset();
+            }
+        }
+        
+        // Steps the first n plants (at most size()).
+        void stepAll(const double* input, double* output, size_t n) {
+            if(n > plants.size()) {
+                n = plants.size();
+            }
+            for(size_t i = 0; i < n; i++) {
+                output[i] = plants[i].step(input[i]);
+            }
+        }
+        
+    private:
+        std::vector<Plant> plants;
+};
+
+} // namespace pid
+
+#endif  /* DISCRETEPLANT_H */
+
@@ -0,0 +1,156 @@
+/* 
+ * File:   FixedPoint.h
+ * Author: User
+ *
+ * Created on October 14, 2026
+ */
+
+#ifndef FIXEDPOINT_H
+#define FIXEDPOINT_H
+
+#include <cstdint>
+#include <limits>
+
+// Saturating Q-format fixed-point numbers for running pid::PIDController on
+// processors without an FPU, e.g.
+//
+//     pid::PIDController<pid::Q31, pid::OutputLimits, pid::FixedTimestep> loop;
+//
+// The controller uses one scalar type for everything: gains, limits,
+// setpoint, measurement, sampling period, and the integrator. Q15 and Q31
+// only hold [-1, 1), so all of them must be scaled into that range, and a
+// gain such as kp = 11.5 saturates silently to just below 1 on conversion.
+// Either scale the loop, dividing the gains and the output limits by a
+// power of two G at least as large as the largest gain and multiplying the
+// output by G outside the controller, or use Q16_16, which holds gains and
+// unnormalized signals up to 32768 at a coarser resolution:
+//
+//     pid::PIDController<pid::Q16_16, pid::OutputLimits, pid::FixedTimestep>
+//         loop(pid::Q16_16(11.5), pid::Q16_16(2.0), pid::Q16_16(0.05));
+//     loop.setOutputLimits(pid::Q16_16(-100), pid::Q16_16(100));
+//     loop.setSamplingPeriod(pid::Q16_16(0.001));
+//
+// A Fixed<FracBits, Storage, Wide> holds value * 2^FracBits in Storage and does
+// every operation in the wider integer type Wide. Results outside the
+// representable range saturate to the nearest bound instead of wrapping, and
+// multiplications and divisions round to nearest. Division by zero saturates
+// towards the sign of the dividend. Every operation is constexpr, so gains can
+// be compile-time constants, as pid::StaticPIDController needs.
+//
+// Tolerance: while no intermediate value saturates, calc() with a Fixed scalar
+// matches the double controller fed the same quantized gains, limits, and
+// inputs to within (1.5 + |kd|/2 + |ki|*N/2) LSB after N steps, where one LSB
+// is 2^-FracBits. The N/2 part is the rounding of error*samplingTime that the
+// integrator accumulates. Once a value saturates, it stays pinned to the edge
+// of the range and the integrator clamp to the output limits still applies.
+namespace pid {
+
+template <int FracBits, class Storage, class Wide>
+class Fixed {
+    public:
+        typedef Storage storage_type;
+        static constexpr int fractionalBits = FracBits;
+        
+        static_assert(FracBits > 0 && FracBits < static_cast<int>(sizeof(Storage)*8),
+                      "FracBits must leave room for the sign bit");
+        static_assert(sizeof(Wide) >= 2*sizeof(Storage), "Wide must hold the product of two Storage values");
+        
+        constexpr Fixed() : raw(0) {}
+        constexpr Fixed(double value) : raw(saturate(round(value*scale()))) {}
+        
+        static constexpr Fixed fromRaw(Storage raw) { return Fixed(raw, RawTag()); }
+        static constexpr Fixed max() { return fromRaw(std::numeric_limits<Storage>::max()); }
+        static constexpr Fixed lowest() { return fromRaw(std::numeric_limits<Storage>::min()); }
+        static constexpr Fixed epsilon() { return fromRaw(1); }
+        
+        constexpr Storage toRaw() const { return raw; }
+        constexpr double toDouble() const { return raw/scale(); }
+        constexpr explicit operator double() const { return toDouble(); }
+        
+        constexpr Fixed operator+(Fixed other) const { return fromRaw(saturate(Wide(raw) + other.raw)); }
+        constexpr Fixed operator-(Fixed other) const { return fromRaw(saturate(Wide(raw) - other.raw)); }
+        constexpr Fixed operator-() const { return fromRaw(saturate(-Wide(raw))); }
+        
+        constexpr Fixed operator*(Fixed other) const {
+            Wide product = Wide(raw)*other.raw;
+            return fromRaw(saturate(roundingShift(product)));
+        }
+        
+        constexpr Fixed operator/(Fixed other) const {
+            if(other.raw == 0) {
+                return raw < 0 ? lowest() : max();
+            }
+            // Dividing by the smallest negative step is an exact negation
+            // and scaling, done here because numerator/-1 can overflow Wide
+            // (for Q31, lowest()/fromRaw(-1) is -2^63/-1).
+            if(other.raw == -1) {
+                return fromRaw(saturate(-(Wide(raw)*(Wide(1) << FracBits))));
+            }
+            // Doubling the scale keeps one extra bit for rounding to nearest.
+            // Wide holds twice the bits of Storage, so this cannot overflow.
+            Wide numerator = Wide(raw)*(Wide(1) << (FracBits + 1));
+            Wide quotient = numerator/other.raw;
+            return fromRaw(saturate(quotient >= 0 ? (quotient + 1)/2 : (quotient - 1)/2));
+        }
+        
+        constexpr Fixed& operator+=(Fixed other) { return *this = *this + other; }
+        constexpr Fixed& operator-=(Fixed other) { return *this = *this - other; }
+        Fixed& operator*=(Fixed other) { return *this = *this*other; }
+        Fixed& operator/=(Fixed other) { return *this = *this/other; }
+        
+        constexpr bool operator==(Fixed other) const { return raw == other.raw; }
+        constexpr bool operator!=(Fixed other) const { return raw != other.raw; }
+        constexpr bool operator<(Fixed other) const { return raw < other.raw; }
+        constexpr bool operator>(Fixed other) const { return raw > other.raw; }
+        constexpr bool operator<=(Fixed other) const { return raw <= other.raw; }
+        constexpr bool operator>=(Fixed other) const { return raw >= other.raw; }
+        
+    private:
+        struct RawTag {};
+        constexpr Fixed(Storage raw, RawTag) : raw(raw) {}
+        
+        Storage raw;
+        
+        static constexpr double scale() { return double(Wide(1) << FracBits); }
+        
+        static constexpr Storage saturate(Wide value) {
+            if(value > Wide(std::numeric_limits<Storage>::max())) {
+                return std::numeric_limits<Storage>::max();
+            }
+            else if(value < Wide(std::numeric_limits<Storage>::min())) {
+                return std::numeric_limits<Storage>::min();
+            }
+            else
+                return Storage(value);
+        }
+        
+        static constexpr Wide round(double value) {
+            // Out-of-range doubles (and NaN) must not reach the integer
+            // conversion, which would be undefined.
+            const double bound = double(std::numeric_limits<Storage>::max()) + 1.0;
+            if(!(value < bound)) {
+                return Wide(std::numeric_limits<Storage>::max());
+            }
+            else if(!(value >= -bound)) {
+                return Wide(std::numeric_limits<Storage>::min());
+            }
+            return Wide(value < 0 ? value - 0.5 : value + 0.5);
+        }
+        
+        static constexpr Wide roundingShift(Wide value) {
+            Wide half = Wide(1) << (FracBits - 1);
+            return value >= 0 ? (value + half) >> FracBits : -((-value + half) >> FracBits);
+        }
+};
+
+// Q0.15: range [-1, 1), resolution 3.1e-5.
+typedef Fixed<15, int16_t, int32_t> Q15;
+// Q0.31: range [-1, 1), resolution 4.7e-10.
+typedef Fixed<31, int32_t, int64_t> Q31;
+// Q15.16: range [-32768, 32768), resolution 1.5e-5, for unnormalized signals.
+typedef Fixed<16, int32_t, int64_t> Q16_16;
+
+} // namespace pid
+
+#endif  /* FIXEDPOINT_H */
+
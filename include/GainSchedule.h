@@ -0,0 +1,115 @@
+/* 
+ * File:   GainSchedule.h
+ * Author: User
+ *
+ * Created on October 14, 2026
+ */
+
+#ifndef GAINSCHEDULE_H
+#define GAINSCHEDULE_H
+
+#include <cstddef>
+#include <vector>
+
+// One row of a gain schedule: the gains to use at one value of the
+// scheduling variable.
+struct GainSchedulePoint {
+    double variable;
+    double kp, ki, kd;
+};
+
+// Table of PID gains over a scheduling variable (an operating point such as
+// flow, speed, or the process variable itself), interpolated linearly between
+// rows and held constant beyond the first and last rows.
+//
+// Evenly spaced rows are looked up in O(1) by computing the interval index;
+// otherwise a branch-free binary search over the breakpoints finds it in
+// log2(rows) steps. The breakpoints and the gains are stored in two packed
+// arrays, so a lookup touches a few cache lines at most.
+class GainSchedule {
+    public:
+        GainSchedule();
+        virtual ~GainSchedule();
+        
+        bool setPoints(const GainSchedulePoint* points, size_t count);
+        size_t size() const;
+        bool isUniform() const;
+        
+        inline void lookup(double variable, double& kp, double& ki, double& kd) const;
+        
+    private:
+        std::vector<double> breakpoints;
+        std::vector<double> gains;      // kp, ki, kd per row
+        bool uniform;
+        double first;
+        double inverseStep;
+};
+
+//------------------------------------------------------------------------------
+// lookup
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : variable, kp, ki, kd
+//
+// This function interpolates the gains at 'variable' into kp, ki and kd. An
+// empty schedule leaves them untouched; a NaN variable gets the first row.
+//------------------------------------------------------------------------------
+
+inline void GainSchedule::lookup(double variable, double& kp, double& ki, double& kd) const {
+    size_t count = breakpoints.size();
+    if(count < 2) {
+        if(count == 1) {
+            kp = gains[0];
+            ki = gains[1];
+            kd = gains[2];
+        }
+        return;
+    }
+    
+    size_t index;
+    double fraction;
+    if(uniform) {
+        double position = (variable - first) * inverseStep;
+        if(!(position > 0)) {
+            position = 0;
+        }
+        if(position > (double)(count - 1)) {
+            position = (double)(count - 1);
+        }
+        index = (size_t)position;
+        if(index > count - 2) {
+            index = count - 2;
+        }
+        fraction = position - (double)index;
+    }
+    else {
+        // Last breakpoint <= variable, or the first one
+        const double* base = &breakpoints[0];
+        size_t length = count;
+        while(length > 1) {
+            size_t half = length / 2;
+            base = (base[half] <= variable) ? base + half : base;
+            length -= half;
+        }
+        index = base - &breakpoints[0];
+        if(index > count - 2) {
+            index = count - 2;
+        }
+        fraction = (variable - breakpoints[index]) / (breakpoints[index + 1] - breakpoints[index]);
+        if(!(fraction > 0)) {
+            fraction = 0;
+        }
+        if(fraction > 1) {
+            fraction = 1;
+        }
+    }
+    
+    const double* row = &gains[3 * index];
+    kp = row[0] + fraction * (row[3] - row[0]);
+    ki = row[1] + fraction * (row[4] - row[1]);
+    kd = row[2] + fraction * (row[5] - row[2]);
+}
+
+#endif  /* GAINSCHEDULE_H */
+
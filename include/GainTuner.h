@@ -0,0 +1,258 @@
+/* 
+ * File:   GainTuner.h
+ * Author: User
+ *
+ * Created on October 14, 2026
+ */
+
+#ifndef GAINTUNER_H
+#define GAINTUNER_H
+
+#include "PIDController.h"
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+// Monte-Carlo search for PID gains against a discrete-time plant model.
+//
+// Every candidate drives a private copy of the plant through a closed-loop
+// step response with a PIDController in fixed sampling period mode, as fast
+// as the CPU allows and with no sleeps. Candidates are spread across threads.
+// Each response is scored on percent overshoot, settling time, IAE, and ITAE,
+// and tune() returns the candidates no other candidate beats on all four.
+//
+// Plant is any model with `double step(double input)` and `void reset()`, for
+// example the ones in DiscretePlant.h, sampled at the controller's rate.
+namespace pid {
+
+struct GainCandidate {
+    double kp, ki, kd;
+};
+
+// Range of gains to sample from. A range with a positive lower bound is
+// sampled log-uniformly, since useful gains often span several decades;
+// otherwise it is sampled uniformly.
+struct GainSearchSpace {
+    double kpMin, kpMax;
+    double kiMin, kiMax;
+    double kdMin, kdMax;
+};
+
+// Step response scores; lower is better for all of them. A response that
+// never enters the settling band, or that diverges, scores infinity there.
+struct StepMetrics {
+    double overshoot;       // percent of the step
+    double settlingTime;    // seconds until it stays within the band
+    double iae;             // integral of |error|
+    double itae;            // integral of t*|error|
+};
+
+struct TuningResult {
+    GainCandidate gains;
+    StepMetrics metrics;
+};
+
+template <class Plant>
+class GainTuner {
+    public:
+        GainTuner(const Plant& plant, double samplingTime, double duration)
+            : plant(plant), samplingTime(samplingTime), duration(duration),
+              setpoint(1), settlingBand(0.02), lowerOutputLimit(-1), upperOutputLimit(-1) {}
+        
+        void setSetpoint(double setpoint) { this->setpoint = setpoint; }
+        void setSettlingBand(double fraction) { settlingBand = fraction; }
+        void setOutputLimits(double lowerLimit, double upperLimit) {
+            lowerOutputLimit = lowerLimit;
+            upperOutputLimit = upperLimit;
+        }
+        
+        //----------------------------------------------------------------------
+        // evaluate
+        //----------------------------------------------------------------------
+        //
+        // Return Value : StepMetrics
+        // Parameters   : gains
+        //
+        // This function simulates the closed-loop step response from rest for
+        // 'duration' seconds and scores it. The metrics are accumulated while
+        // stepping, in constant memory.
+        //----------------------------------------------------------------------
+        
+        StepMetrics evaluate(const GainCandidate& gains) const {
+            Plant model(plant);
+            model.reset();
+            PIDController pid(gains.kp, gains.ki, gains.kd, samplingTime);
+            pid.setOutputLimits(lowerOutputLimit, upperOutputLimit);
+            pid.on();
+            pid.targetSetpoint(setpoint);
+            
+            const double infinity = std::numeric_limits<double>::infinity();
+            const double band = settlingBand * std::fabs(setpoint);
+            size_t steps = (size_t)(duration / samplingTime + 0.5);
+            double processVariable = 0;
+            double peak = 0;
+            double lastOutsideTime = 0;
+            bool outside = true;
+            StepMetrics metrics = { 0, 0, 0, 0 };
+            
+            for(size_t k = 1; k <= steps; k++) {
+                processVariable = model.step(pid.calc(processVariable));
+                double t = k * samplingTime;
+                double error = std::fabs(setpoint - processVariable);
+                if(!(error < infinity)) {
+                    StepMetrics diverged = { infinity, infinity, infinity, infinity };
+                    return diverged;
+                }
+                metrics.iae += error * samplingTime;
+                metrics.itae += t * error * samplingTime;
+                if((setpoint >= 0 ? processVariable : -processVariable) > peak) {
+                    peak = setpoint >= 0 ? processVariable : -processVariable;
+                }
+                outside = error > band;
+                if(outside) {
+                    lastOutsideTime = t;
+                }
+            }
+            
+            metrics.overshoot = setpoint != 0 ? std::fmax(0, (peak - std::fabs(setpoint)) / std::fabs(setpoint) * 100) : 0;
+            metrics.settlingTime = outside ? infinity : lastOutsideTime;
+            return metrics;
+        }
+        
+        //----------------------------------------------------------------------
+        // sample
+        //----------------------------------------------------------------------
+        //
+        // Return Value : std::vector<TuningResult>
+        // Parameters   : space, candidates, seed, threads
+        //
+        // This function draws 'candidates' gain sets from 'space' and evaluates
+        // all of them, spread over 'threads' threads (0 for one per hardware
+        // thread). Candidate i depends only on (seed, i), so results do not
+        // depend on the number of threads.
+        //----------------------------------------------------------------------
+        
+        std::vector<TuningResult> sample(const GainSearchSpace& space, size_t candidates, uint64_t seed, unsigned threads = 0) const {
+            std::vector<TuningResult> results(candidates);
+            if(threads == 0) {
+                threads = std::thread::hardware_concurrency();
+            }
+            if(threads == 0) {
+                threads = 1;
+            }
+            if(threads > candidates) {
+                threads = candidates > 0 ? (unsigned)candidates : 1;
+            }
+            
+            std::vector<std::thread> workers;
+            for(unsigned j = 0; j < threads; j++) {
+                size_t begin = candidates * j / threads;
+                size_t end = candidates * (j + 1) / threads;
+                workers.push_back(std::thread([this, &results, &space, seed, begin, end]() {
+                    for(size_t i = begin; i < end; i++) {
+                        // Hashing the index starts each candidate's stream at an
+                        // unrelated point, so neighbours' draws do not overlap.
+                        uint64_t state = splitmix64(seed ^ splitmix64(i));
+                        results[i].gains.kp = draw(space.kpMin, space.kpMax, state);
+                        results[i].gains.ki = draw(space.kiMin, space.kiMax, state);
+                        results[i].gains.kd = draw(space.kdMin, space.kdMax, state);
+                        results[i].metrics = evaluate(results[i].gains);
+                    }
+                }));
+            }
+            for(size_t j = 0; j < workers.size(); j++) {
+                workers[j].join();
+            }
+            return results;
+        }
+        
+        //----------------------------------------------------------------------
+        // tune
+        //----------------------------------------------------------------------
+        //
+        // Return Value : std::vector<TuningResult>
+        // Parameters   : space, candidates, seed, threads
+        //
+        // This function samples and evaluates candidates like sample() and
+        // returns their Pareto front.
+        //----------------------------------------------------------------------
+        
+        std::vector<TuningResult> tune(const GainSearchSpace& space, size_t candidates, uint64_t seed, unsigned threads = 0) const {
+            return paretoFront(sample(space, candidates, seed, threads));
+        }
+        
+        //----------------------------------------------------------------------
+        // paretoFront
+        //----------------------------------------------------------------------
+        //
+        // Return Value : std::vector<TuningResult>
+        // Parameters   : results
+        //
+        // This function keeps the results that are not dominated: no other
+        // result is at least as good on every metric and better on one.
+        // Results that diverged are dropped.
+        //----------------------------------------------------------------------
+        
+        static std::vector<TuningResult> paretoFront(const std::vector<TuningResult>& results) {
+            std::vector<TuningResult> front;
+            for(size_t i = 0; i < results.size(); i++) {
+                if(!(results[i].metrics.iae < std::numeric_limits<double>::infinity())) {
+                    continue;
+                }
+                bool dominated = false;
+                for(size_t j = 0; j < results.size() && !dominated; j++) {
+                    dominated = j != i && dominates(results[j].metrics, results[i].metrics);
+                }
+                if(!dominated) {
+                    front.push_back(results[i]);
+                }
+            }
+            return front;
+        }
+        
+    private:
+        Plant plant;
+        double samplingTime;
+        double duration;
+        double setpoint;
+        double settlingBand;
+        double lowerOutputLimit, upperOutputLimit;
+        
+        static bool dominates(const StepMetrics& a, const StepMetrics& b) {
+            bool noWorse = a.overshoot <= b.overshoot && a.settlingTime <= b.settlingTime
+                           && a.iae <= b.iae && a.itae <= b.itae;
+            bool better = a.overshoot < b.overshoot || a.settlingTime < b.settlingTime
+                          || a.iae < b.iae || a.itae < b.itae;
+            return noWorse && better;
+        }
+        
+        // splitmix64 output following 'state', which also hashes it well
+        static uint64_t splitmix64(uint64_t state) {
+            uint64_t z = state + 0x9E3779B97F4A7C15ULL;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+        
+        // splitmix64 step, mapped to [0, 1)
+        static double uniform(uint64_t& state) {
+            uint64_t z = splitmix64(state);
+            state += 0x9E3779B97F4A7C15ULL;
+            return (z >> 11) * (1.0 / 9007199254740992.0);
+        }
+        
+        static double draw(double lower, double upper, uint64_t& state) {
+            double u = uniform(state);
+            if(lower > 0 && upper > lower) {
+                return lower * std::pow(upper / lower, u);
+            }
+            return lower + (upper - lower) * u;
+        }
+};
+
+} // namespace pid
+
+#endif  /* GAINTUNER_H */
+
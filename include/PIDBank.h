@@ -0,0 +1,125 @@
+/* 
+ * File:   PIDBank.h
+ * Author: User
+ *
+ * Created on October 14, 2026
+ */
+
+#ifndef PIDBANK_H
+#define PIDBANK_H
+
+#include <cstddef>
+#include <vector>
+
+class RelayAutoTuner;
+
+// Kernel choice and modes of a bank, shared by the double and float banks so
+// that PIDBank::Isa and PIDBankFloat::Isa are the same type.
+struct PIDBankTypes {
+    enum Isa {
+        ISA_SCALAR,
+        ISA_AVX2,
+        ISA_AVX512,
+        ISA_NEON
+    };
+    
+    // Same forms as PIDController::Algorithm, chosen for the whole bank.
+    enum Algorithm {
+        POSITIONAL,
+        VELOCITY
+    };
+    
+    // Same modes as PIDController::AntiWindup, chosen for the whole bank.
+    enum AntiWindup {
+        OUTPUT_CLAMP,
+        CONDITIONAL_INTEGRATION,
+        BACK_CALCULATION,
+        INTEGRATOR_CLAMP
+    };
+    
+    static Isa bestIsa();
+};
+
+// A bank of independent PID loops stored as a structure of arrays. Each lane
+// behaves like a PIDController driven through calc(processVariable,
+// samplingTime), but the state of every lane lives in contiguous arrays so
+// that calcAll() can step thousands of loops in a single cache-friendly pass.
+//
+// calcAll() runs a vector kernel chosen at run time for the host CPU (AVX-512F,
+// AVX2 or NEON) or a scalar fallback. All kernels produce bit-identical results.
+//
+// Scalar is double (PIDBank) or float (PIDBankFloat, in PIDBankFloat.h); the
+// members are compiled in PIDBank.cpp for those two. The running sums, the
+// integrator and the velocity form's output, can be accumulated with Kahan
+// (compensated) summation; that is on by default for float lanes only, so
+// that double lanes keep matching PIDController bit for bit.
+template <class Scalar>
+class PIDBankOf : public PIDBankTypes {
+    public:
+        PIDBankOf();
+        PIDBankOf(size_t size);
+        virtual ~PIDBankOf();
+        
+        size_t size();
+        void resize(size_t size);
+        bool setIsa(Isa isa);
+        Isa getIsa();
+        void setAlgorithm(Algorithm algorithm);
+        Algorithm getAlgorithm();
+        void setAntiWindup(AntiWindup antiWindup);
+        AntiWindup getAntiWindup();
+        void setCompensatedSummation(bool compensated);
+        bool getCompensatedSummation();
+        
+        void targetSetpoint(size_t lane, Scalar setpoint);
+        void setGains(size_t lane, Scalar kp, Scalar ki, Scalar kd);
+        void off(size_t lane);
+        void on(size_t lane);
+        void setInputLimits(size_t lane, Scalar lowerLimit, Scalar upperLimit);
+        void setOutputLimits(size_t lane, Scalar lowerLimit, Scalar upperLimit);
+        void setIntegratorLimits(size_t lane, Scalar lowerLimit, Scalar upperLimit);
+        void setTrackingGain(size_t lane, Scalar trackingGain);
+        void autoTune(size_t lane, RelayAutoTuner* tuner);
+        Scalar getSetpoint(size_t lane);
+        Scalar getKp(size_t lane);
+        Scalar getKi(size_t lane);
+        Scalar getKd(size_t lane);
+        
+        void reset(size_t lane);
+        bool hasSettled(size_t lane);
+        void calcAll(const Scalar* processVariable, Scalar* controlVariable, size_t n, Scalar samplingTime);
+        
+    private:
+        Isa isa;
+        Algorithm algorithm;
+        AntiWindup antiWindup;
+        bool compensated;
+        std::vector<unsigned char> isEnabled;
+        std::vector<unsigned char> setpointReached;
+        std::vector<Scalar> setpoint;
+        std::vector<Scalar> lastSetpoint;
+        std::vector<Scalar> lastControlVariable;
+        std::vector<Scalar> lastProcessVariable;
+        std::vector<Scalar> lastError;
+        std::vector<Scalar> lastDifferentiator;
+        std::vector<Scalar> kp, ki, kd;
+        std::vector<Scalar> lowerInputLimit, upperInputLimit;
+        std::vector<Scalar> lowerOutputLimit, upperOutputLimit;
+        std::vector<Scalar> lowerIntegratorLimit, upperIntegratorLimit;
+        std::vector<Scalar> trackingGain;
+        std::vector<Scalar> integrator;
+        std::vector<Scalar> compensation;
+        std::vector<size_t> tuningLanes;
+        std::vector<RelayAutoTuner*> tuners;
+        
+        void init();
+        void stepAutoTuners(const Scalar* processVariable, Scalar* controlVariable, size_t n, Scalar samplingTime);
+};
+
+extern template class PIDBankOf<double>;
+extern template class PIDBankOf<float>;
+
+typedef PIDBankOf<double> PIDBank;
+
+#endif  /* PIDBANK_H */
+
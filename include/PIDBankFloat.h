@@ -0,0 +1,28 @@
+/* 
+ * File:   PIDBankFloat.h
+ * Author: User
+ *
+ * Created on October 14, 2026
+ */
+
+#ifndef PIDBANKFLOAT_H
+#define PIDBANKFLOAT_H
+
+#include "PIDBank.h"
+
+// A PIDBank in single precision. Very large banks are limited by memory
+// bandwidth rather than arithmetic, and float lanes halve the state that
+// calcAll() streams through while doubling the lanes per vector (8 with AVX2,
+// 16 with AVX-512F, 4 with NEON). All kernels produce bit-identical results.
+//
+// A float holds about 7 significant digits, so a long-running integrator
+// eventually stops absorbing small error * samplingTime increments. The
+// integrator, and the output of the velocity form, are therefore accumulated
+// with Kahan (compensated) summation by default, which keeps the error of the
+// running sum at the rounding of a single addition however long the bank
+// runs. The results still differ from a double PIDController by float
+// rounding everywhere else; pid-bench reports the deviation over a long
+// closed-loop run (BM_BankFloatAccuracy).
+typedef PIDBankOf<float> PIDBankFloat;
+
+#endif  /* PIDBANKFLOAT_H */
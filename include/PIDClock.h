@@ -0,0 +1,149 @@
+/* 
+ * File:   PIDClock.h
+ * Author: User
+ *
+ * Created on October 14, 2026
+ */
+
+#ifndef PIDCLOCK_H
+#define PIDCLOCK_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <mutex>
+#include <x86intrin.h>
+#define PID_HAVE_TSC_CLOCK
+#endif
+
+// Clocks for measuring the sampling time of a PID loop. Every clock here
+// follows the std::chrono clock interface, so it can be used directly as
+// pid::MeasuredTimestep<Clock>, or turned into a PIDController::ClockFunction
+// with pid::clockSeconds<Clock>. pid::TscClock only exists on x86, where
+// PID_HAVE_TSC_CLOCK is defined.
+namespace pid {
+
+//------------------------------------------------------------------------------
+// clockSeconds
+//------------------------------------------------------------------------------
+//
+// Return Value : double
+// Parameters   : None
+//
+// This function reads 'Clock' and returns its time in seconds since the clock's
+// epoch.
+//------------------------------------------------------------------------------
+
+template <class Clock>
+double clockSeconds() {
+    return std::chrono::duration<double>(Clock::now().time_since_epoch()).count();
+}
+
+#if defined(PID_HAVE_TSC_CLOCK)
+
+//------------------------------------------------------------------------------
+// TscClock
+//------------------------------------------------------------------------------
+//
+// Steady clock read straight from the x86 time-stamp counter. Reading it takes
+// a few nanoseconds and never enters the kernel. The tick rate is measured
+// against std::chrono::steady_clock for 10 ms, which assumes an invariant TSC.
+//
+// The rate is measured once per process, during static initialization of a
+// program that uses now(), so that now() itself never waits and can be called
+// from any number of threads. Code that reads the clock from its own static
+// initializers should call calibrate() first; calling it again is harmless.
+// It is a template only so that programs that never use it skip the
+// calibration; use it as TscClock.
+//------------------------------------------------------------------------------
+
+template <class = void>
+struct BasicTscClock {
+    typedef std::chrono::nanoseconds duration;
+    typedef duration::rep rep;
+    typedef duration::period period;
+    typedef std::chrono::time_point<BasicTscClock> time_point;
+    static constexpr bool is_steady = true;
+    
+    static uint64_t ticks() {
+        return __rdtsc();
+    }
+    
+    static double calibrate() {
+        std::call_once(calibrationFlag, [] {
+            tickPeriod.store(measureTickPeriod(), std::memory_order_release);
+        });
+        return tickPeriod.load(std::memory_order_acquire);
+    }
+    
+    static double nanosecondsPerTick() {
+        return tickPeriod.load(std::memory_order_acquire);
+    }
+    
+    static time_point now() {
+        // Naming the startup calibration is what makes the program run it.
+        (void)&startupCalibration;
+        double nanoseconds = tickPeriod.load(std::memory_order_relaxed);
+        return time_point(duration(static_cast<rep>(ticks()*nanoseconds)));
+    }
+    
+    private:
+        static double measureTickPeriod() {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            uint64_t startTicks = ticks();
+            std::chrono::steady_clock::time_point end = start + std::chrono::milliseconds(10);
+            std::chrono::steady_clock::time_point stop;
+            do {
+                stop = std::chrono::steady_clock::now();
+            } while(stop < end);
+            uint64_t stopTicks = ticks();
+            return std::chrono::duration<double, std::nano>(stop - start).count()/(stopTicks - startTicks);
+        }
+        
+        static inline std::once_flag calibrationFlag;
+        static inline std::atomic<double> tickPeriod{0};
+        // Like every member of a template, only instantiated, and so only
+        // run at startup, when it is used.
+        static inline const double startupCalibration = calibrate();
+};
+
+typedef BasicTscClock<> TscClock;
+
+#endif  /* PID_HAVE_TSC_CLOCK */
+
+//------------------------------------------------------------------------------
+// SimulatedClock
+//------------------------------------------------------------------------------
+//
+// Clock that only moves when told to, for simulations and tests that run
+// faster than real time. The time is shared by every user of the clock.
+//------------------------------------------------------------------------------
+
+struct SimulatedClock {
+    typedef std::chrono::nanoseconds duration;
+    typedef duration::rep rep;
+    typedef duration::period period;
+    typedef std::chrono::time_point<SimulatedClock> time_point;
+    static constexpr bool is_steady = true;
+    
+    static time_point now() {
+        return time_point(duration(currentTime.load(std::memory_order_relaxed)));
+    }
+    
+    static void advance(duration step) {
+        currentTime.fetch_add(step.count(), std::memory_order_relaxed);
+    }
+    
+    static void set(time_point time) {
+        currentTime.store(time.time_since_epoch().count(), std::memory_order_relaxed);
+    }
+    
+    static inline std::atomic<rep> currentTime{0};
+};
+
+} // namespace pid
+
+#endif  /* PIDCLOCK_H */
+
@@ -8,18 +8,119 @@
 #ifndef PIDCONTROLLER_H
 #define PIDCONTROLLER_H
 
-#include <boost/timer/timer.hpp>
-#include <boost/chrono.hpp>
 #include <iostream>
 #include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+class PIDParameterChannel;
+class PIDInstrumentation;
+class StepResponseAnalyzer;
+class GainSchedule;
+class RelayAutoTuner;
+
+// Everything one calc() computed. The terms are the contributions to the
+// output before output limiting, signed as they are summed:
+// output = limit(proportional + integral + derivative). In the velocity form
+// the integral term is what the accumulated output holds beyond the
+// proportional and derivative terms.
+struct PIDOutput {
+    double setpoint;
+    double processVariable;
+    double error;
+    double proportional;
+    double integral;
+    double derivative;
+    double output;
+    double samplingTime;
+};
+
+// Snapshot of a controller's configuration and internal state, for
+// checkpointing or handing a running loop over to a standby controller. It
+// is plain data, so it can be copied with memcpy or written out as is
+// between builds of the same layout. The clock, parameter channel, and
+// instrumentation are not part of it.
+struct PIDState {
+    uint8_t isEnabled;
+    uint8_t setpointReached;
+    uint8_t algorithm;
+    uint8_t derivativeMode;
+    uint8_t antiWindup;
+    uint8_t reserved[3];
+    double setpoint;
+    double lastSetpoint;
+    double lastControlVariable;
+    double lastProcessVariable;
+    double lastError;
+    double lastDifferentiator;
+    double outputIncrement;
+    double integrator;
+    double kp, ki, kd;
+    double lowerInputLimit, upperInputLimit;
+    double lowerOutputLimit, upperOutputLimit;
+    double samplingPeriod;
+    double derivativeTimeConstant;
+    double trackingGain;
+    double lowerIntegratorLimit, upperIntegratorLimit;
+};
+
+static_assert(std::is_trivially_copyable<PIDState>::value, "PIDState must be memcpy-able");
 
 class PIDController {
     public:
+        // Returns a monotonic time in seconds. See PIDClock.h for ready-made
+        // clocks, e.g. &pid::clockSeconds<pid::TscClock>.
+        typedef double (*ClockFunction)();
+        
+        // POSITIONAL computes the whole output every sample from the error and
+        // an integrator. VELOCITY computes only the change of output from the
+        // last two errors and adds it to the previous output.
+        enum Algorithm {
+            POSITIONAL,
+            VELOCITY
+        };
+        
+        // DERIVATIVE_ON_SETPOINT differentiates the setpoint, as this
+        // controller always has. DERIVATIVE_ON_MEASUREMENT differentiates the
+        // process variable instead, which damps the response without kicking
+        // the output on setpoint changes.
+        enum DerivativeMode {
+            DERIVATIVE_ON_SETPOINT,
+            DERIVATIVE_ON_MEASUREMENT
+        };
+        
+        // How the positional form keeps its integrator from winding up while
+        // the output is limited. OUTPUT_CLAMP bounds the integrator by the
+        // output limits, as this controller always has. CONDITIONAL_INTEGRATION
+        // stops integrating while the output is limited and the error would
+        // drive it further. BACK_CALCULATION feeds the amount the output was
+        // limited by back into the integrator through a tracking gain.
+        // INTEGRATOR_CLAMP bounds the integral term by its own limits.
+        enum AntiWindup {
+            OUTPUT_CLAMP,
+            CONDITIONAL_INTEGRATION,
+            BACK_CALCULATION,
+            INTEGRATOR_CLAMP
+        };
+        
+        // The variable a gain schedule is looked up with: the process
+        // variable, the setpoint, or a value given with setSchedulingVariable().
+        enum ScheduleVariable {
+            SCHEDULE_ON_PROCESS_VARIABLE,
+            SCHEDULE_ON_SETPOINT,
+            SCHEDULE_ON_EXTERNAL
+        };
+        
         PIDController();
         PIDController(double kp, double ki, double kd);
+        PIDController(double kp, double ki, double kd, double samplingPeriod);
         PIDController(double kp, double ki, double kd, double lowerOutputLimit, double upperOutputLimit);
         PIDController(double newKp, double newKi, double newKd, double lowerInputLimit, double upperInputLimit, double lowerOutputLimit, double upperOutputLimit);
+        // Copies, by construction or assignment, are exact: the running state
+        // and attachments are kept. Give a copy its own parameter channel,
+        // instrumentation, analyzer, and auto-tuner before stepping both.
         PIDController(const PIDController& orig);
+        PIDController& operator=(const PIDController& orig);
         virtual ~PIDController();
         
         void targetSetpoint(double setpoint);
@@ -28,30 +129,79 @@ class PIDController {
         void on();
         void setInputLimits(double lowerLimit, double upperLimit);
         void setOutputLimits(double lowerLimit, double upperLimit);
+        void setSamplingPeriod(double samplingPeriod);
+        void setClock(ClockFunction clock);
+        void setAlgorithm(Algorithm algorithm);
+        void setDerivativeMode(DerivativeMode mode);
+        void setDerivativeFilter(double timeConstant);
+        void setAntiWindup(AntiWindup antiWindup);
+        void setTrackingGain(double trackingGain);
+        void setIntegratorLimits(double lowerLimit, double upperLimit);
+        void setParameterChannel(PIDParameterChannel* channel);
+        void setInstrumentation(PIDInstrumentation* instrumentation);
+        void setStepResponseAnalyzer(StepResponseAnalyzer* analyzer);
+        void setGainSchedule(const GainSchedule* schedule, ScheduleVariable variable);
+        void setSchedulingVariable(double value);
+        void autoTune(RelayAutoTuner* tuner);
+        void setEventThresholds(double processVariableDelta, double outputDelta);
         double getSetpoint();
         double getKp();
         double getKi();
         double getKd();
+        double getSamplingPeriod();
+        Algorithm getAlgorithm();
+        DerivativeMode getDerivativeMode();
+        double getDerivativeFilter();
+        AntiWindup getAntiWindup();
+        bool hasOutputChanged();
+        double getOutputIncrement();
+        PIDState getState();
+        void setState(const PIDState& snapshot);
 
         void reset();
         bool hasSettled();
         double calc(double feedback);
+        double calc(double feedback, double samplingTime);
+        double track(double setpoint, double feedback, double samplingTime);
+        PIDOutput calcDetailed(double feedback);
+        PIDOutput calcDetailed(double feedback, double samplingTime);
 
         
     private:
-        bool isEnabled;
-        bool setpointReached;
-        double setpoint; 
-        double lastSetpoint;
-        double lastControlVariable;
-        double lastProcessVariable;
-        double kp, ki, kd;
-        double lowerInputLimit, upperInputLimit;
-        double lowerOutputLimit, upperOutputLimit;
-        boost::timer::cpu_timer sample_timer;
-        double integrator;
-        
-        double limiter(double value, double lowerLimit, double upperLimit);
+        PIDState state;
+        ClockFunction clock;
+        double lastSampleTime;
+        PIDParameterChannel* parameterChannel;
+        PIDInstrumentation* instrumentation;
+        double lastStepTime;
+        StepResponseAnalyzer* analyzer;
+        const GainSchedule* gainSchedule;
+        ScheduleVariable scheduleVariable;
+        double schedulingVariable;
+        RelayAutoTuner* autoTuner;
+        bool eventDriven;
+        bool outputChanged;
+        bool stepTimed;
+        double processVariableDelta;
+        double outputDelta;
+        double emittedOutput;
+        double skippedTime;
+        unsigned long skippedSamples;
+        
+        void init(double kp, double ki, double kd, double lowerInputLimit, double upperInputLimit, double lowerOutputLimit, double upperOutputLimit, double samplingPeriod);
+        void applyParameterChannel();
+        void applyGainSchedule(double processVariable);
+        bool measureSample(double processVariable, double& samplingTime);
+        double compute(double processVariable, double samplingTime);
+        PIDOutput computeDetailed(double processVariable, double samplingTime);
+        PIDOutput heldOutput(double processVariable, double output);
+        double sampleInterval(double start, double samplingTime);
+        double stepAutoTuner(double processVariable, double samplingTime);
+        bool isIdle(double processVariable);
+        double emit(double controlVariable);
+        void resumeFromIdle(double processVariable, double samplingTime);
+        template <bool Detailed>
+        double step(double processVariable, double samplingTime, PIDOutput* detail);
 };
 
 #endif  /* PIDCONTROLLER_H */
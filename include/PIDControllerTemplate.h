@@ -0,0 +1,359 @@
+/* 
+ * File:   PIDControllerTemplate.h
+ * Author: User
+ *
+ * Created on October 14, 2026
+ */
+
+#ifndef PIDCONTROLLERTEMPLATE_H
+#define PIDCONTROLLERTEMPLATE_H
+
+#include <chrono>
+#include <type_traits>
+
+// Header-only PID controller whose arithmetic type and features are chosen at
+// compile time, so that calc() can be inlined into the caller's control loop.
+//
+//     pid::PIDController<double, pid::OutputLimits, pid::FixedTimestep> loop;
+//
+// Scalar may be float, double, or any fixed-point type providing the usual
+// arithmetic and comparison operators and construction from double. Features
+// that are not listed take no storage and generate no instructions.
+//
+// The control law is a reduced one, not ::PIDController's pidStep(): only the
+// positional form, a derivative on the setpoint without a filter, and, with
+// OutputLimits, an integrator clamped to the output limits. There is no
+// velocity form, no derivative on measurement, no derivative filter, and no
+// other anti-windup mode. ::PIDController and CompactPIDController provide
+// those.
+namespace pid {
+
+//------------------------------------------------------------------------------
+// Features
+//------------------------------------------------------------------------------
+
+// Clamp the setpoint in targetSetpoint() to setInputLimits().
+struct InputLimits {};
+// Clamp the integrator and the output to setOutputLimits().
+struct OutputLimits {};
+// Include the kd term.
+struct Derivative {};
+// Track hasSettled() from the rate of change of the process variable.
+struct SettlingDetection {};
+// calc(processVariable) uses the period given to setSamplingPeriod().
+struct FixedTimestep {};
+// calc(processVariable) measures the time between calls with Clock, any
+// std::chrono-style clock such as the ones in PIDClock.h.
+template <class Clock = std::chrono::steady_clock>
+struct MeasuredTimestep {};
+
+namespace detail {
+
+template <class Feature, class... Features>
+struct HasFeature : std::false_type {};
+template <class Feature, class First, class... Rest>
+struct HasFeature<Feature, First, Rest...>
+    : std::integral_constant<bool, std::is_same<Feature, First>::value || HasFeature<Feature, Rest...>::value> {};
+
+template <class... Features>
+struct MeasuredClock {
+    typedef void type;
+};
+template <class Clock, class... Rest>
+struct MeasuredClock<MeasuredTimestep<Clock>, Rest...> {
+    typedef Clock type;
+};
+template <class First, class... Rest>
+struct MeasuredClock<First, Rest...> : MeasuredClock<Rest...> {};
+
+// Per-feature state. The disabled specializations are empty and distinct, so
+// they take no space as base classes.
+template <class Scalar, bool Enabled>
+struct InputLimitState {
+    Scalar lowerInputLimit, upperInputLimit;
+};
+template <class Scalar>
+struct InputLimitState<Scalar, false> {};
+
+template <class Scalar, bool Enabled>
+struct OutputLimitState {
+    Scalar lowerOutputLimit, upperOutputLimit;
+};
+template <class Scalar>
+struct OutputLimitState<Scalar, false> {};
+
+template <class Scalar, bool Enabled>
+struct DerivativeState {
+    Scalar kd;
+    Scalar lastSetpoint;
+};
+template <class Scalar>
+struct DerivativeState<Scalar, false> {};
+
+template <class Scalar, bool Enabled>
+struct SettlingState {
+    bool setpointReached;
+    Scalar lastProcessVariable;
+};
+template <class Scalar>
+struct SettlingState<Scalar, false> {};
+
+template <class Scalar, bool Enabled>
+struct FixedTimestepState {
+    Scalar samplingPeriod;
+};
+template <class Scalar>
+struct FixedTimestepState<Scalar, false> {};
+
+template <class Clock>
+struct MeasuredTimestepState {
+    typename Clock::time_point lastSampleTime;
+};
+template <>
+struct MeasuredTimestepState<void> {};
+
+template <class Scalar>
+inline Scalar limiter(Scalar value, Scalar lowerLimit, Scalar upperLimit) {
+    if(lowerLimit == upperLimit) {
+        return value;
+    }
+    else if(value < lowerLimit) {
+        return lowerLimit;
+    }
+    else if(value > upperLimit) {
+        return upperLimit;
+    }
+    else
+        return value;
+}
+
+template <class Scalar>
+inline Scalar magnitude(Scalar value) {
+    return value < Scalar(0) ? -value : value;
+}
+
+} // namespace detail
+
+template <class Scalar, class... Features>
+class PIDController
+    : private detail::InputLimitState<Scalar, detail::HasFeature<InputLimits, Features...>::value>,
+      private detail::OutputLimitState<Scalar, detail::HasFeature<OutputLimits, Features...>::value>,
+      private detail::DerivativeState<Scalar, detail::HasFeature<Derivative, Features...>::value>,
+      private detail::SettlingState<Scalar, detail::HasFeature<SettlingDetection, Features...>::value>,
+      private detail::FixedTimestepState<Scalar, detail::HasFeature<FixedTimestep, Features...>::value>,
+      private detail::MeasuredTimestepState<typename detail::MeasuredClock<Features...>::type> {
+    public:
+        typedef Scalar value_type;
+        typedef typename detail::MeasuredClock<Features...>::type Clock;
+        
+        static constexpr bool hasInputLimits = detail::HasFeature<InputLimits, Features...>::value;
+        static constexpr bool hasOutputLimits = detail::HasFeature<OutputLimits, Features...>::value;
+        static constexpr bool hasDerivative = detail::HasFeature<Derivative, Features...>::value;
+        static constexpr bool hasSettlingDetection = detail::HasFeature<SettlingDetection, Features...>::value;
+        static constexpr bool hasFixedTimestep = detail::HasFeature<FixedTimestep, Features...>::value;
+        static constexpr bool hasMeasuredTimestep = !std::is_void<Clock>::value;
+        
+        static_assert(!(hasFixedTimestep && hasMeasuredTimestep),
+                      "FixedTimestep and MeasuredTimestep are mutually exclusive");
+        
+        PIDController() {
+            init(Scalar(0), Scalar(0), Scalar(0));
+        }
+        
+        PIDController(Scalar kp, Scalar ki, Scalar kd) {
+            init(kp, ki, kd);
+        }
+        
+        // Sets the desired setpoint, clamped to the input limits if compiled in.
+        void targetSetpoint(Scalar setpoint) {
+            if constexpr (hasInputLimits) {
+                setpoint = detail::limiter(setpoint, this->lowerInputLimit, this->upperInputLimit);
+            }
+            if(setpoint != this->setpoint) {
+                this->setpoint = setpoint;
+                if constexpr (hasMeasuredTimestep) {
+                    this->lastSampleTime = Clock::now();
+                }
+            }
+        }
+        
+        // kd is ignored unless the Derivative feature is compiled in.
+        void setGains(Scalar kp, Scalar ki, Scalar kd) {
+            this->kp = kp;
+            this->ki = ki;
+            if constexpr (hasDerivative) {
+                this->kd = kd;
+            }
+            else {
+                (void)kd;
+            }
+        }
+        
+        void setInputLimits(Scalar lowerLimit, Scalar upperLimit) {
+            static_assert(hasInputLimits, "setInputLimits() requires the InputLimits feature");
+            this->lowerInputLimit = lowerLimit;
+            this->upperInputLimit = upperLimit;
+        }
+        
+        void setOutputLimits(Scalar lowerLimit, Scalar upperLimit) {
+            static_assert(hasOutputLimits, "setOutputLimits() requires the OutputLimits feature");
+            this->lowerOutputLimit = lowerLimit;
+            this->upperOutputLimit = upperLimit;
+        }
+        
+        void setSamplingPeriod(Scalar samplingPeriod) {
+            static_assert(hasFixedTimestep, "setSamplingPeriod() requires the FixedTimestep feature");
+            this->samplingPeriod = samplingPeriod;
+        }
+        
+        Scalar getSetpoint() const { return setpoint; }
+        Scalar getKp() const { return kp; }
+        Scalar getKi() const { return ki; }
+        Scalar getKd() const {
+            if constexpr (hasDerivative) {
+                return this->kd;
+            }
+            else {
+                return Scalar(0);
+            }
+        }
+        
+        // Disables the controller; calc() then holds the last output.
+        void off() {
+            isEnabled = false;
+            if constexpr (hasSettlingDetection) {
+                this->setpointReached = false;
+            }
+        }
+        
+        // Re-enables the controller with a bumpless start from the last output.
+        void on() {
+            if(!isEnabled) {
+                isEnabled = true;
+                integrator = lastControlVariable;
+                if constexpr (hasMeasuredTimestep) {
+                    this->lastSampleTime = Clock::now();
+                }
+            }
+        }
+        
+        void reset() {
+            setpoint = Scalar(0);
+            if constexpr (hasDerivative) {
+                this->lastSetpoint = Scalar(0);
+            }
+            integrator = lastControlVariable;
+        }
+        
+        bool hasSettled() const {
+            static_assert(hasSettlingDetection, "hasSettled() requires the SettlingDetection feature");
+            return this->setpointReached;
+        }
+        
+        // Calculates the next output with the compiled-in time source.
+        Scalar calc(Scalar processVariable) {
+            static_assert(hasFixedTimestep || hasMeasuredTimestep,
+                          "calc(processVariable) requires FixedTimestep or MeasuredTimestep");
+            if constexpr (hasFixedTimestep) {
+                return calc(processVariable, this->samplingPeriod);
+            }
+            else {
+                if(!isEnabled) {
+                    return lastControlVariable;
+                }
+                typename Clock::time_point now = Clock::now();
+                Scalar samplingTime = Scalar(std::chrono::duration<double>(now - this->lastSampleTime).count());
+                this->lastSampleTime = now;
+                return calc(processVariable, samplingTime);
+            }
+        }
+        
+        // Sets the setpoint, clamped to the input limits if compiled in, and
+        // calculates the next output like calc(processVariable, samplingTime).
+        // Unlike targetSetpoint() it never reads the clock, which suits inner
+        // loops whose setpoint changes every sample.
+        Scalar track(Scalar setpoint, Scalar processVariable, Scalar samplingTime) {
+            if constexpr (hasInputLimits) {
+                setpoint = detail::limiter(setpoint, this->lowerInputLimit, this->upperInputLimit);
+            }
+            this->setpoint = setpoint;
+            return calc(processVariable, samplingTime);
+        }
+        
+        // Calculates the next output given the time elapsed since the previous
+        // call, in seconds.
+        Scalar calc(Scalar processVariable, Scalar samplingTime) {
+            if(!isEnabled) {
+                return lastControlVariable;
+            }
+            
+            Scalar error = setpoint - processVariable;
+            
+            if constexpr (hasSettlingDetection) {
+                Scalar diffProcessVariable = (processVariable - this->lastProcessVariable)/samplingTime;
+                this->setpointReached = detail::magnitude(diffProcessVariable) < Scalar(0.5);
+                this->lastProcessVariable = processVariable;
+            }
+            
+            integrator += (error * samplingTime);
+            if constexpr (hasOutputLimits) {
+                integrator = detail::limiter(integrator, this->lowerOutputLimit, this->upperOutputLimit);
+            }
+            Scalar controlVariable = kp * error + ki * integrator;
+            if constexpr (hasDerivative) {
+                Scalar differentiator = (setpoint - this->lastSetpoint)/samplingTime;
+                controlVariable = controlVariable - this->kd * differentiator;
+                this->lastSetpoint = setpoint;
+            }
+            
+            if constexpr (hasOutputLimits) {
+                controlVariable = detail::limiter(controlVariable, this->lowerOutputLimit, this->upperOutputLimit);
+            }
+            lastControlVariable = controlVariable;
+            
+            return controlVariable;
+        }
+        
+    private:
+        bool isEnabled;
+        Scalar setpoint;
+        Scalar lastControlVariable;
+        Scalar kp, ki;
+        Scalar integrator;
+        
+        void init(Scalar kp, Scalar ki, Scalar kd) {
+            if constexpr (hasDerivative) {
+                this->kd = Scalar(0);
+                this->lastSetpoint = Scalar(0);
+            }
+            setGains(kp, ki, kd);
+            if constexpr (hasInputLimits) {
+                setInputLimits(Scalar(-1), Scalar(-1));
+            }
+            if constexpr (hasOutputLimits) {
+                setOutputLimits(Scalar(-1), Scalar(-1));
+            }
+            if constexpr (hasSettlingDetection) {
+                this->setpointReached = false;
+                this->lastProcessVariable = Scalar(0);
+            }
+            if constexpr (hasFixedTimestep) {
+                this->samplingPeriod = Scalar(0);
+            }
+            if constexpr (hasMeasuredTimestep) {
+                this->lastSampleTime = Clock::now();
+            }
+            setpoint = Scalar(0);
+            lastControlVariable = Scalar(0);
+            integrator = Scalar(0);
+            isEnabled = false;
+        }
+};
+
+// The feature set of ::PIDController, with its timer replaced by a steady clock.
+typedef PIDController<double, InputLimits, OutputLimits, Derivative, SettlingDetection, MeasuredTimestep<> > ClassicPIDController;
+
+} // namespace pid
+
+#endif  /* PIDCONTROLLERTEMPLATE_H */
+
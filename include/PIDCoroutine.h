@@ -0,0 +1,394 @@
+/* 
+ * File:   PIDCoroutine.h
+ * Author: User
+ *
+ * Created on October 14, 2026
+ */
+
+#ifndef PIDCOROUTINE_H
+#define PIDCOROUTINE_H
+
+#if !defined(__cpp_impl_coroutine)
+#error "PIDCoroutine.h requires C++20 coroutines"
+#endif
+
+#include "PIDController.h"
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Coroutine control tasks for loops whose feedback arrives from asynchronous
+// I/O, e.g. fieldbus reads, so that no thread has to block per loop.
+//
+// A control task is a coroutine returning pid::ControlTask. It waits for each
+// sample with co_await pid::nextSample() and hands each output to its
+// actuator with co_yield:
+//
+//     pid::ControlTask heater(PIDController& pid) {
+//         for(;;) {
+//             pid::Sample sample = co_await pid::nextSample();
+//             co_yield pid.calc(sample.value, sample.samplingTime);
+//         }
+//     }
+//
+// A pid::ControlExecutor runs any number of tasks on a few worker threads.
+// The I/O completion handler of each read calls post() with the value and
+// its timestamp, which resumes the task on its worker; samplingTime is the
+// time between the timestamps of consecutive samples. pid::controlLoop() is a
+// ready-made task that steps a PIDController this way.
+//
+// The coroutine frame is allocated once, when the task is created. Posting a
+// sample, resuming the task, and delivering its output do not allocate.
+//
+// This header requires C++20; the rest of the library only needs C++17.
+namespace pid {
+
+// One feedback value as seen by a control task.
+struct Sample {
+    double value;
+    // Seconds, on whatever monotonic clock the poster uses.
+    double timestamp;
+    // timestamp minus that of the task's previous sample, 0 for the first.
+    double samplingTime;
+};
+
+struct NextSample {};
+
+// co_await pid::nextSample() suspends the task until a sample is posted.
+inline NextSample nextSample() { return NextSample(); }
+
+namespace detail {
+
+// Mailbox and scheduling state of one task. Everything but current is
+// guarded by the mutex of the task's worker.
+struct ControlTaskState {
+    std::coroutine_handle<> handle;
+    std::function<void(double)> sink;
+    ControlTaskState* next;
+    size_t worker;
+    Sample pending;
+    Sample current;
+    double lastTimestamp;
+    bool hasPending, hasCurrent, started;
+    bool queued, running, finished;
+
+    ControlTaskState()
+        : next(0), worker(0), pending(), current(), lastTimestamp(0),
+          hasPending(false), hasCurrent(false), started(false),
+          queued(false), running(false), finished(false) {}
+
+    // Moves the pending sample to current, computing its samplingTime.
+    void deliver() {
+        current = pending;
+        current.samplingTime = started ? pending.timestamp - lastTimestamp : 0;
+        lastTimestamp = pending.timestamp;
+        started = true;
+        hasPending = false;
+        hasCurrent = true;
+    }
+};
+
+struct SampleAwaiter {
+    ControlTaskState* state;
+
+    bool await_ready() const noexcept { return state->hasCurrent; }
+    void await_suspend(std::coroutine_handle<>) const noexcept {}
+    Sample await_resume() const noexcept {
+        state->hasCurrent = false;
+        return state->current;
+    }
+};
+
+} // namespace detail
+
+//------------------------------------------------------------------------------
+// ControlTask
+//------------------------------------------------------------------------------
+//
+// Owns a control task coroutine until it is given to a ControlExecutor. The
+// coroutine starts suspended and first runs when its first sample arrives.
+// Only pid::nextSample() can be awaited, and co_yield takes the output.
+//------------------------------------------------------------------------------
+
+class ControlTask {
+    public:
+        struct promise_type : detail::ControlTaskState {
+            ControlTask get_return_object() {
+                return ControlTask(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() noexcept { return std::suspend_always(); }
+            std::suspend_always final_suspend() noexcept { return std::suspend_always(); }
+            void return_void() {}
+            // The library does not use exceptions.
+            void unhandled_exception() { std::terminate(); }
+
+            detail::SampleAwaiter await_transform(NextSample) {
+                detail::SampleAwaiter awaiter = { this };
+                return awaiter;
+            }
+            std::suspend_never yield_value(double output) {
+                if(sink) {
+                    sink(output);
+                }
+                return std::suspend_never();
+            }
+        };
+
+        ControlTask() : handle() {}
+        ControlTask(ControlTask&& orig) : handle(orig.handle) { orig.handle = 0; }
+        ControlTask& operator=(ControlTask&& orig) {
+            if(this != &orig) {
+                if(handle) {
+                    handle.destroy();
+                }
+                handle = orig.handle;
+                orig.handle = 0;
+            }
+            return *this;
+        }
+        ~ControlTask() {
+            if(handle) {
+                handle.destroy();
+            }
+        }
+
+        bool isValid() const { return (bool)handle; }
+
+    private:
+        friend class ControlExecutor;
+
+        explicit ControlTask(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+        std::coroutine_handle<promise_type> release() {
+            std::coroutine_handle<promise_type> released = handle;
+            handle = 0;
+            return released;
+        }
+
+        std::coroutine_handle<promise_type> handle;
+
+        ControlTask(const ControlTask&);
+        ControlTask& operator=(const ControlTask&);
+};
+
+//------------------------------------------------------------------------------
+// ControlExecutor
+//------------------------------------------------------------------------------
+//
+// Runs control tasks on a pool of worker threads. Tasks are spread over the
+// workers in turn and always resume on the same one. Each worker sleeps
+// until one of its tasks has a sample and then resumes the ready tasks in the
+// order their samples arrived.
+//
+// post() may be called from any thread, e.g. several I/O threads at once. A
+// sample posted while the task has not yet taken the previous one replaces
+// it: a control loop wants the latest measurement, and the samplingTime of
+// the one it gets still spans the whole interval since its last sample.
+// Tasks are spawned before start(), and post() must not run concurrently
+// with spawn().
+//------------------------------------------------------------------------------
+
+class ControlExecutor {
+    public:
+        typedef std::function<void(double)> ActuatorSink;
+
+        ControlExecutor() : running(false) {
+            unsigned hardwareThreads = std::thread::hardware_concurrency();
+            this->setWorkers(hardwareThreads > 0 ? hardwareThreads : 1);
+        }
+        explicit ControlExecutor(unsigned workers) : running(false) {
+            this->setWorkers(workers > 0 ? workers : 1);
+        }
+        ~ControlExecutor() {
+            this->stop();
+            for(size_t i = 0; i < tasks.size(); i++) {
+                tasks[i].destroy();
+            }
+        }
+
+        unsigned getWorkers() const { return workers.size(); }
+        size_t getTasks() const { return tasks.size(); }
+        bool isRunning() const { return running.load(); }
+
+        // Takes ownership of 'task', whose outputs go to 'sink'. It returns
+        // the id to post the task's samples to, or getTasks() unchanged if
+        // the executor is running or 'task' is empty.
+        size_t spawn(ControlTask&& task, ActuatorSink sink) {
+            if(running.load() || !task.isValid()) {
+                return tasks.size();
+            }
+            std::coroutine_handle<ControlTask::promise_type> handle = task.release();
+            ControlTask::promise_type& state = handle.promise();
+            state.handle = handle;
+            state.sink = sink;
+            state.worker = tasks.size() % workers.size();
+            tasks.push_back(handle);
+            return tasks.size() - 1;
+        }
+
+        // Hands a sample to task 'task'. It returns false for an unknown
+        // task or one whose coroutine has returned.
+        bool post(size_t task, double value, double timestamp) {
+            if(task >= tasks.size()) {
+                return false;
+            }
+            detail::ControlTaskState& state = tasks[task].promise();
+            Worker& worker = *workers[state.worker];
+            bool wake;
+            {
+                std::lock_guard<std::mutex> lock(worker.mutex);
+                if(state.finished) {
+                    return false;
+                }
+                state.pending.value = value;
+                state.pending.timestamp = timestamp;
+                state.hasPending = true;
+                if(state.queued || state.running) {
+                    // The worker requeues a running task after it suspends.
+                    return true;
+                }
+                state.queued = true;
+                worker.push(&state);
+                // Only a worker with nothing to run can be asleep.
+                wake = worker.sleeping;
+            }
+            if(wake) {
+                worker.wake.notify_one();
+            }
+            return true;
+        }
+
+        // Starts the workers. It returns false if they are already running.
+        bool start() {
+            if(running.exchange(true)) {
+                return false;
+            }
+            for(size_t i = 0; i < workers.size(); i++) {
+                workers[i]->thread = std::thread(&ControlExecutor::run, this, workers[i].get());
+            }
+            return true;
+        }
+
+        // Stops the workers after the task each one is running, and waits
+        // for them. Samples left in the mailboxes run after the next start().
+        void stop() {
+            running.store(false);
+            for(size_t i = 0; i < workers.size(); i++) {
+                {
+                    std::lock_guard<std::mutex> lock(workers[i]->mutex);
+                }
+                workers[i]->wake.notify_all();
+            }
+            for(size_t i = 0; i < workers.size(); i++) {
+                if(workers[i]->thread.joinable()) {
+                    workers[i]->thread.join();
+                }
+            }
+        }
+
+    private:
+        // An intrusive FIFO of ready tasks, so that queueing never allocates.
+        struct Worker {
+            std::mutex mutex;
+            std::condition_variable wake;
+            detail::ControlTaskState* head;
+            detail::ControlTaskState* tail;
+            std::thread thread;
+            bool sleeping;
+
+            Worker() : head(0), tail(0), sleeping(false) {}
+
+            void push(detail::ControlTaskState* state) {
+                state->next = 0;
+                if(tail) {
+                    tail->next = state;
+                }
+                else {
+                    head = state;
+                }
+                tail = state;
+            }
+
+            detail::ControlTaskState* pop() {
+                detail::ControlTaskState* state = head;
+                head = state->next;
+                if(!head) {
+                    tail = 0;
+                }
+                return state;
+            }
+        };
+
+        std::vector<std::unique_ptr<Worker> > workers;
+        std::vector<std::coroutine_handle<ControlTask::promise_type> > tasks;
+        std::atomic<bool> running;
+
+        void setWorkers(unsigned count) {
+            for(unsigned i = 0; i < count; i++) {
+                workers.push_back(std::unique_ptr<Worker>(new Worker()));
+            }
+        }
+
+        // Worker thread body. The mutex is held except while a task runs.
+        void run(Worker* worker) {
+            std::unique_lock<std::mutex> lock(worker->mutex);
+            while(running.load(std::memory_order_relaxed)) {
+                if(!worker->head) {
+                    worker->sleeping = true;
+                    worker->wake.wait(lock);
+                    worker->sleeping = false;
+                    continue;
+                }
+                detail::ControlTaskState* state = worker->pop();
+                state->queued = false;
+                state->running = true;
+                state->deliver();
+                lock.unlock();
+
+                state->handle.resume();
+
+                lock.lock();
+                state->running = false;
+                if(state->handle.done()) {
+                    state->finished = true;
+                }
+                else if(state->hasPending) {
+                    state->queued = true;
+                    worker->push(state);
+                }
+            }
+        }
+
+        ControlExecutor(const ControlExecutor&);
+        ControlExecutor& operator=(const ControlExecutor&);
+};
+
+//------------------------------------------------------------------------------
+// controlLoop
+//------------------------------------------------------------------------------
+//
+// A task that steps 'controller' with each sample and yields its output.
+// The first sample, and any whose timestamp does not advance, only set the
+// time base, since calc() needs a positive sampling time. 'controller' must
+// outlive the task.
+//------------------------------------------------------------------------------
+
+inline ControlTask controlLoop(::PIDController& controller) {
+    for(;;) {
+        Sample sample = co_await nextSample();
+        if(sample.samplingTime > 0) {
+            co_yield controller.calc(sample.value, sample.samplingTime);
+        }
+    }
+}
+
+} // namespace pid
+
+#endif  /* PIDCOROUTINE_H */
@@ -0,0 +1,87 @@
+/* 
+ * File:   PIDInstrumentation.h
+ * Author: User
+ *
+ * Created on October 14, 2026
+ */
+
+#ifndef PIDINSTRUMENTATION_H
+#define PIDINSTRUMENTATION_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Copy of the counters of a PIDInstrumentation at one point in time.
+// Histogram bin k counts durations in (2^k, 2^(k+1)] nanoseconds, so that its
+// exported bucket le=2^(k+1) ns is inclusive; bin 0 also holds anything
+// shorter than 2 ns and the last bin anything longer.
+struct PIDInstrumentationSnapshot {
+    static const unsigned BINS = 36;
+    
+    double nominalPeriod;
+    uint64_t samples;
+    uint64_t deadlineMisses;
+    double maxJitter;
+    double samplingTimeSum;
+    uint64_t samplingTimeHistogram[BINS];
+    uint64_t executions;
+    double maxExecutionTime;
+    double executionTimeSum;
+    uint64_t executionTimeHistogram[BINS];
+};
+
+// Timing statistics for one control loop, cheap enough to leave enabled in
+// production. Recording is lock-free and allocation-free: every counter is an
+// atomic updated with plain relaxed loads and stores, which is valid because
+// each instance has a single recording thread (the one running the loop).
+// snapshot() may be called from any other thread at any time; it copies the
+// counters one by one, so a snapshot taken during a recording can mix one
+// sample more in some counters than in others.
+//
+// A sample is a deadline miss when its sampling time exceeds the nominal
+// period by more than the tolerance. Jitter is the absolute difference
+// between the sampling time and the nominal period. A PIDController with a
+// fixed sampling period records the measured interval between its
+// computations as the sampling time, not the period it computes with, so
+// that jitter is not always zero.
+class PIDInstrumentation {
+    public:
+        static const unsigned BINS = PIDInstrumentationSnapshot::BINS;
+        
+        PIDInstrumentation();
+        PIDInstrumentation(double nominalPeriod);
+        PIDInstrumentation(double nominalPeriod, double tolerance);
+        virtual ~PIDInstrumentation();
+        
+        void setNominalPeriod(double nominalPeriod, double tolerance);
+        double getNominalPeriod();
+        double getTolerance();
+        
+        void recordSample(double samplingTime);
+        void recordExecution(double executionTime);
+        void reset();
+        
+        PIDInstrumentationSnapshot snapshot();
+        static void exportText(const PIDInstrumentationSnapshot& snapshot, const std::string& name, std::ostream& out);
+        
+    private:
+        std::atomic<double> nominalPeriod;
+        std::atomic<double> tolerance;
+        std::atomic<uint64_t> samples;
+        std::atomic<uint64_t> deadlineMisses;
+        std::atomic<double> maxJitter;
+        std::atomic<double> samplingTimeSum;
+        std::atomic<uint64_t> samplingTimeHistogram[BINS];
+        std::atomic<uint64_t> executions;
+        std::atomic<double> maxExecutionTime;
+        std::atomic<double> executionTimeSum;
+        std::atomic<uint64_t> executionTimeHistogram[BINS];
+        
+        PIDInstrumentation(const PIDInstrumentation&);
+        PIDInstrumentation& operator=(const PIDInstrumentation&);
+};
+
+#endif  /* PIDINSTRUMENTATION_H */
+
@@ -0,0 +1,63 @@
+/* 
+ * File:   PIDParameterChannel.h
+ * Author: User
+ *
+ * Created on October 14, 2026
+ */
+
+#ifndef PIDPARAMETERCHANNEL_H
+#define PIDPARAMETERCHANNEL_H
+
+#include <atomic>
+
+// Complete parameter set of a PID loop, published as one unit.
+struct PIDParameters {
+    double setpoint;
+    double kp, ki, kd;
+    double lowerInputLimit, upperInputLimit;
+    double lowerOutputLimit, upperOutputLimit;
+};
+
+// Lock-free hand-off of PIDParameters from one supervisory thread to one
+// real-time thread, built as a triple buffer. Both publish() and consume() are
+// wait-free: they never block, retry, or allocate, and the reader always gets
+// a complete parameter set as written by a single publish() call. When the
+// writer publishes faster than the reader consumes, intermediate sets are
+// dropped and the reader sees the newest one.
+//
+// publish() must only be called from one thread at a time, and likewise
+// consume(). Multiple supervisors must serialize their publish() calls among
+// themselves; this does not affect the reader.
+//
+// The class has no virtual functions and a standard layout, and holds buffer
+// indices rather than pointers, so it works the same when placed in memory
+// that processes map at different addresses (see SharedControllerState).
+class PIDParameterChannel {
+    public:
+        PIDParameterChannel();
+        PIDParameterChannel(const PIDParameters& initial);
+        ~PIDParameterChannel();
+        
+        void publish(const PIDParameters& parameters);
+        bool consume(PIDParameters& parameters);
+        
+    private:
+        // Separate cache lines, so that the writer filling its buffer does not
+        // disturb the one the reader is copying from.
+        struct alignas(64) Slot {
+            PIDParameters parameters;
+        };
+        
+        static const unsigned FRESH = 4;
+        
+        Slot slots[3];
+        alignas(64) std::atomic<unsigned> middle;
+        alignas(64) unsigned back;
+        alignas(64) unsigned front;
+        
+        PIDParameterChannel(const PIDParameterChannel&);
+        PIDParameterChannel& operator=(const PIDParameterChannel&);
+};
+
+#endif  /* PIDPARAMETERCHANNEL_H */
+
@@ -0,0 +1,86 @@
+/* 
+ * File:   RelayAutoTuner.h
+ * Author: User
+ *
+ * Created on October 14, 2026
+ */
+
+#ifndef RELAYAUTOTUNER_H
+#define RELAYAUTOTUNER_H
+
+// Relay feedback auto-tuner (Astrom-Hagglund).
+//
+// While running, the tuner replaces the controller with a relay: the output
+// is the bias plus the amplitude while the process variable is below the
+// setpoint and the bias minus the amplitude while it is above, with a
+// hysteresis band against noise. Most plants settle into a limit cycle at
+// their ultimate period Tu, and the ultimate gain follows from the relay
+// amplitude d, the hysteresis e, and the oscillation amplitude a:
+//
+//     Ku = 4d / (pi * sqrt(a^2 - e^2))
+//
+// Tu and a are measured over whole cycles, from one upward relay switch to
+// the next; the first cycle is discarded as a transient. Tuning finishes as
+// soon as two consecutive cycles agree to within 5% after the requested
+// number of cycles, with constant memory and a few operations per sample.
+//
+// The amplitude is positive for direct-acting plants (more output raises the
+// process variable) and negative for reverse-acting ones. Attach a tuner to a
+// PIDController with autoTune(), or to a PIDBank lane with autoTune(lane,
+// tuner); they apply the gains when it finishes.
+class RelayAutoTuner {
+    public:
+        // Tuning rule used by getGains().
+        enum Rule {
+            ZIEGLER_NICHOLS_PI,
+            ZIEGLER_NICHOLS_PID,
+            SIMC_PI
+        };
+        
+        enum State {
+            IDLE,
+            RUNNING,
+            FINISHED,
+            FAILED
+        };
+        
+        RelayAutoTuner();
+        RelayAutoTuner(double amplitude, double hysteresis);
+        virtual ~RelayAutoTuner();
+        
+        void setAmplitude(double amplitude);
+        void setHysteresis(double hysteresis);
+        void setCycles(unsigned cycles);
+        void setTimeout(double timeout);
+        void setRule(Rule rule);
+        State getState();
+        double getUltimateGain();
+        double getUltimatePeriod();
+        bool getGains(double& kp, double& ki, double& kd);
+        
+        void start(double bias);
+        void cancel();
+        double step(double setpoint, double processVariable, double samplingTime);
+        
+    private:
+        double amplitude;
+        double hysteresis;
+        unsigned cycles;
+        double timeout;
+        Rule rule;
+        
+        State state;
+        double bias;
+        bool high;
+        double elapsed;
+        double lastSwitchTime;
+        unsigned completedCycles;
+        double maximum, minimum;
+        double lastPeriod, lastHalfAmplitude;
+        double ultimateGain, ultimatePeriod;
+        
+        void completeCycle();
+};
+
+#endif  /* RELAYAUTOTUNER_H */
+
@@ -0,0 +1,98 @@
+/* 
+ * File:   SharedControllerState.h
+ * Author: User
+ *
+ * Created on October 14, 2026
+ */
+
+#ifndef SHAREDCONTROLLERSTATE_H
+#define SHAREDCONTROLLERSTATE_H
+
+#include "PIDController.h"
+#include "PIDParameterChannel.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Layout of a shared controller state segment, all in host byte order:
+//
+//     header  "PIDSHARE", uint32 version, uint32 header size, uint32 loop
+//             size, uint32 loops, uint32 ready, padding          (64 bytes)
+//     loop    SharedLoop for loop 0 (64-byte aligned)
+//     loop    ...
+//
+// The version changes whenever PIDState, PIDParameters, or the layout below
+// changes, and the recorded sizes catch builds that disagree anyway, so a
+// process only ever maps a segment it can read.
+static const uint32_t SHARED_STATE_VERSION = 2;
+
+struct SharedStateHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t loopSize;
+    uint32_t loops;
+    std::atomic<uint32_t> ready;
+    uint32_t reserved[9];
+};
+
+// One loop: its latest state, behind a sequence lock, and the channel that
+// carries new parameters to it, with the lock that serializes the processes
+// writing to the channel.
+struct alignas(64) SharedLoop {
+    std::atomic<uint32_t> sequence;
+    PIDState state;
+    std::atomic<uint32_t> writer;
+    PIDParameterChannel channel;
+};
+
+// A bank of PIDController states in a POSIX shared-memory segment, so that
+// HMI and logging processes read telemetry and write setpoints and gains
+// without copies through a socket or a system call per poll.
+//
+// The real-time process create()s the segment, attaches each controller to
+// its loop's channel with setParameterChannel(getChannel(loop)), and calls
+// publish(loop, pid) after calc() as often as the state should be visible.
+// publish() is a wait-free copy of PIDState behind a sequence lock, and the
+// controller already checks its channel with a single atomic load. Other
+// processes open() the segment by name, read() consistent snapshots, which
+// retries only while a publish() is in progress, and setParameters() through
+// the lock-free channel.
+//
+// Any number of processes may setParameters() for the same loop: the
+// channel takes one writer at a time, so they take turns through a per-loop
+// lock in the segment, held only for the copy into the channel. The
+// controller never takes it. Only one controller may consume a loop's
+// parameters.
+class SharedControllerState {
+    public:
+        SharedControllerState();
+        virtual ~SharedControllerState();
+        
+        bool create(const std::string& name, size_t loops);
+        bool open(const std::string& name);
+        void close();
+        bool isOpen();
+        static bool remove(const std::string& name);
+        
+        size_t size();
+        PIDParameterChannel* getChannel(size_t loop);
+        void publish(size_t loop, PIDController& pid);
+        bool read(size_t loop, PIDState& state);
+        bool setParameters(size_t loop, const PIDParameters& parameters);
+        
+    private:
+        void* mapping;
+        size_t length;
+        SharedStateHeader* header;
+        SharedLoop* loops;
+        
+        bool map(int descriptor, size_t length);
+        
+        SharedControllerState(const SharedControllerState&);
+        SharedControllerState& operator=(const SharedControllerState&);
+};
+
+#endif  /* SHAREDCONTROLLERSTATE_H */
+
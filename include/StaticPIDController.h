@@ -0,0 +1,177 @@
+/* 
+ * File:   StaticPIDController.h
+ * Author: User
+ *
+ * Created on October 14, 2026
+ */
+
+#ifndef STATICPIDCONTROLLER_H
+#define STATICPIDCONTROLLER_H
+
+#include <type_traits>
+
+// Header-only PID controller whose gains, output limits, and sampling period
+// are compile-time constants, for loops that are never retuned after
+// commissioning:
+//
+//     constexpr pid::StaticGains<double> heater = { 1.5, 0.8, 0, -10, 10, 0.001 };
+//     pid::StaticPIDController<heater> loop;
+//
+// The constants live only in the instruction stream of calc(): multiplies by
+// them are folded, terms with a zero gain and the clamps of an unlimited
+// output are not generated at all, and the object holds nothing but the
+// setpoint and the running state (32 bytes for a double PI loop, 16 for a
+// float or Q31 one). Otherwise calc() computes exactly what ::PIDController
+// does with the same settings: the positional form, the integrator clamped
+// to the output limits, and the derivative on the setpoint.
+//
+// The scalar type is that of the StaticGains, which may be float, double, or
+// a fixed-point type from FixedPoint.h. The gains object must be a constexpr
+// variable with static storage duration. Every member is constexpr, so a
+// loop can also be stepped at compile time, e.g. to check a response in a
+// static_assert.
+namespace pid {
+
+template <class Scalar>
+struct StaticGains {
+    Scalar kp, ki, kd;
+    // Equal limits mean unlimited, as in ::PIDController.
+    Scalar lowerOutputLimit, upperOutputLimit;
+    // A positive period enables calc(processVariable).
+    Scalar samplingPeriod;
+};
+
+namespace detail {
+
+template <class Scalar, bool Enabled>
+struct StaticDerivativeState {
+    constexpr StaticDerivativeState() : lastSetpoint(0) {}
+    Scalar lastSetpoint;
+};
+template <class Scalar>
+struct StaticDerivativeState<Scalar, false> {};
+
+} // namespace detail
+
+template <const auto& Gains>
+class StaticPIDController
+    : private detail::StaticDerivativeState<typename std::decay<decltype(Gains.kp)>::type, !(Gains.kd == decltype(Gains.kd)(0))> {
+    public:
+        typedef typename std::decay<decltype(Gains.kp)>::type Scalar;
+        typedef Scalar value_type;
+        
+        static constexpr Scalar kp = Gains.kp;
+        static constexpr Scalar ki = Gains.ki;
+        static constexpr Scalar kd = Gains.kd;
+        static constexpr Scalar lowerOutputLimit = Gains.lowerOutputLimit;
+        static constexpr Scalar upperOutputLimit = Gains.upperOutputLimit;
+        static constexpr Scalar samplingPeriod = Gains.samplingPeriod;
+        
+        static constexpr bool hasProportional = !(kp == Scalar(0));
+        static constexpr bool hasIntegral = !(ki == Scalar(0));
+        static constexpr bool hasDerivative = !(kd == Scalar(0));
+        static constexpr bool hasOutputLimits = !(lowerOutputLimit == upperOutputLimit);
+        static constexpr bool hasFixedTimestep = samplingPeriod > Scalar(0);
+        
+        constexpr StaticPIDController()
+            : isEnabled(false), setpoint(0), lastControlVariable(0), integrator(0) {}
+        
+        constexpr void targetSetpoint(Scalar setpoint) {
+            this->setpoint = setpoint;
+        }
+        
+        constexpr Scalar getSetpoint() const { return setpoint; }
+        static constexpr Scalar getKp() { return kp; }
+        static constexpr Scalar getKi() { return ki; }
+        static constexpr Scalar getKd() { return kd; }
+        
+        // Disables the controller; calc() then holds the last output.
+        constexpr void off() {
+            isEnabled = false;
+        }
+        
+        // Re-enables the controller with a bumpless start from the last output.
+        constexpr void on() {
+            if(!isEnabled) {
+                isEnabled = true;
+                integrator = lastControlVariable;
+            }
+        }
+        
+        constexpr void reset() {
+            setpoint = Scalar(0);
+            if constexpr (hasDerivative) {
+                this->lastSetpoint = Scalar(0);
+            }
+            integrator = lastControlVariable;
+        }
+        
+        // Calculates the next output over the compiled-in sampling period.
+        constexpr Scalar calc(Scalar processVariable) {
+            static_assert(hasFixedTimestep, "calc(processVariable) requires a positive samplingPeriod");
+            return calc(processVariable, samplingPeriod);
+        }
+        
+        // Sets the setpoint and calculates the next output like
+        // calc(processVariable, samplingTime), for the inner loop of a cascade.
+        constexpr Scalar track(Scalar setpoint, Scalar processVariable, Scalar samplingTime) {
+            this->setpoint = setpoint;
+            return calc(processVariable, samplingTime);
+        }
+        
+        // Calculates the next output given the time elapsed since the previous
+        // call, in seconds.
+        constexpr Scalar calc(Scalar processVariable, Scalar samplingTime) {
+            if(!isEnabled) {
+                return lastControlVariable;
+            }
+            
+            Scalar error = setpoint - processVariable;
+            
+            Scalar controlVariable = Scalar(0);
+            if constexpr (hasProportional) {
+                controlVariable = kp * error;
+            }
+            if constexpr (hasIntegral) {
+                integrator += (error * samplingTime);
+                if constexpr (hasOutputLimits) {
+                    integrator = clamp(integrator);
+                }
+                controlVariable = controlVariable + ki * integrator;
+            }
+            if constexpr (hasDerivative) {
+                Scalar differentiator = (setpoint - this->lastSetpoint)/samplingTime;
+                controlVariable = controlVariable - kd * differentiator;
+                this->lastSetpoint = setpoint;
+            }
+            
+            if constexpr (hasOutputLimits) {
+                controlVariable = clamp(controlVariable);
+            }
+            lastControlVariable = controlVariable;
+            
+            return controlVariable;
+        }
+        
+    private:
+        bool isEnabled;
+        Scalar setpoint;
+        Scalar lastControlVariable;
+        Scalar integrator;
+        
+        static constexpr Scalar clamp(Scalar value) {
+            if(value < lowerOutputLimit) {
+                return lowerOutputLimit;
+            }
+            else if(value > upperOutputLimit) {
+                return upperOutputLimit;
+            }
+            else
+                return value;
+        }
+};
+
+} // namespace pid
+
+#endif  /* STATICPIDCONTROLLER_H */
+
@@ -0,0 +1,62 @@
+/* 
+ * File:   StepResponseAnalyzer.h
+ * Author: User
+ *
+ * Created on October 14, 2026
+ */
+
+#ifndef STEPRESPONSEANALYZER_H
+#define STEPRESPONSEANALYZER_H
+
+// Performance of the response to the latest setpoint change, measured from
+// the sample at which the setpoint changed. Times are in seconds; those not
+// reached yet are infinity. Peak and overshoot are relative to the step: a
+// peak of 1 is exactly the new setpoint, and overshoot is in percent.
+struct StepResponseMetrics {
+    double initialValue;
+    double setpoint;
+    double elapsed;
+    double riseTime;        // from 10% to 90% of the step
+    double peak;
+    double peakTime;
+    double overshoot;
+    double settlingTime;    // start of the current stay within the band
+    double iae;             // integral of |error|
+    double ise;             // integral of error squared
+    bool settled;
+};
+
+// Step-response analyzer updated once per sample with constant state and a
+// handful of operations, so it can stay attached to every loop in
+// production. A new step starts whenever the setpoint changes; the process
+// variable at that sample is taken as the initial value.
+//
+// Attach one to a PIDController with setStepResponseAnalyzer(), or feed it
+// with update() from any loop. Like the controller, it is meant to be used
+// from one thread.
+class StepResponseAnalyzer {
+    public:
+        StepResponseAnalyzer();
+        StepResponseAnalyzer(double settlingBand);
+        virtual ~StepResponseAnalyzer();
+        
+        void setSettlingBand(double settlingBand);
+        double getSettlingBand();
+        
+        void update(double setpoint, double processVariable, double samplingTime);
+        void reset();
+        bool hasSettled();
+        StepResponseMetrics getMetrics();
+        
+    private:
+        bool started;
+        double settlingBand;
+        double bandWidth;
+        double t10;
+        StepResponseMetrics metrics;
+        
+        void begin(double setpoint, double processVariable);
+};
+
+#endif  /* STEPRESPONSEANALYZER_H */
+
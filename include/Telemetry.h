@@ -0,0 +1,151 @@
+/* 
+ * File:   Telemetry.h
+ * Author: User
+ *
+ * Created on October 14, 2026
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "PIDController.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+// One record of a control loop's state at one sample. Fields that a loop
+// does not compute are left at 0. The channel tells loops apart when several
+// of them record through the same recorder.
+struct TelemetrySample {
+    double time;
+    uint32_t channel;
+    double setpoint;
+    double processVariable;
+    double error;
+    double proportional;
+    double integral;
+    double derivative;
+    double output;
+    double samplingTime;
+};
+
+// Columns of a telemetry file, in file order.
+enum TelemetryColumn {
+    TELEMETRY_TIME,
+    TELEMETRY_CHANNEL,
+    TELEMETRY_SETPOINT,
+    TELEMETRY_PROCESS_VARIABLE,
+    TELEMETRY_ERROR,
+    TELEMETRY_PROPORTIONAL,
+    TELEMETRY_INTEGRAL,
+    TELEMETRY_DERIVATIVE,
+    TELEMETRY_OUTPUT,
+    TELEMETRY_SAMPLING_TIME,
+    TELEMETRY_COLUMNS
+};
+
+// Telemetry file layout, all in host byte order:
+//
+//     header  "PIDTELEM", uint32 version, uint32 columns, uint64 chunk rows,
+//             uint64 reserved                                     (32 bytes)
+//     chunk   uint32 "CHNK", uint32 rows, uint64 index of first row,
+//             then each column as 'rows' doubles, in TelemetryColumn order
+//     chunk   ...
+//
+// Every column of every chunk is a contiguous, 8-byte aligned array of
+// doubles, so a mapped file can be read in place. A file cut short by a
+// crash is still readable up to its last complete chunk.
+static const uint32_t TELEMETRY_VERSION = 1;
+
+// Streams TelemetrySamples from a control loop to a telemetry file.
+//
+// record() is the real-time side: it copies the sample into a preallocated
+// single-producer, single-consumer ring and returns, with no locks, system
+// calls, or allocation. A background writer thread drains the ring into
+// columnar chunks and writes them out. When the ring is full the sample is
+// dropped and counted rather than blocking the loop. When a write to the
+// file fails, for instance on a full disk, the writer stops writing: the
+// file stays readable up to its last complete chunk, and the rows it could
+// not write are counted by getWriteErrors() and make close() return false.
+//
+// Each recorder takes samples from one thread at a time; give every thread
+// that records its own recorder.
+class TelemetryRecorder {
+    public:
+        TelemetryRecorder();
+        TelemetryRecorder(size_t capacity, size_t chunkRows);
+        virtual ~TelemetryRecorder();
+        
+        bool open(const std::string& path);
+        bool close();
+        bool isOpen();
+        
+        bool record(const TelemetrySample& sample);
+        bool record(double time, uint32_t channel, const PIDOutput& output);
+        uint64_t getRecorded();
+        uint64_t getDropped();
+        uint64_t getWriteErrors();
+        
+    private:
+        std::vector<TelemetrySample> ring;
+        size_t mask;
+        alignas(64) std::atomic<size_t> head;   // written by record()
+        size_t cachedTail;
+        std::atomic<uint64_t> dropped;
+        alignas(64) std::atomic<size_t> tail;   // written by the writer
+        alignas(64) std::atomic<bool> running;
+        std::atomic<uint64_t> writeErrors;      // written by the writer
+        bool writeFailed;
+        
+        std::vector<double> chunk;
+        size_t chunkRows;
+        size_t chunkFill;
+        uint64_t rowsWritten;
+        std::FILE* file;
+        std::thread writer;
+        
+        void run();
+        size_t drain();
+        void writeChunk();
+        
+        TelemetryRecorder(const TelemetryRecorder&);
+        TelemetryRecorder& operator=(const TelemetryRecorder&);
+};
+
+// Read-only view of a telemetry file, memory-mapped. Columns are returned as
+// pointers into the mapping and stay valid until close().
+class TelemetryReader {
+    public:
+        TelemetryReader();
+        virtual ~TelemetryReader();
+        
+        bool open(const std::string& path);
+        void close();
+        bool isOpen();
+        
+        size_t size();
+        size_t getChunks();
+        size_t getRows(size_t chunk);
+        const double* column(size_t chunk, TelemetryColumn column);
+        bool getSample(size_t index, TelemetrySample& sample);
+        
+        static const char* columnName(TelemetryColumn column);
+        
+    private:
+        void* mapping;
+        size_t length;
+        std::vector<const double*> chunkData;
+        std::vector<size_t> chunkRows;
+        std::vector<size_t> firstRows;
+        size_t rows;
+        
+        TelemetryReader(const TelemetryReader&);
+        TelemetryReader& operator=(const TelemetryReader&);
+};
+
+#endif  /* TELEMETRY_H */
+
@@ -0,0 +1,77 @@
+/* 
+ * File:   TelemetryReplay.h
+ * Author: User
+ *
+ * Created on October 14, 2026
+ */
+
+#ifndef TELEMETRYREPLAY_H
+#define TELEMETRYREPLAY_H
+
+#include "PIDController.h"
+#include "Telemetry.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// How far a replayed controller's output strayed from the recorded one.
+// Differences are |replayed - recorded| output, and infinite when either
+// output is NaN or infinite and the other is not the same. Times are those of
+// the recorded samples: maxDifferenceTime is infinity when every difference
+// is 0, and firstDivergenceTime when no sample diverged.
+struct ReplayStatistics {
+    uint64_t samples;
+    uint64_t diverged;          // samples with a difference above the tolerance
+    double maxDifference;
+    double maxDifferenceTime;
+    double meanDifference;
+    double rmsDifference;
+    double firstDivergenceTime;
+};
+
+// Replays recorded telemetry through PIDControllers and compares their
+// outputs with the recorded ones, to regression-test gain changes and
+// library upgrades against production data.
+//
+// Each controller is added with the channel it replays. For every recorded
+// sample of that channel it is stepped with track(), using the recorded
+// setpoint, process variable, and sampling time, so no clock is read and a
+// recording is replayed as fast as the controllers run. Samples with no
+// positive sampling time are not replayed. Controllers start from their own
+// state, so a recording that begins mid-run usually diverges at first.
+//
+// run() splits the controllers over worker threads that read the mapped
+// file in place. A controller is only used by one thread, and must not be
+// used elsewhere during run().
+class TelemetryReplay {
+    public:
+        TelemetryReplay();
+        TelemetryReplay(double tolerance);
+        virtual ~TelemetryReplay();
+
+        size_t add(PIDController* controller, uint32_t channel);
+        void clear();
+        void setTolerance(double tolerance);
+        double getTolerance();
+        size_t getControllers();
+
+        bool run(TelemetryReader& reader);
+        bool run(TelemetryReader& reader, unsigned threads);
+        ReplayStatistics getStatistics(size_t controller);
+
+    private:
+        struct Replay {
+            PIDController* controller;
+            uint32_t channel;
+            ReplayStatistics statistics;
+            double sumDifference;
+            double sumSquares;
+        };
+
+        std::vector<Replay> replays;
+        double tolerance;
+
+        void replay(TelemetryReader* reader, size_t first, size_t last);
+};
+
+#endif  /* TELEMETRYREPLAY_H */
@@ -0,0 +1,307 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "CompactPIDController.h"
+#include "PIDStep.h"
+
+//------------------------------------------------------------------------------
+// Constructors
+//------------------------------------------------------------------------------
+
+// Default constructor
+CompactPIDController::CompactPIDController() {
+    this->init(0, 0, 0, -1, -1, -1, -1, 0);
+}
+
+// Just gains, no limits
+CompactPIDController::CompactPIDController(double kp, double ki, double kd) {
+    this->init(kp, ki, kd, -1, -1, -1, -1, 0);
+}
+
+// Gains and a fixed sampling period, no limits
+CompactPIDController::CompactPIDController(double kp, double ki, double kd, double samplingPeriod) {
+    this->init(kp, ki, kd, -1, -1, -1, -1, samplingPeriod);
+}
+
+// Gains and output limits
+CompactPIDController::CompactPIDController(double kp, double ki, double kd, double lowerOutputLimit, double upperOutputLimit) {
+    this->init(kp, ki, kd, -1, -1, lowerOutputLimit, upperOutputLimit, 0);
+}
+
+// All gains and limits
+CompactPIDController::CompactPIDController(double kp, double ki, double kd, double lowerInputLimit, double upperInputLimit, double lowerOutputLimit, double upperOutputLimit) {
+    this->init(kp, ki, kd, lowerInputLimit, upperInputLimit, lowerOutputLimit, upperOutputLimit, 0);
+}
+
+// From a snapshot of a PIDController or another CompactPIDController
+CompactPIDController::CompactPIDController(const PIDState& state) {
+    this->init(0, 0, 0, -1, -1, -1, -1, 0);
+    this->setState(state);
+}
+
+//------------------------------------------------------------------------------
+// Accessors
+//------------------------------------------------------------------------------
+
+double CompactPIDController::getSetpoint() {
+    return state.setpoint;
+}
+
+double CompactPIDController::getKp() {
+    return state.kp;
+}
+
+double CompactPIDController::getKi() {
+    return state.ki;
+}
+
+double CompactPIDController::getKd() {
+    return state.kd;
+}
+
+double CompactPIDController::getSamplingPeriod() {
+    return state.samplingPeriod;
+}
+
+PIDController::Algorithm CompactPIDController::getAlgorithm() {
+    return (PIDController::Algorithm)state.algorithm;
+}
+
+PIDController::DerivativeMode CompactPIDController::getDerivativeMode() {
+    return (PIDController::DerivativeMode)state.derivativeMode;
+}
+
+double CompactPIDController::getDerivativeFilter() {
+    return state.derivativeTimeConstant;
+}
+
+PIDController::AntiWindup CompactPIDController::getAntiWindup() {
+    return (PIDController::AntiWindup)state.antiWindup;
+}
+
+// The change of the output at the last calc().
+double CompactPIDController::getOutputIncrement() {
+    return state.outputIncrement;
+}
+
+//------------------------------------------------------------------------------
+// getState
+//------------------------------------------------------------------------------
+//
+// Return Value : const PIDState&
+// Parameters   : None
+//
+// This function returns the configuration and internal state, which is all
+// there is to this controller. PIDController::setState() and setState()
+// resume from it exactly where this controller is.
+//------------------------------------------------------------------------------
+
+const PIDState& CompactPIDController::getState() {
+    return state;
+}
+
+//------------------------------------------------------------------------------
+// Mutators
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// targetSetpoint
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : setpoint
+//
+// This function sets the desired setpoint, within the input limits.
+//------------------------------------------------------------------------------
+
+void CompactPIDController::targetSetpoint(double setpoint) {
+    state.setpoint = pidLimit(setpoint, state.lowerInputLimit, state.upperInputLimit);
+}
+
+void CompactPIDController::setGains(double kp, double ki, double kd) {
+    state.kp = kp;
+    state.ki = ki;
+    state.kd = kd;
+}
+
+void CompactPIDController::setInputLimits(double lowerInputLimit, double upperInputLimit) {
+    state.lowerInputLimit = lowerInputLimit;
+    state.upperInputLimit = upperInputLimit;
+}
+
+void CompactPIDController::setOutputLimits(double lowerOutputLimit, double upperOutputLimit) {
+    state.lowerOutputLimit = lowerOutputLimit;
+    state.upperOutputLimit = upperOutputLimit;
+}
+
+//------------------------------------------------------------------------------
+// setSamplingPeriod
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : samplingPeriod
+//
+// This function sets the sampling time calc(processVariable) uses. Without a
+// positive period, calc(processVariable) holds the output, since there is no
+// clock to measure the time with.
+//------------------------------------------------------------------------------
+
+void CompactPIDController::setSamplingPeriod(double samplingPeriod) {
+    state.samplingPeriod = samplingPeriod;
+}
+
+//------------------------------------------------------------------------------
+// setAlgorithm
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : algorithm
+//
+// This function selects the positional or velocity form, switching bumplessly
+// like PIDController::setAlgorithm().
+//------------------------------------------------------------------------------
+
+void CompactPIDController::setAlgorithm(PIDController::Algorithm algorithm) {
+    pidSetAlgorithm(state, algorithm);
+}
+
+void CompactPIDController::setDerivativeMode(PIDController::DerivativeMode mode) {
+    state.derivativeMode = mode;
+}
+
+// Time constant of the derivative filter in seconds, 0 for none.
+void CompactPIDController::setDerivativeFilter(double timeConstant) {
+    state.derivativeTimeConstant = timeConstant > 0 ? timeConstant : 0;
+}
+
+void CompactPIDController::setAntiWindup(PIDController::AntiWindup antiWindup) {
+    state.antiWindup = antiWindup;
+}
+
+// Tracking gain of BACK_CALCULATION in 1/s, 0 for ki/kp.
+void CompactPIDController::setTrackingGain(double trackingGain) {
+    state.trackingGain = trackingGain > 0 ? trackingGain : 0;
+}
+
+void CompactPIDController::setIntegratorLimits(double lowerIntegratorLimit, double upperIntegratorLimit) {
+    state.lowerIntegratorLimit = lowerIntegratorLimit;
+    state.upperIntegratorLimit = upperIntegratorLimit;
+}
+
+//------------------------------------------------------------------------------
+// setState
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : snapshot
+//
+// This function restores a snapshot taken with getState() of this class or
+// of PIDController. The next calc() continues from it as the original
+// controller would have. Out-of-range modes fall back to the defaults, as in
+// PIDController::setState().
+//------------------------------------------------------------------------------
+
+void CompactPIDController::setState(const PIDState& snapshot) {
+    pidRestoreState(state, snapshot);
+}
+
+//------------------------------------------------------------------------------
+// Other Functions
+//------------------------------------------------------------------------------
+
+void CompactPIDController::off() {
+    state.isEnabled = false;
+    state.setpointReached = false;
+}
+
+// Re-enables the controller, resuming from the held output.
+void CompactPIDController::on() {
+    if(!state.isEnabled) {
+        state.isEnabled = true;
+        state.integrator = state.lastControlVariable;
+    }
+}
+
+// Clears the setpoint and the running state, keeping the held output.
+void CompactPIDController::reset() {
+    pidResetState(state);
+}
+
+// True when the process variable changed by less than 0.5 per second over
+// the last sample.
+bool CompactPIDController::hasSettled() {
+    return state.setpointReached != 0;
+}
+
+//------------------------------------------------------------------------------
+// init
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : kp, ki, kd, lowerInputLimit, upperInputLimit,
+//                lowerOutputLimit, upperOutputLimit, samplingPeriod
+//
+// This function sets up a disabled controller with the defaults of
+// pidInitState(), the same as for PIDController.
+//------------------------------------------------------------------------------
+
+void CompactPIDController::init(double kp, double ki, double kd, double lowerInputLimit, double upperInputLimit, double lowerOutputLimit, double upperOutputLimit, double samplingPeriod) {
+    pidInitState(state, kp, ki, kd, lowerInputLimit, upperInputLimit, lowerOutputLimit, upperOutputLimit, samplingPeriod);
+    this->reset();
+    this->off();
+}
+
+//------------------------------------------------------------------------------
+// calc
+//------------------------------------------------------------------------------
+//
+// Return Value : double
+// Parameters   : processVariable
+//
+// This function calculates the next output with the fixed sampling period,
+// or returns the held output if no period is set.
+//------------------------------------------------------------------------------
+
+double CompactPIDController::calc(double processVariable) {
+    if(!(state.samplingPeriod > 0)) {
+        return state.lastControlVariable;
+    }
+    return calc(processVariable, state.samplingPeriod);
+}
+
+//------------------------------------------------------------------------------
+// track
+//------------------------------------------------------------------------------
+//
+// Return Value : double
+// Parameters   : setpoint, processVariable, samplingTime
+//
+// This function sets the setpoint, within the input limits, and calculates
+// the next output like calc(processVariable, samplingTime).
+//------------------------------------------------------------------------------
+
+double CompactPIDController::track(double setpoint, double processVariable, double samplingTime) {
+    state.setpoint = pidLimit(setpoint, state.lowerInputLimit, state.upperInputLimit);
+    return calc(processVariable, samplingTime);
+}
+
+//------------------------------------------------------------------------------
+// calc
+//------------------------------------------------------------------------------
+//
+// Return Value : double
+// Parameters   : processVariable, samplingTime
+//
+// This function calculates the next output from the setpoint, the time since
+// the previous call (samplingTime, in seconds), and the feedback, with the
+// pidStep() that PIDController::calc() runs as well. A disabled controller returns the held
+// output.
+//------------------------------------------------------------------------------
+
+double CompactPIDController::calc(double processVariable, double samplingTime) {
+    if(!state.isEnabled) {
+        return state.lastControlVariable;
+    }
+    return pidStep<false>(state, processVariable, samplingTime, 0);
+}
@@ -0,0 +1,314 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "ControlScheduler.h"
+#include <algorithm>
+#include <cerrno>
+#include <pthread.h>
+#include <time.h>
+
+//------------------------------------------------------------------------------
+// Time helpers
+//------------------------------------------------------------------------------
+
+static const long long NANOSECONDS_PER_SECOND = 1000000000LL;
+
+static inline long long monotonicNow() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * NANOSECONDS_PER_SECOND + now.tv_nsec;
+}
+
+// Returns 0, or the error clock_nanosleep() failed with.
+static inline int sleepUntil(long long deadline) {
+    struct timespec wake;
+    wake.tv_sec = deadline / NANOSECONDS_PER_SECOND;
+    wake.tv_nsec = deadline % NANOSECONDS_PER_SECOND;
+    int result;
+    do {
+        // Interrupted by a signal; the deadline is absolute, so just retry.
+        result = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, 0);
+    } while(result == EINTR);
+    return result;
+}
+
+//------------------------------------------------------------------------------
+// Constructors
+//------------------------------------------------------------------------------
+
+// One worker per hardware thread
+ControlScheduler::ControlScheduler() : running(false), error(0), taskCount(0) {
+    unsigned workers = std::thread::hardware_concurrency();
+    shards.resize(workers > 0 ? workers : 1);
+    for(size_t i = 0; i < shards.size(); i++) {
+        shards[i].load = 0;
+        shards[i].core = -1;
+    }
+}
+
+// A given number of workers
+ControlScheduler::ControlScheduler(unsigned workers) : running(false), error(0), taskCount(0) {
+    shards.resize(workers > 0 ? workers : 1);
+    for(size_t i = 0; i < shards.size(); i++) {
+        shards[i].load = 0;
+        shards[i].core = -1;
+    }
+}
+
+// Destructor
+ControlScheduler::~ControlScheduler() {
+    this->stop();
+}
+
+//------------------------------------------------------------------------------
+// Accessors
+//------------------------------------------------------------------------------
+
+unsigned ControlScheduler::getWorkers() {
+    return shards.size();
+}
+
+bool ControlScheduler::isRunning() {
+    return running.load();
+}
+
+int ControlScheduler::getError() {
+    return error.load();
+}
+
+//------------------------------------------------------------------------------
+// Mutators
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// add
+//------------------------------------------------------------------------------
+//
+// Return Value : size_t
+// Parameters   : controller, rate, source, sink
+//
+// This function schedules 'controller' to be stepped 'rate' times per second:
+// each tick reads the process variable from 'source', calls calc() and passes
+// the output to 'sink'. The task goes to the worker with the least total rate.
+// Tasks can only be added while the scheduler is stopped, and only with a
+// finite rate whose period is at least 1 ns; other rates, including NaN, are
+// ignored. It returns the number
+// of tasks added so far.
+//------------------------------------------------------------------------------
+
+size_t ControlScheduler::add(PIDController* controller, double rate, FeedbackSource source, ActuatorSink sink) {
+    return this->add(controller, rate, source, sink, 0);
+}
+
+//------------------------------------------------------------------------------
+// add
+//------------------------------------------------------------------------------
+//
+// Return Value : size_t
+// Parameters   : controller, rate, source, sink, instrumentation
+//
+// This function schedules a task like add(controller, rate, source, sink),
+// and records its timing into 'instrumentation' when it is not null: the
+// actual time between the starts of consecutive ticks as the sampling time,
+// and the time spent reading the source, calculating, and writing the sink as
+// the execution time. Its nominal period is set to the task period, keeping a
+// tolerance already set, or half a period otherwise.
+//------------------------------------------------------------------------------
+
+size_t ControlScheduler::add(PIDController* controller, double rate, FeedbackSource source, ActuatorSink sink, PIDInstrumentation* instrumentation) {
+    if(running.load() || !(rate > 0)) {
+        return taskCount;
+    }
+    // A period under 1 ns would truncate to 0, and one beyond the range of
+    // long long would not convert at all.
+    double period = NANOSECONDS_PER_SECOND / rate;
+    if(!(period >= 1 && period < 9.2e18)) {
+        return taskCount;
+    }
+    
+    Task task;
+    task.controller = controller;
+    task.period = (long long)period;
+    task.source = source;
+    task.sink = sink;
+    task.instrumentation = instrumentation;
+    if(instrumentation) {
+        double tolerance = instrumentation->getTolerance();
+        instrumentation->setNominalPeriod(1 / rate, tolerance > 0 ? tolerance : 0.5 / rate);
+    }
+    
+    size_t lightest = 0;
+    for(size_t i = 1; i < shards.size(); i++) {
+        if(shards[i].load < shards[lightest].load) {
+            lightest = i;
+        }
+    }
+    shards[lightest].tasks.push_back(task);
+    shards[lightest].load += rate;
+    
+    return ++taskCount;
+}
+
+//------------------------------------------------------------------------------
+// setCores
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : cores
+//
+// This function sets the cores the workers are pinned to: worker i runs on
+// cores[i % cores.size()]. By default worker i is pinned to core i. It takes
+// effect on the next start().
+//------------------------------------------------------------------------------
+
+void ControlScheduler::setCores(const std::vector<int>& cores) {
+    this->cores = cores;
+}
+
+//------------------------------------------------------------------------------
+// Other Functions
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// start
+//------------------------------------------------------------------------------
+//
+// Return Value : bool
+// Parameters   : None
+//
+// This function starts one pinned thread per worker that has tasks and clears
+// the last error. It returns false if the scheduler is already running.
+//------------------------------------------------------------------------------
+
+bool ControlScheduler::start() {
+    if(running.exchange(true)) {
+        return false;
+    }
+    error.store(0);
+    unsigned hardwareThreads = std::thread::hardware_concurrency();
+    for(size_t i = 0; i < shards.size(); i++) {
+        if(!cores.empty()) {
+            shards[i].core = cores[i % cores.size()];
+        }
+        else {
+            shards[i].core = hardwareThreads > 0 ? (int)(i % hardwareThreads) : -1;
+        }
+        if(!shards[i].tasks.empty()) {
+            shards[i].thread = std::thread(&ControlScheduler::run, this, &shards[i]);
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// stop
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : None
+//
+// This function asks every worker to stop and waits for them. A worker stops
+// after its next tick, so this takes at most one period of the slowest loop.
+// When it returns, every added controller holds the state its worker's copy
+// ran to.
+//------------------------------------------------------------------------------
+
+void ControlScheduler::stop() {
+    running.store(false);
+    for(size_t i = 0; i < shards.size(); i++) {
+        if(shards[i].thread.joinable()) {
+            shards[i].thread.join();
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// run
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : shard
+//
+// Worker thread body. After pinning itself, the worker copies its tasks and
+// their controllers into memory it allocates itself, so that the shard's
+// state is first touched (and placed) on its own core, and only the worker
+// writes to its cache lines. It then keeps a min-heap of task deadlines, sleeps
+// until the earliest one with an absolute clock_nanosleep(), and steps every
+// task that is due. A task that falls behind skips the deadlines it missed
+// rather than running back to back, and its next calc() is given the whole
+// interval since its previous tick. On the way out, the copies are written
+// back to the added controllers.
+//------------------------------------------------------------------------------
+
+void ControlScheduler::run(Shard* shard) {
+#if defined(__linux__)
+    if(shard->core >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(shard->core, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+#endif
+    
+    std::vector<Task> tasks(shard->tasks);
+    std::vector<LocalController> controllers;
+    controllers.reserve(tasks.size());
+    for(size_t i = 0; i < tasks.size(); i++) {
+        controllers.push_back(LocalController(*tasks[i].controller));
+    }
+    std::vector<long long> lastTick(tasks.size());
+    std::vector<long long> lastStart(tasks.size());
+    // (deadline, task) pairs; std::greater makes the heap a min-heap.
+    std::vector<std::pair<long long, size_t> > deadlines(tasks.size());
+    
+    long long begin = monotonicNow();
+    for(size_t i = 0; i < tasks.size(); i++) {
+        lastTick[i] = begin;
+        lastStart[i] = begin;
+        deadlines[i] = std::make_pair(begin + tasks[i].period, i);
+    }
+    std::make_heap(deadlines.begin(), deadlines.end(), std::greater<std::pair<long long, size_t> >());
+    
+    while(running.load(std::memory_order_relaxed)) {
+        long long deadline = deadlines.front().first;
+        int result = sleepUntil(deadline);
+        if(result != 0) {
+            error.store(result);
+            break;
+        }
+        
+        long long now = monotonicNow();
+        while(deadlines.front().first <= now) {
+            std::pop_heap(deadlines.begin(), deadlines.end(), std::greater<std::pair<long long, size_t> >());
+            std::pair<long long, size_t>& due = deadlines.back();
+            Task& task = tasks[due.second];
+            PIDController& controller = controllers[due.second].controller;
+            
+            double samplingTime = (double)(due.first - lastTick[due.second]) / NANOSECONDS_PER_SECOND;
+            if(task.instrumentation) {
+                long long start = monotonicNow();
+                task.sink(controller.calc(task.source(), samplingTime));
+                long long end = monotonicNow();
+                task.instrumentation->recordSample((double)(start - lastStart[due.second]) / NANOSECONDS_PER_SECOND);
+                task.instrumentation->recordExecution((double)(end - start) / NANOSECONDS_PER_SECOND);
+                lastStart[due.second] = start;
+                now = end;
+            }
+            else {
+                task.sink(controller.calc(task.source(), samplingTime));
+            }
+            lastTick[due.second] = due.first;
+            
+            due.first += task.period;
+            if(due.first <= now) {
+                due.first += ((now - due.first) / task.period + 1) * task.period;
+            }
+            std::push_heap(deadlines.begin(), deadlines.end(), std::greater<std::pair<long long, size_t> >());
+        }
+    }
+    
+    for(size_t i = 0; i < tasks.size(); i++) {
+        *tasks[i].controller = controllers[i].controller;
+    }
+}
@@ -0,0 +1,78 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "GainSchedule.h"
+#include <cmath>
+
+//------------------------------------------------------------------------------
+// Constructors
+//------------------------------------------------------------------------------
+
+// Empty schedule
+GainSchedule::GainSchedule() : uniform(false), first(0), inverseStep(0) {
+}
+
+// Destructor
+GainSchedule::~GainSchedule() {
+}
+
+//------------------------------------------------------------------------------
+// Accessors
+//------------------------------------------------------------------------------
+
+// Number of rows
+size_t GainSchedule::size() const {
+    return breakpoints.size();
+}
+
+// True when the rows are evenly spaced and looked up without a search
+bool GainSchedule::isUniform() const {
+    return uniform;
+}
+
+//------------------------------------------------------------------------------
+// Mutators
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// setPoints
+//------------------------------------------------------------------------------
+//
+// Return Value : bool
+// Parameters   : points, count
+//
+// This function replaces the table with 'count' rows, which must be sorted by
+// strictly increasing, finite scheduling variable. Rows spaced evenly to
+// within a relative 1e-9 are looked up in constant time. It returns false and
+// leaves the table unchanged if the rows are not sorted.
+//------------------------------------------------------------------------------
+
+bool GainSchedule::setPoints(const GainSchedulePoint* points, size_t count) {
+    for(size_t i = 0; i < count; i++) {
+        if(!std::isfinite(points[i].variable) || (i > 0 && !(points[i].variable > points[i - 1].variable))) {
+            return false;
+        }
+    }
+    
+    breakpoints.resize(count);
+    gains.resize(3 * count);
+    for(size_t i = 0; i < count; i++) {
+        breakpoints[i] = points[i].variable;
+        gains[3 * i] = points[i].kp;
+        gains[3 * i + 1] = points[i].ki;
+        gains[3 * i + 2] = points[i].kd;
+    }
+    
+    uniform = false;
+    if(count >= 2) {
+        double step = (breakpoints[count - 1] - breakpoints[0]) / (count - 1);
+        uniform = true;
+        for(size_t i = 1; i < count && uniform; i++) {
+            uniform = std::fabs((breakpoints[i] - breakpoints[i - 1]) - step) <= 1e-9 * step;
+        }
+        first = breakpoints[0];
+        inverseStep = 1 / step;
+    }
+    return true;
+}
@@ -0,0 +1,656 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "PIDBank.h"
+#include "PIDBankKernel.h"
+#include "RelayAutoTuner.h"
+#include <cmath>
+
+//------------------------------------------------------------------------------
+// unlimitedLower / unlimitedUpper
+//------------------------------------------------------------------------------
+//
+// Return Value : Scalar
+// Parameters   : lowerLimit, upperLimit
+//
+// The kernels clamp without branching, so equal limits (PIDController's way
+// of saying "no limit") are stored as -inf/+inf instead.
+//------------------------------------------------------------------------------
+
+template <class Scalar>
+static inline Scalar unlimitedLower(Scalar lowerLimit, Scalar upperLimit) {
+    return lowerLimit == upperLimit ? -INFINITY : lowerLimit;
+}
+
+template <class Scalar>
+static inline Scalar unlimitedUpper(Scalar lowerLimit, Scalar upperLimit) {
+    return lowerLimit == upperLimit ? INFINITY : upperLimit;
+}
+
+//------------------------------------------------------------------------------
+// Constructors
+//------------------------------------------------------------------------------
+
+// Empty bank
+template <class Scalar>
+PIDBankOf<Scalar>::PIDBankOf() {
+    this->init();
+}
+
+// Bank of 'size' controllers in their default state
+template <class Scalar>
+PIDBankOf<Scalar>::PIDBankOf(size_t size) {
+    this->init();
+    this->resize(size);
+}
+
+// Destructor
+template <class Scalar>
+PIDBankOf<Scalar>::~PIDBankOf() {
+}
+
+//------------------------------------------------------------------------------
+// Accessors
+//------------------------------------------------------------------------------
+
+template <class Scalar>
+size_t PIDBankOf<Scalar>::size() {
+    return setpoint.size();
+}
+
+template <class Scalar>
+PIDBankTypes::Isa PIDBankOf<Scalar>::getIsa() {
+    return isa;
+}
+
+template <class Scalar>
+PIDBankTypes::Algorithm PIDBankOf<Scalar>::getAlgorithm() {
+    return algorithm;
+}
+
+template <class Scalar>
+PIDBankTypes::AntiWindup PIDBankOf<Scalar>::getAntiWindup() {
+    return antiWindup;
+}
+
+template <class Scalar>
+bool PIDBankOf<Scalar>::getCompensatedSummation() {
+    return compensated;
+}
+
+//------------------------------------------------------------------------------
+// bestIsa
+//------------------------------------------------------------------------------
+//
+// Return Value : Isa
+// Parameters   : None
+//
+// This function returns the widest calcAll() kernel that was compiled in and
+// that the CPU running the process supports.
+//------------------------------------------------------------------------------
+
+PIDBankTypes::Isa PIDBankTypes::bestIsa() {
+#if defined(PID_HAVE_AVX512)
+    if(__builtin_cpu_supports("avx512f")) {
+        return ISA_AVX512;
+    }
+#endif
+#if defined(PID_HAVE_AVX2)
+    if(__builtin_cpu_supports("avx2")) {
+        return ISA_AVX2;
+    }
+#endif
+#if defined(PID_HAVE_NEON)
+    return ISA_NEON;
+#endif
+    return ISA_SCALAR;
+}
+
+template <class Scalar>
+Scalar PIDBankOf<Scalar>::getSetpoint(size_t lane) {
+    return setpoint[lane];
+}
+
+template <class Scalar>
+Scalar PIDBankOf<Scalar>::getKp(size_t lane) {
+    return kp[lane];
+}
+
+template <class Scalar>
+Scalar PIDBankOf<Scalar>::getKi(size_t lane) {
+    return ki[lane];
+}
+
+template <class Scalar>
+Scalar PIDBankOf<Scalar>::getKd(size_t lane) {
+    return kd[lane];
+}
+
+//------------------------------------------------------------------------------
+// Mutators
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// resize
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : size
+//
+// This function changes the number of lanes in the bank. Existing lanes keep
+// their state, and new lanes start out like a default-constructed
+// PIDController: zero gains, no limits, and disabled.
+//------------------------------------------------------------------------------
+
+template <class Scalar>
+void PIDBankOf<Scalar>::resize(size_t size) {
+    isEnabled.resize(size, 0);
+    setpointReached.resize(size, 0);
+    setpoint.resize(size, 0);
+    lastSetpoint.resize(size, 0);
+    lastControlVariable.resize(size, 0);
+    lastProcessVariable.resize(size, 0);
+    lastError.resize(size, 0);
+    lastDifferentiator.resize(size, 0);
+    kp.resize(size, 0);
+    ki.resize(size, 0);
+    kd.resize(size, 0);
+    lowerInputLimit.resize(size, -INFINITY);
+    upperInputLimit.resize(size, INFINITY);
+    lowerOutputLimit.resize(size, -INFINITY);
+    upperOutputLimit.resize(size, INFINITY);
+    lowerIntegratorLimit.resize(size, -INFINITY);
+    upperIntegratorLimit.resize(size, INFINITY);
+    trackingGain.resize(size, 0);
+    integrator.resize(size, 0);
+    compensation.resize(size, 0);
+    for(size_t i = tuningLanes.size(); i-- > 0;) {
+        if(tuningLanes[i] >= size) {
+            tuners[i]->cancel();
+            tuningLanes[i] = tuningLanes.back();
+            tuners[i] = tuners.back();
+            tuningLanes.pop_back();
+            tuners.pop_back();
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// setIsa
+//------------------------------------------------------------------------------
+//
+// Return Value : bool
+// Parameters   : isa
+//
+// This function selects the calcAll() kernel. It returns false and leaves the
+// current kernel in place if 'isa' was not compiled in or is not supported by
+// the CPU. Every kernel gives the same results, so this only matters for
+// benchmarking and verification.
+//------------------------------------------------------------------------------
+
+template <class Scalar>
+bool PIDBankOf<Scalar>::setIsa(Isa isa) {
+    switch(isa) {
+        case ISA_SCALAR:
+            break;
+#if defined(PID_HAVE_AVX2)
+        case ISA_AVX2:
+            if(!__builtin_cpu_supports("avx2")) {
+                return false;
+            }
+            break;
+#endif
+#if defined(PID_HAVE_AVX512)
+        case ISA_AVX512:
+            if(!__builtin_cpu_supports("avx512f")) {
+                return false;
+            }
+            break;
+#endif
+#if defined(PID_HAVE_NEON)
+        case ISA_NEON:
+            break;
+#endif
+        default:
+            return false;
+    }
+    this->isa = isa;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// setAlgorithm
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : algorithm
+//
+// This function selects the positional or velocity form of the PID algorithm
+// for every lane, with the same bumpless switch as
+// PIDController::setAlgorithm().
+//------------------------------------------------------------------------------
+
+template <class Scalar>
+void PIDBankOf<Scalar>::setAlgorithm(Algorithm algorithm) {
+    if(algorithm == POSITIONAL && this->algorithm == VELOCITY) {
+        for(size_t i = 0; i < size(); i++) {
+            if(ki[i] != 0) {
+                Scalar value = (lastControlVariable[i] - kp[i] * lastError[i] + kd[i] * lastDifferentiator[i]) / ki[i];
+                if(value < lowerOutputLimit[i]) {
+                    value = lowerOutputLimit[i];
+                }
+                else if(value > upperOutputLimit[i]) {
+                    value = upperOutputLimit[i];
+                }
+                integrator[i] = value;
+            }
+        }
+    }
+    if(algorithm != this->algorithm) {
+        compensation.assign(size(), 0);
+    }
+    this->algorithm = algorithm;
+}
+
+//------------------------------------------------------------------------------
+// setAntiWindup
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : antiWindup
+//
+// This function selects the anti-windup mode of the positional form for every
+// lane, as PIDController::setAntiWindup() does for one controller. Each mode
+// is a separate kernel instantiation, so the default costs nothing extra.
+//------------------------------------------------------------------------------
+
+template <class Scalar>
+void PIDBankOf<Scalar>::setAntiWindup(AntiWindup antiWindup) {
+    this->antiWindup = antiWindup;
+}
+
+//------------------------------------------------------------------------------
+// setCompensatedSummation
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : compensated
+//
+// This function turns Kahan summation of the running sums on or off. It is on
+// by default for float lanes, whose sums drift over long runs, and off for
+// double lanes, which then match PIDController bit for bit. Plain summation
+// saves three additions per lane and the reads and writes of one array.
+//------------------------------------------------------------------------------
+
+template <class Scalar>
+void PIDBankOf<Scalar>::setCompensatedSummation(bool compensated) {
+    if(compensated != this->compensated) {
+        compensation.assign(size(), 0);
+    }
+    this->compensated = compensated;
+}
+
+//------------------------------------------------------------------------------
+// targetSetpoint
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : lane, setpoint
+//
+// This function sets the desired setpoint that the PID controller in 'lane'
+// will attempt to track.
+//------------------------------------------------------------------------------
+
+template <class Scalar>
+void PIDBankOf<Scalar>::targetSetpoint(size_t lane, Scalar setpoint) {
+    if(setpoint < lowerInputLimit[lane]) {
+        setpoint = lowerInputLimit[lane];
+    }
+    else if(setpoint > upperInputLimit[lane]) {
+        setpoint = upperInputLimit[lane];
+    }
+    this->setpoint[lane] = setpoint;
+}
+
+//------------------------------------------------------------------------------
+// setGains
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : lane, kp, ki, kd
+//
+// This function sets the control gains of the PID controller in 'lane'.
+//------------------------------------------------------------------------------
+
+template <class Scalar>
+void PIDBankOf<Scalar>::setGains(size_t lane, Scalar kp, Scalar ki, Scalar kd) {
+    this->kp[lane] = kp;
+    this->ki[lane] = ki;
+    this->kd[lane] = kd;
+}
+
+//------------------------------------------------------------------------------
+// setInputLimits
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : lane, lowerLimit, upperLimit
+//
+// This function sets bounds on the setpoint of the PID controller in 'lane'.
+// Equal limits mean no limit.
+//------------------------------------------------------------------------------
+
+template <class Scalar>
+void PIDBankOf<Scalar>::setInputLimits(size_t lane, Scalar lowerLimit, Scalar upperLimit) {
+    lowerInputLimit[lane] = unlimitedLower(lowerLimit, upperLimit);
+    upperInputLimit[lane] = unlimitedUpper(lowerLimit, upperLimit);
+}
+
+//------------------------------------------------------------------------------
+// setOutputLimits
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : lane, lowerLimit, upperLimit
+//
+// This function sets bounds on the control variable of the PID controller in
+// 'lane'. Equal limits mean no limit.
+//------------------------------------------------------------------------------
+
+template <class Scalar>
+void PIDBankOf<Scalar>::setOutputLimits(size_t lane, Scalar lowerLimit, Scalar upperLimit) {
+    lowerOutputLimit[lane] = unlimitedLower(lowerLimit, upperLimit);
+    upperOutputLimit[lane] = unlimitedUpper(lowerLimit, upperLimit);
+}
+
+//------------------------------------------------------------------------------
+// setIntegratorLimits
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : lane, lowerLimit, upperLimit
+//
+// This function sets the bounds INTEGRATOR_CLAMP keeps the integral term of
+// the PID controller in 'lane' within, as PIDController::setIntegratorLimits().
+// Equal limits mean no limit.
+//------------------------------------------------------------------------------
+
+template <class Scalar>
+void PIDBankOf<Scalar>::setIntegratorLimits(size_t lane, Scalar lowerLimit, Scalar upperLimit) {
+    lowerIntegratorLimit[lane] = unlimitedLower(lowerLimit, upperLimit);
+    upperIntegratorLimit[lane] = unlimitedUpper(lowerLimit, upperLimit);
+}
+
+//------------------------------------------------------------------------------
+// setTrackingGain
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : lane, trackingGain
+//
+// This function sets the BACK_CALCULATION tracking gain of the PID controller
+// in 'lane', as PIDController::setTrackingGain(). 0 tracks with ki/kp.
+//------------------------------------------------------------------------------
+
+template <class Scalar>
+void PIDBankOf<Scalar>::setTrackingGain(size_t lane, Scalar trackingGain) {
+    this->trackingGain[lane] = trackingGain > 0 ? trackingGain : 0;
+}
+
+//------------------------------------------------------------------------------
+// Other Functions
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// init
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : None
+//
+// This function sets up an empty bank for the constructors: the best kernel,
+// the positional form, OUTPUT_CLAMP, and compensated summation for float
+// lanes only.
+//------------------------------------------------------------------------------
+
+template <class Scalar>
+void PIDBankOf<Scalar>::init() {
+    this->setIsa(bestIsa());
+    algorithm = POSITIONAL;
+    antiWindup = OUTPUT_CLAMP;
+    compensated = sizeof(Scalar) < sizeof(double);
+}
+
+//------------------------------------------------------------------------------
+// autoTune
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : lane, tuner
+//
+// This function starts relay auto-tuning 'lane', like
+// PIDController::autoTune(). Any number of lanes can tune at once, each with
+// its own tuner, while the others keep running. Passing a null pointer
+// cancels a run and turns the lane back on.
+//------------------------------------------------------------------------------
+
+template <class Scalar>
+void PIDBankOf<Scalar>::autoTune(size_t lane, RelayAutoTuner* tuner) {
+    for(size_t i = 0; i < tuningLanes.size(); i++) {
+        if(tuningLanes[i] == lane) {
+            tuners[i]->cancel();
+            tuningLanes[i] = tuningLanes.back();
+            tuners[i] = tuners.back();
+            tuningLanes.pop_back();
+            tuners.pop_back();
+            this->on(lane);
+            break;
+        }
+    }
+    if(tuner) {
+        this->off(lane);
+        tuner->start(lastControlVariable[lane]);
+        tuningLanes.push_back(lane);
+        tuners.push_back(tuner);
+    }
+}
+
+//------------------------------------------------------------------------------
+// off
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : lane
+//
+// This function disables the PID controller in 'lane'. calcAll() then holds
+// its last output.
+//------------------------------------------------------------------------------
+
+template <class Scalar>
+void PIDBankOf<Scalar>::off(size_t lane) {
+    isEnabled[lane] = 0;
+    setpointReached[lane] = 0;
+}
+
+//------------------------------------------------------------------------------
+// on
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : lane
+//
+// This function re-enables the PID controller in 'lane' after it has been
+// disabled by the off() function.
+//------------------------------------------------------------------------------
+
+template <class Scalar>
+void PIDBankOf<Scalar>::on(size_t lane) {
+    if(!isEnabled[lane]) {
+        isEnabled[lane] = 1;
+        integrator[lane] = lastControlVariable[lane];
+        compensation[lane] = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+// reset
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : lane
+//
+// This function initializes the PID controller in 'lane' to the default
+// values.
+//------------------------------------------------------------------------------
+
+template <class Scalar>
+void PIDBankOf<Scalar>::reset(size_t lane) {
+    setpoint[lane] = 0;
+    lastSetpoint[lane] = 0;
+    lastError[lane] = 0;
+    lastDifferentiator[lane] = 0;
+    integrator[lane] = lastControlVariable[lane];
+    compensation[lane] = 0;
+}
+
+//------------------------------------------------------------------------------
+// hasSettled
+//------------------------------------------------------------------------------
+//
+// Return Value : bool
+// Parameters   : lane
+//
+// This function returns true only when the PID controller in 'lane' has
+// stabilized.
+//------------------------------------------------------------------------------
+
+template <class Scalar>
+bool PIDBankOf<Scalar>::hasSettled(size_t lane) {
+    return setpointReached[lane] != 0;
+}
+
+//------------------------------------------------------------------------------
+// calcAll
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : processVariable, controlVariable, n, samplingTime
+//
+// This function steps lanes 0 to n-1 with the same math as
+// PIDController::calc(processVariable, samplingTime). processVariable[i] is
+// the feedback of lane i and the next output is written to controlVariable[i].
+// n must not exceed size(). Disabled lanes output their last control variable,
+// except lanes that are auto-tuning, which output their relay.
+//------------------------------------------------------------------------------
+
+template <class Scalar>
+void PIDBankOf<Scalar>::calcAll(const Scalar* processVariable, Scalar* controlVariable, size_t n, Scalar samplingTime) {
+    if(n == 0) {
+        return;
+    }
+    
+    PIDBankLanesOf<Scalar> lanes;
+    lanes.isEnabled = &isEnabled[0];
+    lanes.setpointReached = &setpointReached[0];
+    lanes.setpoint = &setpoint[0];
+    lanes.lastSetpoint = &lastSetpoint[0];
+    lanes.lastControlVariable = &lastControlVariable[0];
+    lanes.lastProcessVariable = &lastProcessVariable[0];
+    lanes.lastError = &lastError[0];
+    lanes.lastDifferentiator = &lastDifferentiator[0];
+    lanes.kp = &kp[0];
+    lanes.ki = &ki[0];
+    lanes.kd = &kd[0];
+    lanes.lowerOutputLimit = &lowerOutputLimit[0];
+    lanes.upperOutputLimit = &upperOutputLimit[0];
+    lanes.lowerIntegratorLimit = &lowerIntegratorLimit[0];
+    lanes.upperIntegratorLimit = &upperIntegratorLimit[0];
+    lanes.trackingGain = &trackingGain[0];
+    lanes.integrator = &integrator[0];
+    lanes.compensation = compensated ? &compensation[0] : 0;
+    lanes.velocity = algorithm == VELOCITY;
+    lanes.antiWindup = antiWindup;
+    
+    switch(isa) {
+#if defined(PID_HAVE_AVX512)
+        case ISA_AVX512:
+            pidBankKernelAVX512(lanes, processVariable, controlVariable, n, samplingTime);
+            break;
+#endif
+#if defined(PID_HAVE_AVX2)
+        case ISA_AVX2:
+            pidBankKernelAVX2(lanes, processVariable, controlVariable, n, samplingTime);
+            break;
+#endif
+#if defined(PID_HAVE_NEON)
+        case ISA_NEON:
+            pidBankKernelNEON(lanes, processVariable, controlVariable, n, samplingTime);
+            break;
+#endif
+        default:
+            pidBankKernelScalar(lanes, processVariable, controlVariable, n, samplingTime);
+            break;
+    }
+    if(!tuningLanes.empty()) {
+        stepAutoTuners(processVariable, controlVariable, n, samplingTime);
+    }
+}
+
+//------------------------------------------------------------------------------
+// stepAutoTuners
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : processVariable, controlVariable, n, samplingTime
+//
+// This function overwrites the held outputs of the auto-tuning lanes below n
+// with their relay outputs after the kernel has run, and hands finished lanes
+// over to their tuned gains like PIDController does. It only visits the
+// tuning lanes, so the rest of the bank pays nothing for them.
+//------------------------------------------------------------------------------
+
+template <class Scalar>
+void PIDBankOf<Scalar>::stepAutoTuners(const Scalar* processVariable, Scalar* controlVariable, size_t n, Scalar samplingTime) {
+    for(size_t i = tuningLanes.size(); i-- > 0;) {
+        size_t lane = tuningLanes[i];
+        if(lane >= n) {
+            continue;
+        }
+        RelayAutoTuner* tuner = tuners[i];
+        Scalar output = tuner->step(setpoint[lane], processVariable[lane], samplingTime);
+        if(output > upperOutputLimit[lane]) {
+            output = upperOutputLimit[lane];
+        }
+        if(output < lowerOutputLimit[lane]) {
+            output = lowerOutputLimit[lane];
+        }
+        controlVariable[lane] = output;
+        lastControlVariable[lane] = output;
+        lastProcessVariable[lane] = processVariable[lane];
+        lastSetpoint[lane] = setpoint[lane];
+        
+        RelayAutoTuner::State state = tuner->getState();
+        if(state == RelayAutoTuner::FINISHED || state == RelayAutoTuner::FAILED) {
+            double tunedKp, tunedKi, tunedKd;
+            if(tuner->getGains(tunedKp, tunedKi, tunedKd)) {
+                this->setGains(lane, tunedKp, tunedKi, tunedKd);
+            }
+            this->on(lane);
+            Scalar error = setpoint[lane] - processVariable[lane];
+            lastError[lane] = error;
+            lastDifferentiator[lane] = 0;
+            compensation[lane] = 0;
+            if(algorithm == POSITIONAL && std::fabs(ki[lane]) > 0) {
+                integrator[lane] = (output - kp[lane] * error) / ki[lane];
+            }
+            tuningLanes[i] = tuningLanes.back();
+            tuners[i] = tuners.back();
+            tuningLanes.pop_back();
+            tuners.pop_back();
+        }
+    }
+}
+
+template class PIDBankOf<double>;
+template class PIDBankOf<float>;
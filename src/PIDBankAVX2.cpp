@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "PIDBankKernel.h"
+#include <immintrin.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// AVX2 operations, four lanes per step. Built with -mavx2 only, and selected at
+// run time when the CPU supports it.
+//------------------------------------------------------------------------------
+
+namespace {
+
+struct PIDAVX2Ops {
+    typedef __m256d Vec;
+    typedef __m256d Mask;
+    static const size_t width = 4;
+    
+    static inline Vec load(const double* p) { return _mm256_loadu_pd(p); }
+    static inline void store(double* p, Vec v) { _mm256_storeu_pd(p, v); }
+    static inline Vec broadcast(double v) { return _mm256_set1_pd(v); }
+    static inline Vec add(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return _mm256_sub_pd(a, b); }
+    static inline Vec mul(Vec a, Vec b) { return _mm256_mul_pd(a, b); }
+    static inline Vec div(Vec a, Vec b) { return _mm256_div_pd(a, b); }
+    static inline Vec abs(Vec a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+    static inline Mask less(Vec a, Vec b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    static inline Mask greater(Vec a, Vec b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+    static inline Vec select(Mask m, Vec a, Vec b) { return _mm256_blendv_pd(b, a, m); }
+    static inline Mask selectMask(Mask m, Mask a, Mask b) { return _mm256_blendv_pd(b, a, m); }
+    
+    static inline Mask loadMask(const unsigned char* p) {
+        int32_t bytes;
+        std::memcpy(&bytes, p, sizeof(bytes));
+        __m256i wide = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(bytes));
+        return _mm256_castsi256_pd(_mm256_cmpgt_epi64(wide, _mm256_setzero_si256()));
+    }
+    
+    static inline void storeMask(unsigned char* p, Mask m) {
+        int bits = _mm256_movemask_pd(m);
+        for(size_t j = 0; j < width; j++) {
+            p[j] = (bits >> j) & 1;
+        }
+    }
+};
+
+// Same operations on floats, eight lanes per step.
+struct PIDAVX2FloatOps {
+    typedef __m256 Vec;
+    typedef __m256 Mask;
+    static const size_t width = 8;
+    
+    static inline Vec load(const float* p) { return _mm256_loadu_ps(p); }
+    static inline void store(float* p, Vec v) { _mm256_storeu_ps(p, v); }
+    static inline Vec broadcast(float v) { return _mm256_set1_ps(v); }
+    static inline Vec add(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return _mm256_sub_ps(a, b); }
+    static inline Vec mul(Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+    static inline Vec div(Vec a, Vec b) { return _mm256_div_ps(a, b); }
+    static inline Vec abs(Vec a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static inline Mask less(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static inline Mask greater(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static inline Vec select(Mask m, Vec a, Vec b) { return _mm256_blendv_ps(b, a, m); }
+    static inline Mask selectMask(Mask m, Mask a, Mask b) { return _mm256_blendv_ps(b, a, m); }
+    
+    static inline Mask loadMask(const unsigned char* p) {
+        int64_t bytes;
+        std::memcpy(&bytes, p, sizeof(bytes));
+        __m256i wide = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(bytes));
+        return _mm256_castsi256_ps(_mm256_cmpgt_epi32(wide, _mm256_setzero_si256()));
+    }
+    
+    static inline void storeMask(unsigned char* p, Mask m) {
+        int bits = _mm256_movemask_ps(m);
+        for(size_t j = 0; j < width; j++) {
+            p[j] = (bits >> j) & 1;
+        }
+    }
+};
+
+} // namespace
+
+//------------------------------------------------------------------------------
+// pidBankKernelAVX2
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : lanes, processVariable, controlVariable, n, samplingTime
+//
+// AVX2 calcAll() kernels for PIDBank and PIDBankFloat. The lanes left over
+// after the last full vector are stepped with the scalar operations.
+//------------------------------------------------------------------------------
+
+void pidBankKernelAVX2(const PIDBankLanes& lanes, const double* processVariable, double* controlVariable, size_t n, double samplingTime) {
+    size_t i = pidBankKernelDispatch<PIDAVX2Ops>(lanes, processVariable, controlVariable, 0, n, samplingTime);
+    pidBankKernelDispatch<PIDScalarOps>(lanes, processVariable, controlVariable, i, n, samplingTime);
+}
+
+void pidBankKernelAVX2(const PIDBankFloatLanes& lanes, const float* processVariable, float* controlVariable, size_t n, float samplingTime) {
+    size_t i = pidBankKernelDispatch<PIDAVX2FloatOps>(lanes, processVariable, controlVariable, 0, n, samplingTime);
+    pidBankKernelDispatch<PIDScalarFloatOps>(lanes, processVariable, controlVariable, i, n, samplingTime);
+}
@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "PIDBankKernel.h"
+#include <immintrin.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// AVX-512F operations, eight lanes per step. Built with -mavx512f only, and
+// selected at run time when the CPU supports it.
+//------------------------------------------------------------------------------
+
+namespace {
+
+struct PIDAVX512Ops {
+    typedef __m512d Vec;
+    typedef __mmask8 Mask;
+    static const size_t width = 8;
+    
+    static inline Vec load(const double* p) { return _mm512_loadu_pd(p); }
+    static inline void store(double* p, Vec v) { _mm512_storeu_pd(p, v); }
+    static inline Vec broadcast(double v) { return _mm512_set1_pd(v); }
+    static inline Vec add(Vec a, Vec b) { return _mm512_add_pd(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return _mm512_sub_pd(a, b); }
+    static inline Vec mul(Vec a, Vec b) { return _mm512_mul_pd(a, b); }
+    static inline Vec div(Vec a, Vec b) { return _mm512_div_pd(a, b); }
+    // Clears the sign bit, like the AVX2 ops. The & is GCC's vector
+    // operator: _mm512_abs_pd and _mm512_andnot_si512 pass an undefined
+    // operand that trips -Wmaybe-uninitialized in GCC's headers.
+    static inline Vec abs(Vec a) {
+        return _mm512_castsi512_pd(_mm512_castpd_si512(a) & _mm512_set1_epi64(0x7FFFFFFFFFFFFFFFLL));
+    }
+    static inline Mask less(Vec a, Vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+    static inline Mask greater(Vec a, Vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+    static inline Vec select(Mask m, Vec a, Vec b) { return _mm512_mask_blend_pd(m, b, a); }
+    static inline Mask selectMask(Mask m, Mask a, Mask b) { return (Mask)((m & a) | (~m & b)); }
+    
+    static inline Mask loadMask(const unsigned char* p) {
+        int64_t bytes;
+        std::memcpy(&bytes, p, sizeof(bytes));
+        // The zero-masking form, whose pass-through operand is defined.
+        __m512i wide = _mm512_maskz_cvtepu8_epi64((__mmask8)-1, _mm_cvtsi64_si128(bytes));
+        return _mm512_test_epi64_mask(wide, wide);
+    }
+    
+    static inline void storeMask(unsigned char* p, Mask m) {
+        for(size_t j = 0; j < width; j++) {
+            p[j] = (m >> j) & 1;
+        }
+    }
+};
+
+// Same operations on floats, sixteen lanes per step.
+struct PIDAVX512FloatOps {
+    typedef __m512 Vec;
+    typedef __mmask16 Mask;
+    static const size_t width = 16;
+    
+    static inline Vec load(const float* p) { return _mm512_loadu_ps(p); }
+    static inline void store(float* p, Vec v) { _mm512_storeu_ps(p, v); }
+    static inline Vec broadcast(float v) { return _mm512_set1_ps(v); }
+    static inline Vec add(Vec a, Vec b) { return _mm512_add_ps(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return _mm512_sub_ps(a, b); }
+    static inline Vec mul(Vec a, Vec b) { return _mm512_mul_ps(a, b); }
+    static inline Vec div(Vec a, Vec b) { return _mm512_div_ps(a, b); }
+    static inline Vec abs(Vec a) {
+        return _mm512_castsi512_ps(_mm512_castps_si512(a) & _mm512_set1_epi32(0x7FFFFFFF));
+    }
+    static inline Mask less(Vec a, Vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    static inline Mask greater(Vec a, Vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+    static inline Vec select(Mask m, Vec a, Vec b) { return _mm512_mask_blend_ps(m, b, a); }
+    static inline Mask selectMask(Mask m, Mask a, Mask b) { return (Mask)((m & a) | (~m & b)); }
+    
+    static inline Mask loadMask(const unsigned char* p) {
+        __m512i wide = _mm512_maskz_cvtepu8_epi32((__mmask16)-1, _mm_loadu_si128((const __m128i*)p));
+        return _mm512_test_epi32_mask(wide, wide);
+    }
+    
+    static inline void storeMask(unsigned char* p, Mask m) {
+        for(size_t j = 0; j < width; j++) {
+            p[j] = (m >> j) & 1;
+        }
+    }
+};
+
+} // namespace
+
+//------------------------------------------------------------------------------
+// pidBankKernelAVX512
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : lanes, processVariable, controlVariable, n, samplingTime
+//
+// AVX-512F calcAll() kernels for PIDBank and PIDBankFloat. The lanes left
+// over after the last full vector are stepped with the scalar operations.
+//------------------------------------------------------------------------------
+
+void pidBankKernelAVX512(const PIDBankLanes& lanes, const double* processVariable, double* controlVariable, size_t n, double samplingTime) {
+    size_t i = pidBankKernelDispatch<PIDAVX512Ops>(lanes, processVariable, controlVariable, 0, n, samplingTime);
+    pidBankKernelDispatch<PIDScalarOps>(lanes, processVariable, controlVariable, i, n, samplingTime);
+}
+
+void pidBankKernelAVX512(const PIDBankFloatLanes& lanes, const float* processVariable, float* controlVariable, size_t n, float samplingTime) {
+    size_t i = pidBankKernelDispatch<PIDAVX512FloatOps>(lanes, processVariable, controlVariable, 0, n, samplingTime);
+    pidBankKernelDispatch<PIDScalarFloatOps>(lanes, processVariable, controlVariable, i, n, samplingTime);
+}
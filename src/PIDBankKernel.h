@@ -0,0 +1,296 @@
+/* 
+ * File:   PIDBankKernel.h
+ * Author: User
+ *
+ * Created on October 14, 2026
+ */
+
+#ifndef PIDBANKKERNEL_H
+#define PIDBANKKERNEL_H
+
+#include "PIDBank.h"
+#include <cstddef>
+#include <cstring>
+#include <cmath>
+
+// Raw views of the PIDBank (double) or PIDBankFloat (float) arrays handed to
+// the calcAll() kernels. Limits are stored branch-free: an unlimited bound is
+// -inf/+inf instead of the lowerLimit == upperLimit convention used by
+// PIDController. compensation holds the Kahan summation error of each lane's
+// running sum, or is null for plain summation.
+template <class Scalar>
+struct PIDBankLanesOf {
+    unsigned char* isEnabled;
+    unsigned char* setpointReached;
+    const Scalar* setpoint;
+    Scalar* lastSetpoint;
+    Scalar* lastControlVariable;
+    Scalar* lastProcessVariable;
+    Scalar* lastError;
+    Scalar* lastDifferentiator;
+    const Scalar* kp;
+    const Scalar* ki;
+    const Scalar* kd;
+    const Scalar* lowerOutputLimit;
+    const Scalar* upperOutputLimit;
+    const Scalar* lowerIntegratorLimit;
+    const Scalar* upperIntegratorLimit;
+    const Scalar* trackingGain;
+    Scalar* integrator;
+    Scalar* compensation;
+    bool velocity;
+    PIDBank::AntiWindup antiWindup;
+};
+
+typedef PIDBankLanesOf<double> PIDBankLanes;
+typedef PIDBankLanesOf<float> PIDBankFloatLanes;
+
+typedef void (*PIDBankKernelFunction)(const PIDBankLanes& lanes, const double* processVariable, double* controlVariable, size_t n, double samplingTime);
+
+void pidBankKernelScalar(const PIDBankLanes& lanes, const double* processVariable, double* controlVariable, size_t n, double samplingTime);
+void pidBankKernelScalar(const PIDBankFloatLanes& lanes, const float* processVariable, float* controlVariable, size_t n, float samplingTime);
+#if defined(PID_HAVE_AVX2)
+void pidBankKernelAVX2(const PIDBankLanes& lanes, const double* processVariable, double* controlVariable, size_t n, double samplingTime);
+void pidBankKernelAVX2(const PIDBankFloatLanes& lanes, const float* processVariable, float* controlVariable, size_t n, float samplingTime);
+#endif
+#if defined(PID_HAVE_AVX512)
+void pidBankKernelAVX512(const PIDBankLanes& lanes, const double* processVariable, double* controlVariable, size_t n, double samplingTime);
+void pidBankKernelAVX512(const PIDBankFloatLanes& lanes, const float* processVariable, float* controlVariable, size_t n, float samplingTime);
+#endif
+#if defined(PID_HAVE_NEON)
+void pidBankKernelNEON(const PIDBankLanes& lanes, const double* processVariable, double* controlVariable, size_t n, double samplingTime);
+void pidBankKernelNEON(const PIDBankFloatLanes& lanes, const float* processVariable, float* controlVariable, size_t n, float samplingTime);
+#endif
+
+// Everything below is compiled into each kernel translation unit with that
+// unit's instruction set flags, so it has internal linkage: a weak copy built
+// with -mavx2 or -mavx512f must never replace the one the scalar kernel uses.
+namespace {
+
+// One lane at a time. Every vector Ops type below must produce bit-identical
+// results to this one, so each operation maps to exactly one IEEE operation
+// and the kernel translation units are built with -ffp-contract=off.
+template <class Scalar>
+struct PIDScalarOpsOf {
+    typedef Scalar Vec;
+    typedef bool Mask;
+    static const size_t width = 1;
+    
+    static inline Vec load(const Scalar* p) { return *p; }
+    static inline void store(Scalar* p, Vec v) { *p = v; }
+    static inline Vec broadcast(Scalar v) { return v; }
+    static inline Vec add(Vec a, Vec b) { return a + b; }
+    static inline Vec sub(Vec a, Vec b) { return a - b; }
+    static inline Vec mul(Vec a, Vec b) { return a * b; }
+    static inline Vec div(Vec a, Vec b) { return a / b; }
+    static inline Vec abs(Vec a) { return std::fabs(a); }
+    static inline Mask less(Vec a, Vec b) { return a < b; }
+    static inline Mask greater(Vec a, Vec b) { return a > b; }
+    static inline Vec select(Mask m, Vec a, Vec b) { return m ? a : b; }
+    static inline Mask selectMask(Mask m, Mask a, Mask b) { return m ? a : b; }
+    static inline Mask loadMask(const unsigned char* p) { return *p != 0; }
+    static inline void storeMask(unsigned char* p, Mask m) { *p = m; }
+};
+
+typedef PIDScalarOpsOf<double> PIDScalarOps;
+typedef PIDScalarOpsOf<float> PIDScalarFloatOps;
+
+// Mask logic built from selectMask, so the Ops types need no extra operations.
+template <class Ops>
+inline typename Ops::Mask pidBankAnd(typename Ops::Mask a, typename Ops::Mask b) {
+    return Ops::selectMask(a, b, a);
+}
+
+template <class Ops>
+inline typename Ops::Mask pidBankOr(typename Ops::Mask a, typename Ops::Mask b) {
+    return Ops::selectMask(a, a, b);
+}
+
+// Branch-free limiter for limits stored as -inf/+inf when unlimited.
+template <class Ops>
+inline typename Ops::Vec pidBankClamp(typename Ops::Vec value, typename Ops::Vec lowerLimit, typename Ops::Vec upperLimit) {
+    // Same precedence as PIDController::limiter: the lower limit wins.
+    typename Ops::Vec capped = Ops::select(Ops::greater(value, upperLimit), upperLimit, value);
+    return Ops::select(Ops::less(value, lowerLimit), lowerLimit, capped);
+}
+
+//------------------------------------------------------------------------------
+// pidBankKernel
+//------------------------------------------------------------------------------
+//
+// Return Value : size_t
+// Parameters   : lanes, processVariable, controlVariable, begin, n,
+//                samplingTime
+//
+// This function steps lanes [begin, n) Ops::width lanes at a time with the
+// math of PIDController::calc(processVariable, samplingTime), written without
+// branches so that it vectorizes. Velocity selects the velocity form of the
+// algorithm and AntiWindup the anti-windup mode of the positional form, with
+// every mode computed exactly as PIDController::step() does. Compensated
+// accumulates the integrator, or the output of the velocity form, with Kahan
+// summation, for float lanes whose running sums outgrow their increments.
+// pidBankKernelDispatch() picks the instantiation for lanes.velocity,
+// lanes.antiWindup and lanes.compensation. It returns the first lane it did
+// not step, which is n when n - begin is a multiple of Ops::width.
+//------------------------------------------------------------------------------
+
+template <class Ops, bool Velocity, PIDBank::AntiWindup AntiWindup, bool Compensated, class Scalar>
+inline size_t pidBankKernel(const PIDBankLanesOf<Scalar>& lanes, const Scalar* processVariable, Scalar* controlVariable, size_t begin, size_t n, Scalar samplingTime) {
+    typedef typename Ops::Vec Vec;
+    typedef typename Ops::Mask Mask;
+    
+    const Vec dt = Ops::broadcast(samplingTime);
+    const Vec settleBand = Ops::broadcast(0.5);
+    const Vec zero = Ops::broadcast(0);
+    const Vec one = Ops::broadcast(1);
+    size_t i = begin;
+    for(; i + Ops::width <= n; i += Ops::width) {
+        Mask enabled = Ops::loadMask(lanes.isEnabled + i);
+        Vec pv = Ops::load(processVariable + i);
+        Vec setpoint = Ops::load(lanes.setpoint + i);
+        Vec lastSetpoint = Ops::load(lanes.lastSetpoint + i);
+        Vec lastControlVariable = Ops::load(lanes.lastControlVariable + i);
+        Vec lastProcessVariable = Ops::load(lanes.lastProcessVariable + i);
+        Vec lastError = Ops::load(lanes.lastError + i);
+        Vec lastDifferentiator = Ops::load(lanes.lastDifferentiator + i);
+        Vec integrator = Ops::load(lanes.integrator + i);
+        Vec lower = Ops::load(lanes.lowerOutputLimit + i);
+        Vec upper = Ops::load(lanes.upperOutputLimit + i);
+        
+        Vec error = Ops::sub(setpoint, pv);
+        Vec diffProcessVariable = Ops::div(Ops::sub(pv, lastProcessVariable), dt);
+        Mask reached = Ops::less(Ops::abs(diffProcessVariable), settleBand);
+        
+        Vec differentiator = Ops::div(Ops::sub(setpoint, lastSetpoint), dt);
+        Vec nextIntegrator = integrator;
+        Vec compensation = zero;
+        Vec nextCompensation = zero;
+        Vec sum = zero;
+        Vec output;
+        if(Velocity) {
+            Vec increment = Ops::sub(Ops::add(Ops::mul(Ops::load(lanes.kp + i), Ops::sub(error, lastError)),
+                                              Ops::mul(Ops::load(lanes.ki + i), Ops::mul(error, dt))),
+                                     Ops::mul(Ops::load(lanes.kd + i), Ops::sub(differentiator, lastDifferentiator)));
+            if(Compensated) {
+                compensation = Ops::load(lanes.compensation + i);
+                Vec corrected = Ops::sub(increment, compensation);
+                sum = Ops::add(lastControlVariable, corrected);
+                nextCompensation = Ops::sub(Ops::sub(sum, lastControlVariable), corrected);
+                output = sum;
+            }
+            else {
+                output = Ops::add(lastControlVariable, increment);
+            }
+        }
+        else {
+            Vec kp = Ops::load(lanes.kp + i);
+            Vec ki = Ops::load(lanes.ki + i);
+            Vec kd = Ops::load(lanes.kd + i);
+            Mask integrating = Ops::greater(Ops::abs(ki), zero);
+            if(Compensated) {
+                compensation = Ops::load(lanes.compensation + i);
+                Vec corrected = Ops::sub(Ops::mul(error, dt), compensation);
+                sum = Ops::add(integrator, corrected);
+                nextCompensation = Ops::sub(Ops::sub(sum, integrator), corrected);
+                nextIntegrator = sum;
+            }
+            else {
+                nextIntegrator = Ops::add(integrator, Ops::mul(error, dt));
+            }
+            if(AntiWindup == PIDBank::OUTPUT_CLAMP) {
+                nextIntegrator = pidBankClamp<Ops>(nextIntegrator, lower, upper);
+            }
+            else if(AntiWindup == PIDBank::INTEGRATOR_CLAMP) {
+                Vec lowerIntegrator = Ops::load(lanes.lowerIntegratorLimit + i);
+                Vec upperIntegrator = Ops::load(lanes.upperIntegratorLimit + i);
+                Vec term = Ops::mul(ki, nextIntegrator);
+                Mask outside = pidBankOr<Ops>(Ops::less(term, lowerIntegrator), Ops::greater(term, upperIntegrator));
+                Vec clamped = Ops::div(pidBankClamp<Ops>(term, lowerIntegrator, upperIntegrator), ki);
+                nextIntegrator = Ops::select(pidBankAnd<Ops>(outside, integrating), clamped, nextIntegrator);
+            }
+            output = Ops::sub(Ops::add(Ops::mul(kp, error), Ops::mul(ki, nextIntegrator)), Ops::mul(kd, differentiator));
+            
+            if(AntiWindup == PIDBank::CONDITIONAL_INTEGRATION) {
+                Vec limited = pidBankClamp<Ops>(output, lower, upper);
+                Vec drive = Ops::mul(ki, error);
+                Mask windingUp = pidBankOr<Ops>(pidBankAnd<Ops>(Ops::greater(output, limited), Ops::greater(drive, zero)),
+                                                pidBankAnd<Ops>(Ops::less(output, limited), Ops::less(drive, zero)));
+                Vec held = Ops::sub(Ops::add(Ops::mul(kp, error), Ops::mul(ki, integrator)), Ops::mul(kd, differentiator));
+                nextIntegrator = Ops::select(windingUp, integrator, nextIntegrator);
+                output = Ops::select(windingUp, held, output);
+            }
+            else if(AntiWindup == PIDBank::BACK_CALCULATION) {
+                Vec limited = pidBankClamp<Ops>(output, lower, upper);
+                Vec tracking = Ops::load(lanes.trackingGain + i);
+                Vec integralRate = Ops::select(Ops::greater(Ops::abs(kp), zero), Ops::abs(Ops::div(ki, kp)), Ops::div(one, dt));
+                tracking = Ops::select(Ops::greater(tracking, zero), tracking, integralRate);
+                Vec gain = Ops::mul(tracking, dt);
+                gain = Ops::select(Ops::greater(gain, one), one, gain);
+                Vec tracked = Ops::add(nextIntegrator, Ops::div(Ops::mul(gain, Ops::sub(limited, output)), ki));
+                nextIntegrator = Ops::select(integrating, tracked, nextIntegrator);
+            }
+        }
+        output = pidBankClamp<Ops>(output, lower, upper);
+        if(Compensated) {
+            // Anti-windup or the output limits overrode the running sum, so
+            // its rounding error no longer applies.
+            Vec result = Velocity ? output : nextIntegrator;
+            Mask overridden = pidBankOr<Ops>(Ops::less(result, sum), Ops::greater(result, sum));
+            nextCompensation = Ops::select(overridden, zero, nextCompensation);
+        }
+        
+        // Disabled lanes hold their output and keep their state untouched.
+        output = Ops::select(enabled, output, lastControlVariable);
+        Ops::store(controlVariable + i, output);
+        Ops::store(lanes.lastControlVariable + i, output);
+        if(!Velocity) {
+            Ops::store(lanes.integrator + i, Ops::select(enabled, nextIntegrator, integrator));
+        }
+        if(Compensated) {
+            Ops::store(lanes.compensation + i, Ops::select(enabled, nextCompensation, compensation));
+        }
+        Ops::store(lanes.lastError + i, Ops::select(enabled, error, lastError));
+        Ops::store(lanes.lastDifferentiator + i, Ops::select(enabled, differentiator, lastDifferentiator));
+        Ops::store(lanes.lastSetpoint + i, Ops::select(enabled, setpoint, lastSetpoint));
+        Ops::store(lanes.lastProcessVariable + i, Ops::select(enabled, pv, lastProcessVariable));
+        Ops::storeMask(lanes.setpointReached + i, Ops::selectMask(enabled, reached, Ops::loadMask(lanes.setpointReached + i)));
+    }
+    return i;
+}
+
+template <class Ops, bool Compensated, class Scalar>
+inline size_t pidBankKernelDispatchMode(const PIDBankLanesOf<Scalar>& lanes, const Scalar* processVariable, Scalar* controlVariable, size_t begin, size_t n, Scalar samplingTime) {
+    if(lanes.velocity) {
+        return pidBankKernel<Ops, true, PIDBank::OUTPUT_CLAMP, Compensated>(lanes, processVariable, controlVariable, begin, n, samplingTime);
+    }
+    switch(lanes.antiWindup) {
+        case PIDBank::CONDITIONAL_INTEGRATION:
+            return pidBankKernel<Ops, false, PIDBank::CONDITIONAL_INTEGRATION, Compensated>(lanes, processVariable, controlVariable, begin, n, samplingTime);
+        case PIDBank::BACK_CALCULATION:
+            return pidBankKernel<Ops, false, PIDBank::BACK_CALCULATION, Compensated>(lanes, processVariable, controlVariable, begin, n, samplingTime);
+        case PIDBank::INTEGRATOR_CLAMP:
+            return pidBankKernel<Ops, false, PIDBank::INTEGRATOR_CLAMP, Compensated>(lanes, processVariable, controlVariable, begin, n, samplingTime);
+        default:
+            return pidBankKernel<Ops, false, PIDBank::OUTPUT_CLAMP, Compensated>(lanes, processVariable, controlVariable, begin, n, samplingTime);
+    }
+}
+
+// The double bank never compensates, so only the float kernels instantiate
+// the Kahan variants.
+template <class Ops>
+inline size_t pidBankKernelDispatch(const PIDBankLanes& lanes, const double* processVariable, double* controlVariable, size_t begin, size_t n, double samplingTime) {
+    return pidBankKernelDispatchMode<Ops, false>(lanes, processVariable, controlVariable, begin, n, samplingTime);
+}
+
+template <class Ops>
+inline size_t pidBankKernelDispatch(const PIDBankFloatLanes& lanes, const float* processVariable, float* controlVariable, size_t begin, size_t n, float samplingTime) {
+    if(lanes.compensation) {
+        return pidBankKernelDispatchMode<Ops, true>(lanes, processVariable, controlVariable, begin, n, samplingTime);
+    }
+    return pidBankKernelDispatchMode<Ops, false>(lanes, processVariable, controlVariable, begin, n, samplingTime);
+}
+
+} // namespace
+
+#endif  /* PIDBANKKERNEL_H */
+
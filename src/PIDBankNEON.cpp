@@ -0,0 +1,98 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "PIDBankKernel.h"
+#include <arm_neon.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// AArch64 NEON operations, two lanes per step. Advanced SIMD is part of the
+// AArch64 baseline, so this kernel is always selected on those CPUs.
+//------------------------------------------------------------------------------
+
+namespace {
+
+struct PIDNEONOps {
+    typedef float64x2_t Vec;
+    typedef uint64x2_t Mask;
+    static const size_t width = 2;
+    
+    static inline Vec load(const double* p) { return vld1q_f64(p); }
+    static inline void store(double* p, Vec v) { vst1q_f64(p, v); }
+    static inline Vec broadcast(double v) { return vdupq_n_f64(v); }
+    static inline Vec add(Vec a, Vec b) { return vaddq_f64(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return vsubq_f64(a, b); }
+    static inline Vec mul(Vec a, Vec b) { return vmulq_f64(a, b); }
+    static inline Vec div(Vec a, Vec b) { return vdivq_f64(a, b); }
+    static inline Vec abs(Vec a) { return vabsq_f64(a); }
+    static inline Mask less(Vec a, Vec b) { return vcltq_f64(a, b); }
+    static inline Mask greater(Vec a, Vec b) { return vcgtq_f64(a, b); }
+    static inline Vec select(Mask m, Vec a, Vec b) { return vbslq_f64(m, a, b); }
+    static inline Mask selectMask(Mask m, Mask a, Mask b) { return vbslq_u64(m, a, b); }
+    
+    static inline Mask loadMask(const unsigned char* p) {
+        uint64_t bytes[2] = { p[0], p[1] };
+        return vcgtq_u64(vld1q_u64(bytes), vdupq_n_u64(0));
+    }
+    
+    static inline void storeMask(unsigned char* p, Mask m) {
+        p[0] = vgetq_lane_u64(m, 0) & 1;
+        p[1] = vgetq_lane_u64(m, 1) & 1;
+    }
+};
+
+// Same operations on floats, four lanes per step.
+struct PIDNEONFloatOps {
+    typedef float32x4_t Vec;
+    typedef uint32x4_t Mask;
+    static const size_t width = 4;
+    
+    static inline Vec load(const float* p) { return vld1q_f32(p); }
+    static inline void store(float* p, Vec v) { vst1q_f32(p, v); }
+    static inline Vec broadcast(float v) { return vdupq_n_f32(v); }
+    static inline Vec add(Vec a, Vec b) { return vaddq_f32(a, b); }
+    static inline Vec sub(Vec a, Vec b) { return vsubq_f32(a, b); }
+    static inline Vec mul(Vec a, Vec b) { return vmulq_f32(a, b); }
+    static inline Vec div(Vec a, Vec b) { return vdivq_f32(a, b); }
+    static inline Vec abs(Vec a) { return vabsq_f32(a); }
+    static inline Mask less(Vec a, Vec b) { return vcltq_f32(a, b); }
+    static inline Mask greater(Vec a, Vec b) { return vcgtq_f32(a, b); }
+    static inline Vec select(Mask m, Vec a, Vec b) { return vbslq_f32(m, a, b); }
+    static inline Mask selectMask(Mask m, Mask a, Mask b) { return vbslq_u32(m, a, b); }
+    
+    static inline Mask loadMask(const unsigned char* p) {
+        uint32_t bytes[4] = { p[0], p[1], p[2], p[3] };
+        return vcgtq_u32(vld1q_u32(bytes), vdupq_n_u32(0));
+    }
+    
+    static inline void storeMask(unsigned char* p, Mask m) {
+        p[0] = vgetq_lane_u32(m, 0) & 1;
+        p[1] = vgetq_lane_u32(m, 1) & 1;
+        p[2] = vgetq_lane_u32(m, 2) & 1;
+        p[3] = vgetq_lane_u32(m, 3) & 1;
+    }
+};
+
+} // namespace
+
+//------------------------------------------------------------------------------
+// pidBankKernelNEON
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : lanes, processVariable, controlVariable, n, samplingTime
+//
+// NEON calcAll() kernels for PIDBank and PIDBankFloat. The lanes left over
+// after the last full vector are stepped with the scalar operations.
+//------------------------------------------------------------------------------
+
+void pidBankKernelNEON(const PIDBankLanes& lanes, const double* processVariable, double* controlVariable, size_t n, double samplingTime) {
+    size_t i = pidBankKernelDispatch<PIDNEONOps>(lanes, processVariable, controlVariable, 0, n, samplingTime);
+    pidBankKernelDispatch<PIDScalarOps>(lanes, processVariable, controlVariable, i, n, samplingTime);
+}
+
+void pidBankKernelNEON(const PIDBankFloatLanes& lanes, const float* processVariable, float* controlVariable, size_t n, float samplingTime) {
+    size_t i = pidBankKernelDispatch<PIDNEONFloatOps>(lanes, processVariable, controlVariable, 0, n, samplingTime);
+    pidBankKernelDispatch<PIDScalarFloatOps>(lanes, processVariable, controlVariable, i, n, samplingTime);
+}
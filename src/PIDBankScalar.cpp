@@ -0,0 +1,25 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "PIDBankKernel.h"
+
+//------------------------------------------------------------------------------
+// pidBankKernelScalar
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : lanes, processVariable, controlVariable, n, samplingTime
+//
+// Portable calcAll() kernel, used when no vector unit is available and as the
+// reference the vector kernels must match bit for bit. The float overload
+// steps PIDBankFloat.
+//------------------------------------------------------------------------------
+
+void pidBankKernelScalar(const PIDBankLanes& lanes, const double* processVariable, double* controlVariable, size_t n, double samplingTime) {
+    pidBankKernelDispatch<PIDScalarOps>(lanes, processVariable, controlVariable, 0, n, samplingTime);
+}
+
+void pidBankKernelScalar(const PIDBankFloatLanes& lanes, const float* processVariable, float* controlVariable, size_t n, float samplingTime) {
+    pidBankKernelDispatch<PIDScalarFloatOps>(lanes, processVariable, controlVariable, 0, n, samplingTime);
+}
@@ -3,6 +3,13 @@
 //------------------------------------------------------------------------------
 
 #include "PIDController.h"
+#include "PIDStep.h"
+#include "PIDParameterChannel.h"
+#include "PIDInstrumentation.h"
+#include "StepResponseAnalyzer.h"
+#include "GainSchedule.h"
+#include "RelayAutoTuner.h"
+#include "PIDClock.h"
 
 //------------------------------------------------------------------------------
 // Constructors
@@ -10,57 +17,34 @@
 
 // Default constructor
 PIDController::PIDController() {
-    this->setGains(0, 0, 0);
-    this->setInputLimits(-1, -1);
-    this->setOutputLimits(-1, -1);
-    lastControlVariable = 0;
-    lastProcessVariable = 0;
-    this->reset();
-    this->off();
+    this->init(0, 0, 0, -1, -1, -1, -1, 0);
 }
 
 // Just gains, no limits
 PIDController::PIDController(double kp, double ki, double kd) {
-    this->setGains(kp, ki, kd);
-    this->setInputLimits(-1, -1);
-    this->setOutputLimits(-1, -1);
-    lastControlVariable = 0;
-    lastProcessVariable = 0;
-    this->reset();
-    this->off();
+    this->init(kp, ki, kd, -1, -1, -1, -1, 0);
+}
+
+// Gains and a fixed sampling period, no limits
+PIDController::PIDController(double kp, double ki, double kd, double samplingPeriod) {
+    this->init(kp, ki, kd, -1, -1, -1, -1, samplingPeriod);
 }
+
 // Gains and output limits
 PIDController::PIDController(double kp, double ki, double kd, double lowerOutputLimit, double upperOutputLimit) {
-    this->setGains(kp, ki, kd);
-    this->setInputLimits(-1, -1);
-    this->setOutputLimits(lowerOutputLimit, upperOutputLimit);
-    lastControlVariable = 0;
-    lastProcessVariable = 0;
-    this->reset();
-    this->off();
+    this->init(kp, ki, kd, -1, -1, lowerOutputLimit, upperOutputLimit, 0);
 }
 
 // All gains and limits
 PIDController::PIDController(double kp, double ki, double kd, double lowerInputLimit, double upperInputLimit, double lowerOutputLimit, double upperOutputLimit) {
-    this->setGains(kp, ki, kd);
-    this->setInputLimits(lowerInputLimit, upperInputLimit);
-    this->setOutputLimits(lowerOutputLimit, upperOutputLimit);
-    lastControlVariable = 0;
-    lastProcessVariable = 0;
-    this->reset();
-    this->off();
+    this->init(kp, ki, kd, lowerInputLimit, upperInputLimit, lowerOutputLimit, upperOutputLimit, 0);
 }
 
-// Copy constructor
-PIDController::PIDController(const PIDController& orig) {
-    this->setGains(orig.kp, orig.ki, orig.kd);
-    this->setInputLimits(orig.lowerInputLimit, orig.upperInputLimit);
-    this->setOutputLimits(orig.lowerOutputLimit, orig.lowerInputLimit);
-    lastControlVariable = 0;
-    lastProcessVariable = 0;
-    this->reset();
-    this->off();
-}
+// Copy constructor, an exact copy of the running controller
+PIDController::PIDController(const PIDController& orig) = default;
+
+// Copy assignment, likewise exact
+PIDController& PIDController::operator=(const PIDController& orig) = default;
 
 // Destructor
 PIDController::~PIDController() {
@@ -71,19 +55,76 @@ PIDController::~PIDController() {
 //------------------------------------------------------------------------------
 
 double PIDController::getSetpoint() {
-    return setpoint;
+    return state.setpoint;
 }
 
 double PIDController::getKp() {
-    return kp;
+    return state.kp;
 }
 
 double PIDController::getKi() {
-    return ki;
+    return state.ki;
 }
 
 double PIDController::getKd() {
-    return kd;
+    return state.kd;
+}
+
+double PIDController::getSamplingPeriod() {
+    return state.samplingPeriod;
+}
+
+PIDController::Algorithm PIDController::getAlgorithm() {
+    return (Algorithm)state.algorithm;
+}
+
+PIDController::DerivativeMode PIDController::getDerivativeMode() {
+    return (DerivativeMode)state.derivativeMode;
+}
+
+// Time constant of the derivative filter in seconds, 0 when unfiltered
+double PIDController::getDerivativeFilter() {
+    return state.derivativeTimeConstant;
+}
+
+PIDController::AntiWindup PIDController::getAntiWindup() {
+    return (AntiWindup)state.antiWindup;
+}
+
+// Change of output made by the last calc(), after output limiting
+double PIDController::getOutputIncrement() {
+    return state.outputIncrement;
+}
+
+//------------------------------------------------------------------------------
+// hasOutputChanged
+//------------------------------------------------------------------------------
+//
+// Return Value : bool
+// Parameters   : None
+//
+// This function returns true if the last calc() emitted a new output, and
+// false if it held the previous one under setEventThresholds(). Without
+// thresholds every calc() emits.
+//------------------------------------------------------------------------------
+
+bool PIDController::hasOutputChanged() {
+    return outputChanged;
+}
+
+//------------------------------------------------------------------------------
+// getState
+//------------------------------------------------------------------------------
+//
+// Return Value : PIDState
+// Parameters   : None
+//
+// This function returns a snapshot of the configuration and internal state,
+// from which setState() resumes exactly where this controller is.
+//------------------------------------------------------------------------------
+
+PIDState PIDController::getState() {
+    return state;
 }
 
 //------------------------------------------------------------------------------
@@ -102,10 +143,13 @@ double PIDController::getKd() {
 //------------------------------------------------------------------------------
 
 void PIDController::targetSetpoint(double setpoint) {
-    setpoint = limiter(setpoint, lowerInputLimit, upperInputLimit);
-    if(setpoint != this->setpoint) {
-        this->setpoint = setpoint;
-        sample_timer.start();
+    setpoint = pidLimit(setpoint, state.lowerInputLimit, state.upperInputLimit);
+    if(setpoint != state.setpoint) {
+        state.setpoint = setpoint;
+        if(state.samplingPeriod <= 0) {
+            lastSampleTime = clock();
+            skippedSamples = 0;
+        }
     }
 }
 
@@ -121,9 +165,9 @@ void PIDController::targetSetpoint(double setpoint) {
 //------------------------------------------------------------------------------
 
 void PIDController::setGains(double kp, double ki, double kd) {
-    this->kp = kp;
-    this->ki = ki;
-    this->kd = kd;
+    state.kp = kp;
+    state.ki = ki;
+    state.kd = kd;
 }
 
 //------------------------------------------------------------------------------
@@ -138,8 +182,8 @@ void PIDController::setGains(double kp, double ki, double kd) {
 //------------------------------------------------------------------------------
 
 void PIDController::setInputLimits(double lowerInputLimit, double upperInputLimit) {
-    this->lowerInputLimit = lowerInputLimit;
-    this->upperInputLimit = upperInputLimit;
+    state.lowerInputLimit = lowerInputLimit;
+    state.upperInputLimit = upperInputLimit;
 }
 
 //------------------------------------------------------------------------------
@@ -154,8 +198,327 @@ void PIDController::setInputLimits(double lowerInputLimit, double upperInputLimi
 //------------------------------------------------------------------------------
 
 void PIDController::setOutputLimits(double lowerOutputLimit, double upperOutputLimit) {
-    this->lowerOutputLimit = lowerOutputLimit;
-    this->upperOutputLimit = upperOutputLimit;
+    state.lowerOutputLimit = lowerOutputLimit;
+    state.upperOutputLimit = upperOutputLimit;
+}
+
+//------------------------------------------------------------------------------
+// setSamplingPeriod
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : samplingPeriod
+//
+// This function puts the PID controller in fixed period mode. While the period
+// is positive, calc() uses it as the sampling time and the clock is never
+// read. A period of zero restores the default behavior of measuring the
+// elapsed time between calls.
+//------------------------------------------------------------------------------
+
+void PIDController::setSamplingPeriod(double samplingPeriod) {
+    state.samplingPeriod = samplingPeriod;
+}
+
+//------------------------------------------------------------------------------
+// setClock
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : clock
+//
+// This function sets the clock used to measure the sampling time when no fixed
+// sampling period is set. The default reads std::chrono::steady_clock; a cycle
+// counter (pid::TscClock) or a simulated clock can be used instead.
+//------------------------------------------------------------------------------
+
+void PIDController::setClock(ClockFunction clock) {
+    this->clock = clock;
+    lastSampleTime = clock();
+}
+
+//------------------------------------------------------------------------------
+// setAlgorithm
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : algorithm
+//
+// This function selects the positional or velocity form of the PID algorithm.
+// Both forms give the same output as long as it stays within the output
+// limits. The velocity form needs no integrator and cannot wind up, since the
+// limited output is the only accumulated value. Switching back to the
+// positional form recomputes the integrator from the last output, so the
+// switch is bumpless in both directions.
+//------------------------------------------------------------------------------
+
+void PIDController::setAlgorithm(Algorithm algorithm) {
+    pidSetAlgorithm(state, algorithm);
+}
+
+//------------------------------------------------------------------------------
+// setDerivativeMode
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : mode
+//
+// This function selects the signal the derivative term acts on. With
+// DERIVATIVE_ON_MEASUREMENT the derivative term is -kd times the rate of
+// change of the process variable, so a step in the setpoint no longer kicks
+// the output. Combine it with setDerivativeFilter() on noisy measurements.
+//------------------------------------------------------------------------------
+
+void PIDController::setDerivativeMode(DerivativeMode mode) {
+    state.derivativeMode = mode;
+}
+
+//------------------------------------------------------------------------------
+// setDerivativeFilter
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : timeConstant
+//
+// This function low-pass filters the derivative with a first-order filter of
+// the given time constant in seconds, 1/(timeConstant*s + 1). The usual
+// filter coefficient N corresponds to timeConstant = kd/(kp*N). The filter is
+// discretized with the backward Euler rule, which is stable at any sampling
+// time, and only keeps the last filtered value. A time constant of 0 (the
+// default) turns it off.
+//------------------------------------------------------------------------------
+
+void PIDController::setDerivativeFilter(double timeConstant) {
+    state.derivativeTimeConstant = timeConstant > 0 ? timeConstant : 0;
+}
+
+//------------------------------------------------------------------------------
+// setAntiWindup
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : antiWindup
+//
+// This function selects how the positional form limits integrator windup
+// while the output is at a limit; see PIDController::AntiWindup. The
+// velocity form cannot wind up and is not affected. The default,
+// OUTPUT_CLAMP, keeps the original behavior.
+//------------------------------------------------------------------------------
+
+void PIDController::setAntiWindup(AntiWindup antiWindup) {
+    state.antiWindup = antiWindup;
+}
+
+//------------------------------------------------------------------------------
+// setTrackingGain
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : trackingGain
+//
+// This function sets the tracking gain, in 1/s, with which BACK_CALCULATION
+// moves the integral term toward the limited output: the inverse of the
+// tracking time constant. A gain of 0 (the default) uses ki/kp, i.e. tracks
+// with the integral time, or one sampling time for a pure I controller.
+// Tracking never overshoots: at most the whole excess is removed per sample.
+//------------------------------------------------------------------------------
+
+void PIDController::setTrackingGain(double trackingGain) {
+    state.trackingGain = trackingGain > 0 ? trackingGain : 0;
+}
+
+//------------------------------------------------------------------------------
+// setIntegratorLimits
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : lowerIntegratorLimit, upperIntegratorLimit
+//
+// This function sets the bounds INTEGRATOR_CLAMP keeps the integral term
+// (ki times the integrator, in output units) within. Equal limits mean
+// unlimited, as for the other limits.
+//------------------------------------------------------------------------------
+
+void PIDController::setIntegratorLimits(double lowerIntegratorLimit, double upperIntegratorLimit) {
+    state.lowerIntegratorLimit = lowerIntegratorLimit;
+    state.upperIntegratorLimit = upperIntegratorLimit;
+}
+
+//------------------------------------------------------------------------------
+// setState
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : state
+//
+// This function restores a snapshot taken with getState(), possibly from
+// another controller or process. The next calc() continues from the snapshot
+// as the original controller would have. When the sampling time is measured,
+// it is measured from now, since the clock reading of another process means
+// nothing here.
+//------------------------------------------------------------------------------
+
+void PIDController::setState(const PIDState& snapshot) {
+    pidRestoreState(state, snapshot);
+    if(state.samplingPeriod <= 0) {
+        lastSampleTime = clock();
+    }
+}
+
+//------------------------------------------------------------------------------
+// setParameterChannel
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : channel
+//
+// This function attaches a parameter channel through which another thread can
+// update the setpoint, gains, and limits while calc() runs. Each calc() picks
+// up the newest complete set before computing, without locking. Passing a null
+// pointer detaches the channel. The channel must outlive the controller or be
+// detached first.
+//------------------------------------------------------------------------------
+
+void PIDController::setParameterChannel(PIDParameterChannel* channel) {
+    parameterChannel = channel;
+}
+
+//------------------------------------------------------------------------------
+// setInstrumentation
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : instrumentation
+//
+// This function attaches timing instrumentation. Every calc() then records its
+// sampling time and, by reading the clock before and after the computation,
+// its execution time. With a fixed sampling period, the sampling time the
+// computation uses is the nominal one, so the instrumentation records the
+// interval measured between the starts of consecutive computations instead,
+// and its jitter and deadline misses show how regularly calc() is actually
+// called. The first computation after attaching, on(), or an idle stretch
+// has no previous start and records the nominal period. Passing a null
+// pointer detaches it.
+//------------------------------------------------------------------------------
+
+void PIDController::setInstrumentation(PIDInstrumentation* instrumentation) {
+    this->instrumentation = instrumentation;
+    stepTimed = false;
+}
+
+//------------------------------------------------------------------------------
+// setStepResponseAnalyzer
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : analyzer
+//
+// This function attaches a step-response analyzer that every calc() updates
+// with the setpoint, process variable, and sampling time, and that
+// hasSettled() then answers from. Passing a null pointer detaches it.
+//------------------------------------------------------------------------------
+
+void PIDController::setStepResponseAnalyzer(StepResponseAnalyzer* analyzer) {
+    this->analyzer = analyzer;
+}
+
+//------------------------------------------------------------------------------
+// setGainSchedule
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : schedule, variable
+//
+// This function attaches a gain schedule. Every calc() then looks up and
+// interpolates kp, ki and kd at the current value of 'variable' before
+// computing, replacing gains set with setGains(). In the positional form the
+// integrator is rescaled when ki changes, so the integral term, and with it
+// the output, does not jump. Passing a null pointer detaches the schedule and
+// keeps the last gains. The schedule must outlive the controller or be
+// detached first, and may be shared by any number of controllers.
+//------------------------------------------------------------------------------
+
+void PIDController::setGainSchedule(const GainSchedule* schedule, ScheduleVariable variable) {
+    gainSchedule = schedule;
+    scheduleVariable = variable;
+}
+
+//------------------------------------------------------------------------------
+// setSchedulingVariable
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : value
+//
+// This function sets the value the gain schedule is looked up with when it
+// was attached with SCHEDULE_ON_EXTERNAL, e.g. a measured operating point.
+//------------------------------------------------------------------------------
+
+void PIDController::setSchedulingVariable(double value) {
+    schedulingVariable = value;
+}
+
+//------------------------------------------------------------------------------
+// autoTune
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : tuner
+//
+// This function starts relay auto-tuning. The controller is turned off and
+// calc() returns the relay output of 'tuner', switched around the output it
+// was holding, within the output limits. When the tuner finishes, the gains
+// it computes are applied with setGains() and the controller is turned back
+// on without a bump in its output; if it fails, the gains are kept. Either
+// way the tuner is detached. A gain schedule, if attached, overrides the
+// tuned gains at the next calc(). Passing a null pointer cancels a run and
+// turns the controller back on.
+//------------------------------------------------------------------------------
+
+void PIDController::autoTune(RelayAutoTuner* tuner) {
+    if(autoTuner) {
+        autoTuner->cancel();
+        autoTuner = 0;
+        this->on();
+    }
+    if(tuner) {
+        this->off();
+        tuner->start(state.lastControlVariable);
+        autoTuner = tuner;
+        if(state.samplingPeriod <= 0) {
+            lastSampleTime = clock();
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// setEventThresholds
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : processVariableDelta, outputDelta
+//
+// This function makes the controller event-driven, for loops that mostly sit
+// at steady state. While the process variable stays within
+// 'processVariableDelta' of both the setpoint and the value it was last
+// computed with, and the setpoint does not change, calc() skips the
+// computation (and, with a measured sampling time, the clock read) and holds
+// its output. The next computation accounts for the skipped time, so the
+// integrator and derivative see the whole interval. A new
+// output is then emitted only when it differs from the last emitted one by
+// more than 'outputDelta' (send-on-delta); hasOutputChanged() tells the
+// caller whether to send it. calcDetailed() skips idle samples like calc(),
+// but emits every output it computes. Zero for both, the default, computes
+// and emits on every call.
+//------------------------------------------------------------------------------
+
+void PIDController::setEventThresholds(double processVariableDelta, double outputDelta) {
+    this->processVariableDelta = processVariableDelta > 0 ? processVariableDelta : 0;
+    this->outputDelta = outputDelta > 0 ? outputDelta : 0;
+    eventDriven = this->processVariableDelta > 0 || this->outputDelta > 0;
+    outputChanged = true;
+    emittedOutput = state.lastControlVariable;
+    skippedTime = 0;
+    skippedSamples = 0;
 }
 
 //------------------------------------------------------------------------------
@@ -174,8 +537,8 @@ void PIDController::setOutputLimits(double lowerOutputLimit, double upperOutputL
 //------------------------------------------------------------------------------
 
 void PIDController::off() {
-    isEnabled = false;
-    setpointReached = false;
+    state.isEnabled = false;
+    state.setpointReached = false;
 }
 
 //------------------------------------------------------------------------------
@@ -190,37 +553,96 @@ void PIDController::off() {
 //------------------------------------------------------------------------------
 
 void PIDController::on() {
-    if(!isEnabled) {
-        isEnabled = true;
-        integrator = lastControlVariable;
-        sample_timer.stop();
-        sample_timer.start();
+    if(!state.isEnabled) {
+        state.isEnabled = true;
+        state.integrator = state.lastControlVariable;
+        emittedOutput = state.lastControlVariable;
+        skippedTime = 0;
+        skippedSamples = 0;
+        stepTimed = false;
+        if(state.samplingPeriod <= 0) {
+            lastSampleTime = clock();
+        }
     }
 }
 
 //------------------------------------------------------------------------------
-// limiter
+// init
 //------------------------------------------------------------------------------
 //
-// Return Value : double
-// Parameters   : value, lowerLimit, upperLimit
+// Return Value : None
+// Parameters   : kp, ki, kd, lowerInputLimit, upperInputLimit,
+//                lowerOutputLimit, upperOutputLimit, samplingPeriod
+//
+// This function sets up a disabled controller for the constructors: the
+// defaults of pidInitState(), the steady clock, nothing attached, and no
+// event thresholds.
+//------------------------------------------------------------------------------
+
+void PIDController::init(double kp, double ki, double kd, double lowerInputLimit, double upperInputLimit, double lowerOutputLimit, double upperOutputLimit, double samplingPeriod) {
+    pidInitState(state, kp, ki, kd, lowerInputLimit, upperInputLimit, lowerOutputLimit, upperOutputLimit, samplingPeriod);
+    this->setClock(&pid::clockSeconds<std::chrono::steady_clock>);
+    parameterChannel = 0;
+    instrumentation = 0;
+    stepTimed = false;
+    analyzer = 0;
+    gainSchedule = 0;
+    autoTuner = 0;
+    scheduleVariable = SCHEDULE_ON_PROCESS_VARIABLE;
+    schedulingVariable = 0;
+    this->setEventThresholds(0, 0);
+    this->reset();
+    this->off();
+}
+
+//------------------------------------------------------------------------------
+// applyParameterChannel
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : None
+//
+// This function applies the newest parameter set published on the attached
+// channel, if there is one. Limits are applied before the setpoint so that the
+// new input limits bound the new setpoint.
+//------------------------------------------------------------------------------
+
+void PIDController::applyParameterChannel() {
+    PIDParameters parameters;
+    if(parameterChannel->consume(parameters)) {
+        this->setGains(parameters.kp, parameters.ki, parameters.kd);
+        this->setInputLimits(parameters.lowerInputLimit, parameters.upperInputLimit);
+        this->setOutputLimits(parameters.lowerOutputLimit, parameters.upperOutputLimit);
+        this->targetSetpoint(parameters.setpoint);
+    }
+}
+
+//------------------------------------------------------------------------------
+// applyGainSchedule
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : processVariable
 //
-// This function compares the input 'value' to the specified limits. If the
-// value exceeds the limits, the value is capped to one of the limits.
+// This function sets the gains from the attached schedule at the current
+// scheduling variable, keeping the integral term continuous.
 //------------------------------------------------------------------------------
 
-double PIDController::limiter(double value, double lowerLimit, double upperLimit) {
-    if (lowerLimit == upperLimit) {
-        return value;
+void PIDController::applyGainSchedule(double processVariable) {
+    double variable = processVariable;
+    if(scheduleVariable == SCHEDULE_ON_SETPOINT) {
+        variable = state.setpoint;
     }
-    else if(value < lowerLimit) {
-        return lowerLimit;
+    else if(scheduleVariable == SCHEDULE_ON_EXTERNAL) {
+        variable = schedulingVariable;
     }
-    else if(value > upperLimit) {
-        return upperLimit;
+    
+    double scheduledKp = state.kp, scheduledKi = state.ki, scheduledKd = state.kd;
+    gainSchedule->lookup(variable, scheduledKp, scheduledKi, scheduledKd);
+    if(state.algorithm == POSITIONAL && scheduledKi != state.ki && scheduledKi != 0) {
+        state.integrator = state.integrator * state.ki / scheduledKi;
     }
-    else
-        return value;
+    this->setGains(scheduledKp, scheduledKi, scheduledKd);
 }
 
 //------------------------------------------------------------------------------
@@ -234,10 +656,7 @@ double PIDController::limiter(double value, double lowerLimit, double upperLimit
 //------------------------------------------------------------------------------
 
 void PIDController::reset() {
-    setpoint = 0;
-    lastSetpoint = 0;
-    integrator = lastControlVariable;
-    sample_timer.stop();
+    pidResetState(state);
 }
 
 //------------------------------------------------------------------------------
@@ -247,12 +666,17 @@ void PIDController::reset() {
 // Return Value : bool
 // Parameters   : None
 //
-// This function returns true only when the PID controller has stabilized to
-// within 5% of its final value.
+// This function returns true only when the PID controller has stabilized.
+// With a step-response analyzer attached, that is when the process variable
+// is within its settling band of the setpoint. Otherwise it is when the
+// process variable changed by less than 0.5 per second over the last sample.
 //------------------------------------------------------------------------------
 
 bool PIDController::hasSettled() {
-    return setpointReached;
+    if(analyzer) {
+        return analyzer->hasSettled();
+    }
+    return state.setpointReached;
 }
 
 //------------------------------------------------------------------------------
@@ -263,41 +687,427 @@ bool PIDController::hasSettled() {
 // Parameters   : processVariable
 //
 // This function calculates the next output value of the PID controller, given
-// the current setpoint, elasped time, and feedback (processVariable). It also
-// keeps track of peak time, settling time, and percent overshoot for quickly
-// assessing the current performance of the controller.
+// the current setpoint, elasped time, and feedback (processVariable). The
+// elapsed time is the fixed sampling period when one has been set, otherwise
+// it is measured with the clock since the previous call.
 //------------------------------------------------------------------------------
 
 double PIDController::calc(double processVariable) {
-    if(!isEnabled) {
-        return lastControlVariable;
+    if(!state.isEnabled && !autoTuner) {
+        return state.lastControlVariable;
+    }
+    if(state.samplingPeriod > 0) {
+        return calc(processVariable, state.samplingPeriod);
+    }
+    double samplingTime;
+    if(!measureSample(processVariable, samplingTime)) {
+        return emittedOutput;
+    }
+
+    return compute(processVariable, samplingTime);
+}
+
+//------------------------------------------------------------------------------
+// calc
+//------------------------------------------------------------------------------
+//
+// Return Value : double
+// Parameters   : processVariable, samplingTime
+//
+// This function calculates the next output value of the PID controller, given
+// the current setpoint, the time elapsed since the previous call
+// (samplingTime, in seconds), and feedback (processVariable). The clock is not
+// read, so callers running at a known rate avoid its cost. The output is
+// computed with the algorithm chosen by setAlgorithm(). A step-response
+// analyzer attached with setStepResponseAnalyzer() is updated as well, for
+// quickly assessing the current performance of the controller.
+//------------------------------------------------------------------------------
+
+double PIDController::calc(double processVariable, double samplingTime) {
+    if(state.isEnabled && parameterChannel) {
+        applyParameterChannel();
+    }
+    return compute(processVariable, samplingTime);
+}
+
+//------------------------------------------------------------------------------
+// track
+//------------------------------------------------------------------------------
+//
+// Return Value : double
+// Parameters   : setpoint, processVariable, samplingTime
+//
+// This function sets the setpoint, within the input limits, and calculates
+// the next output like calc(processVariable, samplingTime). Unlike
+// targetSetpoint() it never reads the clock, so it suits the inner loop of a
+// cascade, whose setpoint changes every sample.
+//------------------------------------------------------------------------------
+
+double PIDController::track(double setpoint, double processVariable, double samplingTime) {
+    state.setpoint = pidLimit(setpoint, state.lowerInputLimit, state.upperInputLimit);
+    return calc(processVariable, samplingTime);
+}
+
+//------------------------------------------------------------------------------
+// calcDetailed
+//------------------------------------------------------------------------------
+//
+// Return Value : PIDOutput
+// Parameters   : processVariable
+//
+// This function does what calc(processVariable) does and returns the output
+// together with the error and the proportional, integral, and derivative
+// terms it was computed from. A disabled controller, or an event-driven one
+// that skips the sample, returns its held output and zero terms.
+//------------------------------------------------------------------------------
+
+PIDOutput PIDController::calcDetailed(double processVariable) {
+    if(!state.isEnabled && !autoTuner) {
+        return heldOutput(processVariable, state.lastControlVariable);
+    }
+    if(state.samplingPeriod > 0) {
+        return calcDetailed(processVariable, state.samplingPeriod);
+    }
+    double samplingTime;
+    if(!measureSample(processVariable, samplingTime)) {
+        return heldOutput(processVariable, emittedOutput);
+    }
+
+    return computeDetailed(processVariable, samplingTime);
+}
+
+//------------------------------------------------------------------------------
+// calcDetailed
+//------------------------------------------------------------------------------
+//
+// Return Value : PIDOutput
+// Parameters   : processVariable, samplingTime
+//
+// This function does what calc(processVariable, samplingTime) does and
+// returns every term it computed, like calcDetailed(processVariable).
+//------------------------------------------------------------------------------
+
+PIDOutput PIDController::calcDetailed(double processVariable, double samplingTime) {
+    if(state.isEnabled && parameterChannel) {
+        applyParameterChannel();
+    }
+    return computeDetailed(processVariable, samplingTime);
+}
+
+//------------------------------------------------------------------------------
+// measureSample
+//------------------------------------------------------------------------------
+//
+// Return Value : bool
+// Parameters   : processVariable, samplingTime
+//
+// This function does the part of calc(processVariable) and
+// calcDetailed(processVariable) that is specific to a measured sampling time,
+// and applies the parameter channel. It returns false if an event-driven
+// controller skips the sample: idle samples skip the clock read, and the next
+// computation measures the whole interval and splits it evenly among them.
+// Otherwise it sets 'samplingTime' to the time elapsed since the last
+// computed sample, or to its share of it, and returns true.
+//------------------------------------------------------------------------------
+
+bool PIDController::measureSample(double processVariable, double& samplingTime) {
+    // The channel is applied before the idle check, so that a new setpoint
+    // ends an idle stretch, but after the clock read otherwise, so that the
+    // setpoint it sets does not restart the interval being measured. In the
+    // event-driven case the interval and the skipped samples are kept across
+    // it for the same reason; losing them would compute this sample over a
+    // zero sampling time.
+    if(eventDriven && state.isEnabled) {
+        if(parameterChannel) {
+            double sampleTime = lastSampleTime;
+            unsigned long skipped = skippedSamples;
+            applyParameterChannel();
+            lastSampleTime = sampleTime;
+            skippedSamples = skipped;
+        }
+        if(isIdle(processVariable)) {
+            skippedSamples++;
+            outputChanged = false;
+            return false;
+        }
+    }
+    double now = clock();
+    samplingTime = now - lastSampleTime;
+    lastSampleTime = now;
+    if(skippedSamples > 0) {
+        double interval = samplingTime;
+        samplingTime = interval / (skippedSamples + 1);
+        skippedTime += interval - samplingTime;
+        skippedSamples = 0;
+    }
+    if(!eventDriven && state.isEnabled && parameterChannel) {
+        applyParameterChannel();
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// compute
+//------------------------------------------------------------------------------
+//
+// Return Value : double
+// Parameters   : processVariable, samplingTime
+//
+// This function does what calc(processVariable, samplingTime) does once the
+// parameter channel has been applied.
+//------------------------------------------------------------------------------
+
+double PIDController::compute(double processVariable, double samplingTime) {
+    if(!state.isEnabled) {
+        if(autoTuner) {
+            return stepAutoTuner(processVariable, samplingTime);
+        }
+        return state.lastControlVariable;
+    }
+    if(eventDriven) {
+        if(isIdle(processVariable)) {
+            skippedTime += samplingTime;
+            outputChanged = false;
+            stepTimed = false;
+            return emittedOutput;
+        }
+        if(skippedTime > 0) {
+            resumeFromIdle(processVariable, samplingTime);
+        }
+    }
+    if(gainSchedule) {
+        applyGainSchedule(processVariable);
+    }
+    double controlVariable;
+    if(instrumentation) {
+        double start = clock();
+        controlVariable = step<false>(processVariable, samplingTime, 0);
+        instrumentation->recordSample(sampleInterval(start, samplingTime));
+        instrumentation->recordExecution(clock() - start);
+    }
+    else {
+        controlVariable = step<false>(processVariable, samplingTime, 0);
     }
-    sample_timer.stop();
-    
-    double error = setpoint - processVariable;
-    double samplingTime = (sample_timer.elapsed().wall)/1e9;
-    
-    double diffProcessVariable = (processVariable - lastProcessVariable)/samplingTime;
-    double percent = (processVariable/setpoint) - 1;
-    
-    if(abs(diffProcessVariable) < 0.5) {
-		setpointReached = true;
-	}
-	else {
-		setpointReached = false;
-	}
     
-    double differentiator = (setpoint - lastSetpoint)/samplingTime;
-    integrator += (error * samplingTime);
-    integrator = limiter(integrator, lowerOutputLimit, upperOutputLimit);
-    double controlVariable = kp * error + ki * integrator - kd * differentiator;
+    return eventDriven ? emit(controlVariable) : controlVariable;
+}
+
+//------------------------------------------------------------------------------
+// computeDetailed
+//------------------------------------------------------------------------------
+//
+// Return Value : PIDOutput
+// Parameters   : processVariable, samplingTime
+//
+// This function does what calcDetailed(processVariable, samplingTime) does
+// once the parameter channel has been applied. It skips idle samples like
+// compute(), but emits every output it computes.
+//------------------------------------------------------------------------------
+
+PIDOutput PIDController::computeDetailed(double processVariable, double samplingTime) {
+    if(!state.isEnabled) {
+        if(autoTuner) {
+            stepAutoTuner(processVariable, samplingTime);
+        }
+        return heldOutput(processVariable, state.lastControlVariable);
+    }
+    if(eventDriven) {
+        if(isIdle(processVariable)) {
+            skippedTime += samplingTime;
+            outputChanged = false;
+            stepTimed = false;
+            return heldOutput(processVariable, emittedOutput);
+        }
+        if(skippedTime > 0) {
+            resumeFromIdle(processVariable, samplingTime);
+        }
+    }
+    if(gainSchedule) {
+        applyGainSchedule(processVariable);
+    }
+    PIDOutput output;
+    if(instrumentation) {
+        double start = clock();
+        step<true>(processVariable, samplingTime, &output);
+        instrumentation->recordSample(sampleInterval(start, samplingTime));
+        instrumentation->recordExecution(clock() - start);
+    }
+    else {
+        step<true>(processVariable, samplingTime, &output);
+    }
     
-    controlVariable = limiter(controlVariable, lowerOutputLimit, upperOutputLimit);
-    lastControlVariable = controlVariable;
-    lastSetpoint = setpoint;
-    lastProcessVariable = processVariable;
+    if(eventDriven) {
+        emittedOutput = output.output;
+        outputChanged = true;
+    }
+    return output;
+}
+
+//------------------------------------------------------------------------------
+// sampleInterval
+//------------------------------------------------------------------------------
+//
+// Return Value : double
+// Parameters   : start, samplingTime
+//
+// This function returns the sampling time to record for a computation that
+// started at 'start': with a fixed sampling period, the time since the start
+// of the previous computation, when there was one; otherwise 'samplingTime'.
+//------------------------------------------------------------------------------
+
+double PIDController::sampleInterval(double start, double samplingTime) {
+    double interval = samplingTime;
+    if(state.samplingPeriod > 0 && stepTimed) {
+        interval = start - lastStepTime;
+    }
+    lastStepTime = start;
+    stepTimed = true;
+    return interval;
+}
+
+//------------------------------------------------------------------------------
+// heldOutput
+//------------------------------------------------------------------------------
+//
+// Return Value : PIDOutput
+// Parameters   : processVariable, output
+//
+// This function returns what calcDetailed() reports when it does not compute,
+// because the controller is off or the sample is idle: the held 'output' and
+// no terms.
+//------------------------------------------------------------------------------
+
+PIDOutput PIDController::heldOutput(double processVariable, double output) {
+    PIDOutput held = {};
+    held.setpoint = state.setpoint;
+    held.processVariable = processVariable;
+    held.output = output;
+    return held;
+}
+
+//------------------------------------------------------------------------------
+// stepAutoTuner
+//------------------------------------------------------------------------------
+//
+// Return Value : double
+// Parameters   : processVariable, samplingTime
+//
+// This function does calc() while auto-tuning, and hands over to the tuned
+// gains when the tuner is done. The integrator is set so that the first
+// output after the handover equals the relay bias.
+//------------------------------------------------------------------------------
+
+double PIDController::stepAutoTuner(double processVariable, double samplingTime) {
+    double controlVariable = autoTuner->step(state.setpoint, processVariable, samplingTime);
+    controlVariable = pidLimit(controlVariable, state.lowerOutputLimit, state.upperOutputLimit);
+    state.outputIncrement = controlVariable - state.lastControlVariable;
+    state.lastControlVariable = controlVariable;
+    state.lastProcessVariable = processVariable;
+    state.lastSetpoint = state.setpoint;
     
-    sample_timer.start();
+    RelayAutoTuner::State tunerState = autoTuner->getState();
+    if(tunerState == RelayAutoTuner::FINISHED || tunerState == RelayAutoTuner::FAILED) {
+        double tunedKp, tunedKi, tunedKd;
+        if(autoTuner->getGains(tunedKp, tunedKi, tunedKd)) {
+            this->setGains(tunedKp, tunedKi, tunedKd);
+        }
+        autoTuner = 0;
+        this->on();
+        double error = state.setpoint - processVariable;
+        state.lastError = error;
+        state.lastDifferentiator = 0;
+        if(state.algorithm == POSITIONAL && std::fabs(state.ki) > 0) {
+            state.integrator = (controlVariable - state.kp * error) / state.ki;
+        }
+    }
+    return controlVariable;
+}
+
+//------------------------------------------------------------------------------
+// isIdle
+//------------------------------------------------------------------------------
+//
+// Return Value : bool
+// Parameters   : processVariable
+//
+// This function returns true if calc() may skip the computation under
+// setEventThresholds(): the setpoint is unchanged and the process variable is
+// within the deadband of both the setpoint and its last computed value.
+//------------------------------------------------------------------------------
+
+bool PIDController::isIdle(double processVariable) {
+    return processVariableDelta > 0
+           && std::fabs(processVariable - state.lastProcessVariable) <= processVariableDelta
+           && std::fabs(state.setpoint - processVariable) <= processVariableDelta
+           && state.setpoint == state.lastSetpoint;
+}
+
+//------------------------------------------------------------------------------
+// resumeFromIdle
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : processVariable, samplingTime
+//
+// This function accounts for the samples calc() skipped before computing the
+// current one over 'samplingTime'. The error stayed within the deadband of
+// its last computed value while idle, so that value is integrated over the
+// skipped time, and the process variable's change is spread over the whole
+// interval so the derivative sees its average rate rather than a kick.
+//------------------------------------------------------------------------------
 
+void PIDController::resumeFromIdle(double processVariable, double samplingTime) {
+    if(state.algorithm == VELOCITY) {
+        state.lastControlVariable = pidLimit(state.lastControlVariable + state.ki * state.lastError * skippedTime, state.lowerOutputLimit, state.upperOutputLimit);
+    }
+    else {
+        state.integrator += state.lastError * skippedTime;
+    }
+    double change = processVariable - state.lastProcessVariable;
+    state.lastProcessVariable = processVariable - change * samplingTime / (samplingTime + skippedTime);
+    skippedTime = 0;
+}
+
+//------------------------------------------------------------------------------
+// emit
+//------------------------------------------------------------------------------
+//
+// Return Value : double
+// Parameters   : controlVariable
+//
+// This function returns the output calc() hands out under
+// setEventThresholds(): 'controlVariable' if it moved by more than the output
+// threshold from the last emitted output, otherwise the last emitted output.
+//------------------------------------------------------------------------------
+
+double PIDController::emit(double controlVariable) {
+    if(outputDelta > 0 && std::fabs(controlVariable - emittedOutput) <= outputDelta) {
+        outputChanged = false;
+        return emittedOutput;
+    }
+    emittedOutput = controlVariable;
+    outputChanged = true;
+    return controlVariable;
+}
+
+//------------------------------------------------------------------------------
+// step
+//------------------------------------------------------------------------------
+//
+// Return Value : double
+// Parameters   : processVariable, samplingTime, detail
+//
+// This function does the computation of calc() for an enabled controller with
+// pidStep(), which CompactPIDController shares, and updates the analyzer. The
+// terms for calcDetailed() are only filled into 'detail' in the Detailed
+// instantiation, so calc() does not pay for them.
+//------------------------------------------------------------------------------
+
+template <bool Detailed>
+double PIDController::step(double processVariable, double samplingTime, PIDOutput* detail) {
+    double controlVariable = pidStep<Detailed>(state, processVariable, samplingTime, detail);
+    if(analyzer) {
+        analyzer->update(state.setpoint, processVariable, samplingTime);
+    }
     return controlVariable;
 }
@@ -0,0 +1,251 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "PIDInstrumentation.h"
+#include <cmath>
+#include <limits>
+
+//------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------
+
+// Single-writer increment: a relaxed load and store, no locked instruction.
+template <class T>
+static inline void accumulate(std::atomic<T>& counter, T value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+static inline void raise(std::atomic<double>& maximum, double value) {
+    if(value > maximum.load(std::memory_order_relaxed)) {
+        maximum.store(value, std::memory_order_relaxed);
+    }
+}
+
+// Upper edge of bin k - 1 and lower edge of bin k, 2^k ns, in seconds. The
+// export writes the same values as the "le" bounds.
+static inline double binEdge(unsigned k) {
+    return std::ldexp(1.0, k) * 1e-9;
+}
+
+// Bin of a duration in seconds on the log2 nanosecond scale: bin k holds
+// (2^k, 2^(k+1)] ns. The frexp() estimate is checked against binEdge(), so
+// that a duration equal to an exported bound is counted in that bucket
+// whichever way the conversion to nanoseconds rounds.
+static inline unsigned bin(double seconds) {
+    if(!(seconds > binEdge(1))) {
+        return 0;
+    }
+    if(!(seconds <= binEdge(PIDInstrumentation::BINS - 1))) {
+        return PIDInstrumentation::BINS - 1;
+    }
+    int exponent;
+    std::frexp(seconds * 1e9, &exponent);
+    unsigned k = exponent - 1;
+    if(!(seconds > binEdge(k))) {
+        k--;
+    }
+    else if(seconds > binEdge(k + 1)) {
+        k++;
+    }
+    return k;
+}
+
+//------------------------------------------------------------------------------
+// Constructors
+//------------------------------------------------------------------------------
+
+// No nominal period: histograms only, no jitter or deadline misses
+PIDInstrumentation::PIDInstrumentation() {
+    this->setNominalPeriod(0, 0);
+    this->reset();
+}
+
+// Nominal period, with a tolerance of half a period
+PIDInstrumentation::PIDInstrumentation(double nominalPeriod) {
+    this->setNominalPeriod(nominalPeriod, nominalPeriod / 2);
+    this->reset();
+}
+
+// Nominal period and tolerance
+PIDInstrumentation::PIDInstrumentation(double nominalPeriod, double tolerance) {
+    this->setNominalPeriod(nominalPeriod, tolerance);
+    this->reset();
+}
+
+// Destructor
+PIDInstrumentation::~PIDInstrumentation() {
+}
+
+//------------------------------------------------------------------------------
+// Accessors
+//------------------------------------------------------------------------------
+
+double PIDInstrumentation::getNominalPeriod() {
+    return nominalPeriod.load(std::memory_order_relaxed);
+}
+
+double PIDInstrumentation::getTolerance() {
+    return tolerance.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+// Mutators
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// setNominalPeriod
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : nominalPeriod, tolerance
+//
+// This function sets the sampling period the loop is meant to run at and how
+// much later than that a sample may arrive before it counts as a deadline
+// miss. A nominal period of zero disables jitter and deadline tracking.
+//------------------------------------------------------------------------------
+
+void PIDInstrumentation::setNominalPeriod(double nominalPeriod, double tolerance) {
+    this->nominalPeriod.store(nominalPeriod, std::memory_order_relaxed);
+    this->tolerance.store(tolerance, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+// Other Functions
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// recordSample
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : samplingTime
+//
+// This function records the time between two consecutive samples, in seconds.
+//------------------------------------------------------------------------------
+
+void PIDInstrumentation::recordSample(double samplingTime) {
+    accumulate(samples, (uint64_t)1);
+    accumulate(samplingTimeSum, samplingTime);
+    accumulate(samplingTimeHistogram[bin(samplingTime)], (uint64_t)1);
+    
+    double nominal = nominalPeriod.load(std::memory_order_relaxed);
+    if(nominal > 0) {
+        raise(maxJitter, std::fabs(samplingTime - nominal));
+        if(samplingTime > nominal + tolerance.load(std::memory_order_relaxed)) {
+            accumulate(deadlineMisses, (uint64_t)1);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// recordExecution
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : executionTime
+//
+// This function records how long one step of the loop took, in seconds.
+//------------------------------------------------------------------------------
+
+void PIDInstrumentation::recordExecution(double executionTime) {
+    accumulate(executions, (uint64_t)1);
+    accumulate(executionTimeSum, executionTime);
+    accumulate(executionTimeHistogram[bin(executionTime)], (uint64_t)1);
+    raise(maxExecutionTime, executionTime);
+}
+
+//------------------------------------------------------------------------------
+// reset
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : None
+//
+// This function clears every counter. It must be called from the recording
+// thread, or while nothing is recording.
+//------------------------------------------------------------------------------
+
+void PIDInstrumentation::reset() {
+    samples.store(0, std::memory_order_relaxed);
+    deadlineMisses.store(0, std::memory_order_relaxed);
+    maxJitter.store(0, std::memory_order_relaxed);
+    samplingTimeSum.store(0, std::memory_order_relaxed);
+    executions.store(0, std::memory_order_relaxed);
+    maxExecutionTime.store(0, std::memory_order_relaxed);
+    executionTimeSum.store(0, std::memory_order_relaxed);
+    for(unsigned k = 0; k < BINS; k++) {
+        samplingTimeHistogram[k].store(0, std::memory_order_relaxed);
+        executionTimeHistogram[k].store(0, std::memory_order_relaxed);
+    }
+}
+
+//------------------------------------------------------------------------------
+// snapshot
+//------------------------------------------------------------------------------
+//
+// Return Value : PIDInstrumentationSnapshot
+// Parameters   : None
+//
+// This function copies the current counters. It can be called from any
+// thread while the loop keeps recording.
+//------------------------------------------------------------------------------
+
+PIDInstrumentationSnapshot PIDInstrumentation::snapshot() {
+    PIDInstrumentationSnapshot copy;
+    copy.nominalPeriod = nominalPeriod.load(std::memory_order_relaxed);
+    copy.samples = samples.load(std::memory_order_relaxed);
+    copy.deadlineMisses = deadlineMisses.load(std::memory_order_relaxed);
+    copy.maxJitter = maxJitter.load(std::memory_order_relaxed);
+    copy.samplingTimeSum = samplingTimeSum.load(std::memory_order_relaxed);
+    copy.executions = executions.load(std::memory_order_relaxed);
+    copy.maxExecutionTime = maxExecutionTime.load(std::memory_order_relaxed);
+    copy.executionTimeSum = executionTimeSum.load(std::memory_order_relaxed);
+    for(unsigned k = 0; k < BINS; k++) {
+        copy.samplingTimeHistogram[k] = samplingTimeHistogram[k].load(std::memory_order_relaxed);
+        copy.executionTimeHistogram[k] = executionTimeHistogram[k].load(std::memory_order_relaxed);
+    }
+    return copy;
+}
+
+// One Prometheus histogram with cumulative buckets. The +Inf bucket and the
+// count are the total of the bins, not the separate sample counter, which a
+// snapshot taken during a recording can copy out of step with them; buckets
+// must never decrease. The bounds are written with enough digits to parse
+// back to the exact bin edges.
+static void exportHistogram(const std::string& metric, const std::string& label, const uint64_t* histogram, double sum, std::ostream& out) {
+    uint64_t cumulative = 0;
+    for(unsigned k = 0; k + 1 < PIDInstrumentationSnapshot::BINS; k++) {
+        cumulative += histogram[k];
+        std::streamsize precision = out.precision(std::numeric_limits<double>::max_digits10);
+        out << metric << "_bucket{" << label << ",le=\"" << binEdge(k + 1) << "\"} ";
+        out.precision(precision);
+        out << cumulative << "\n";
+    }
+    cumulative += histogram[PIDInstrumentationSnapshot::BINS - 1];
+    out << metric << "_bucket{" << label << ",le=\"+Inf\"} " << cumulative << "\n";
+    out << metric << "_sum{" << label << "} " << sum << "\n";
+    out << metric << "_count{" << label << "} " << cumulative << "\n";
+}
+
+//------------------------------------------------------------------------------
+// exportText
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : snapshot, name, out
+//
+// This function writes 'snapshot' to 'out' in the Prometheus text exposition
+// format, with every metric labelled loop="name". Histograms are cumulative,
+// with bucket bounds in seconds.
+//------------------------------------------------------------------------------
+
+void PIDInstrumentation::exportText(const PIDInstrumentationSnapshot& snapshot, const std::string& name, std::ostream& out) {
+    std::string label = "loop=\"" + name + "\"";
+    out << "pid_nominal_period_seconds{" << label << "} " << snapshot.nominalPeriod << "\n";
+    out << "pid_deadline_misses_total{" << label << "} " << snapshot.deadlineMisses << "\n";
+    out << "pid_max_jitter_seconds{" << label << "} " << snapshot.maxJitter << "\n";
+    out << "pid_max_execution_time_seconds{" << label << "} " << snapshot.maxExecutionTime << "\n";
+    exportHistogram("pid_sampling_time_seconds", label, snapshot.samplingTimeHistogram, snapshot.samplingTimeSum, out);
+    exportHistogram("pid_execution_time_seconds", label, snapshot.executionTimeHistogram, snapshot.executionTimeSum, out);
+}
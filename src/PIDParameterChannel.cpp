@@ -0,0 +1,68 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "PIDParameterChannel.h"
+
+//------------------------------------------------------------------------------
+// Constructors
+//------------------------------------------------------------------------------
+
+// Empty channel, nothing to consume yet
+PIDParameterChannel::PIDParameterChannel() : middle(1), back(0), front(2) {
+    for(unsigned i = 0; i < 3; i++) {
+        slots[i].parameters = PIDParameters();
+    }
+}
+
+// Channel holding an initial parameter set for the reader to consume
+PIDParameterChannel::PIDParameterChannel(const PIDParameters& initial) : middle(1), back(0), front(2) {
+    for(unsigned i = 0; i < 3; i++) {
+        slots[i].parameters = PIDParameters();
+    }
+    this->publish(initial);
+}
+
+// Destructor
+PIDParameterChannel::~PIDParameterChannel() {
+}
+
+//------------------------------------------------------------------------------
+// publish
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : parameters
+//
+// This function makes 'parameters' the newest set available to consume(). It
+// fills the writer's private buffer and swaps it with the shared middle one.
+//------------------------------------------------------------------------------
+
+void PIDParameterChannel::publish(const PIDParameters& parameters) {
+    slots[back].parameters = parameters;
+    unsigned previous = middle.exchange(back | FRESH, std::memory_order_acq_rel);
+    back = previous & ~FRESH;
+}
+
+//------------------------------------------------------------------------------
+// consume
+//------------------------------------------------------------------------------
+//
+// Return Value : bool
+// Parameters   : parameters
+//
+// This function copies the newest published set into 'parameters' and returns
+// true, or returns false and leaves 'parameters' untouched if nothing was
+// published since the last call. Checking for an update is a single atomic
+// load.
+//------------------------------------------------------------------------------
+
+bool PIDParameterChannel::consume(PIDParameters& parameters) {
+    if(!(middle.load(std::memory_order_relaxed) & FRESH)) {
+        return false;
+    }
+    unsigned previous = middle.exchange(front, std::memory_order_acq_rel);
+    front = previous & ~FRESH;
+    parameters = slots[front].parameters;
+    return true;
+}
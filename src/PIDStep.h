@@ -0,0 +1,189 @@
+/* 
+ * File:   PIDStep.h
+ * Author: User
+ *
+ * Created on October 14, 2026
+ */
+
+#ifndef PIDSTEP_H
+#define PIDSTEP_H
+
+#include "PIDController.h"
+#include <cmath>
+#include <cstddef>
+
+// The computation of PIDController and CompactPIDController, on the PIDState
+// both of them hold. There is only this one copy of the math, so the two
+// classes compute bit-identical outputs by construction; each only adds what
+// it has around the state.
+
+// Caps 'value' to the limits; equal limits mean unlimited.
+inline double pidLimit(double value, double lowerLimit, double upperLimit) {
+    if (lowerLimit == upperLimit) {
+        return value;
+    }
+    else if(value < lowerLimit) {
+        return lowerLimit;
+    }
+    else if(value > upperLimit) {
+        return upperLimit;
+    }
+    else
+        return value;
+}
+
+// Sets up a disabled controller with the defaults: positional form,
+// derivative on the setpoint, OUTPUT_CLAMP, no derivative filter, and no
+// integrator limits.
+inline void pidInitState(PIDState& state, double kp, double ki, double kd, double lowerInputLimit, double upperInputLimit, double lowerOutputLimit, double upperOutputLimit, double samplingPeriod) {
+    state = PIDState();
+    state.kp = kp;
+    state.ki = ki;
+    state.kd = kd;
+    state.lowerInputLimit = lowerInputLimit;
+    state.upperInputLimit = upperInputLimit;
+    state.lowerOutputLimit = lowerOutputLimit;
+    state.upperOutputLimit = upperOutputLimit;
+    state.samplingPeriod = samplingPeriod;
+    state.algorithm = PIDController::POSITIONAL;
+    state.derivativeMode = PIDController::DERIVATIVE_ON_SETPOINT;
+    state.antiWindup = PIDController::OUTPUT_CLAMP;
+    state.lowerIntegratorLimit = -1;
+    state.upperIntegratorLimit = -1;
+}
+
+// Copies a snapshot, falling back to the defaults for out-of-range modes.
+inline void pidRestoreState(PIDState& state, const PIDState& snapshot) {
+    state = snapshot;
+    state.isEnabled = snapshot.isEnabled != 0;
+    state.setpointReached = snapshot.setpointReached != 0;
+    if(snapshot.algorithm != PIDController::VELOCITY) {
+        state.algorithm = PIDController::POSITIONAL;
+    }
+    if(snapshot.derivativeMode != PIDController::DERIVATIVE_ON_MEASUREMENT) {
+        state.derivativeMode = PIDController::DERIVATIVE_ON_SETPOINT;
+    }
+    if(snapshot.antiWindup > PIDController::INTEGRATOR_CLAMP) {
+        state.antiWindup = PIDController::OUTPUT_CLAMP;
+    }
+    for(size_t i = 0; i < sizeof(state.reserved); i++) {
+        state.reserved[i] = 0;
+    }
+    state.trackingGain = snapshot.trackingGain > 0 ? snapshot.trackingGain : 0;
+}
+
+// Clears the setpoint and the running state, keeping the held output.
+inline void pidResetState(PIDState& state) {
+    state.setpoint = 0;
+    state.lastSetpoint = 0;
+    state.lastError = 0;
+    state.lastDifferentiator = 0;
+    state.outputIncrement = 0;
+    state.integrator = state.lastControlVariable;
+}
+
+// Selects the positional or velocity form. Switching back to the positional
+// form recomputes the integrator from the last output, so the switch is
+// bumpless in both directions.
+inline void pidSetAlgorithm(PIDState& state, PIDController::Algorithm algorithm) {
+    if(algorithm == PIDController::POSITIONAL && state.algorithm == PIDController::VELOCITY && state.ki != 0) {
+        state.integrator = (state.lastControlVariable - state.kp * state.lastError + state.kd * state.lastDifferentiator) / state.ki;
+        state.integrator = pidLimit(state.integrator, state.lowerOutputLimit, state.upperOutputLimit);
+    }
+    state.algorithm = algorithm;
+}
+
+// One computation of an enabled controller over 'samplingTime'. The terms
+// for calcDetailed() are only filled into 'detail' in the Detailed
+// instantiation, so calc() does not pay for them.
+template <bool Detailed>
+inline double pidStep(PIDState& state, double processVariable, double samplingTime, PIDOutput* detail) {
+    double error = state.setpoint - processVariable;
+
+    double diffProcessVariable = (processVariable - state.lastProcessVariable)/samplingTime;
+
+    state.setpointReached = std::fabs(diffProcessVariable) < 0.5;
+
+    double kp = state.kp, ki = state.ki, kd = state.kd;
+    double differentiator;
+    double change = (state.derivativeMode == PIDController::DERIVATIVE_ON_MEASUREMENT) ? processVariable - state.lastProcessVariable : state.setpoint - state.lastSetpoint;
+    if(state.derivativeTimeConstant > 0) {
+        differentiator = (state.derivativeTimeConstant * state.lastDifferentiator + change)/(state.derivativeTimeConstant + samplingTime);
+    }
+    else {
+        differentiator = change/samplingTime;
+    }
+    double controlVariable;
+    if(state.algorithm == PIDController::VELOCITY) {
+        double increment = kp * (error - state.lastError) + ki * (error * samplingTime) - kd * (differentiator - state.lastDifferentiator);
+        controlVariable = state.lastControlVariable + increment;
+    }
+    else {
+        double lastIntegrator = state.integrator;
+        double integrator = lastIntegrator + (error * samplingTime);
+        if(state.antiWindup == PIDController::OUTPUT_CLAMP) {
+            integrator = pidLimit(integrator, state.lowerOutputLimit, state.upperOutputLimit);
+        }
+        else if(state.antiWindup == PIDController::INTEGRATOR_CLAMP && state.lowerIntegratorLimit != state.upperIntegratorLimit) {
+            double term = ki * integrator;
+            if((term < state.lowerIntegratorLimit || term > state.upperIntegratorLimit) && std::fabs(ki) > 0) {
+                integrator = pidLimit(term, state.lowerIntegratorLimit, state.upperIntegratorLimit) / ki;
+            }
+        }
+        controlVariable = kp * error + ki * integrator - kd * differentiator;
+
+        if(state.antiWindup == PIDController::CONDITIONAL_INTEGRATION) {
+            // Undo this sample's integration if it pushes a limited output
+            // further past its limit.
+            double limited = pidLimit(controlVariable, state.lowerOutputLimit, state.upperOutputLimit);
+            double drive = ki * error;
+            if((controlVariable > limited && drive > 0) || (controlVariable < limited && drive < 0)) {
+                integrator = lastIntegrator;
+                controlVariable = kp * error + ki * integrator - kd * differentiator;
+            }
+        }
+        else if(state.antiWindup == PIDController::BACK_CALCULATION && std::fabs(ki) > 0) {
+            double limited = pidLimit(controlVariable, state.lowerOutputLimit, state.upperOutputLimit);
+            double tracking = state.trackingGain;
+            if(!(tracking > 0)) {
+                tracking = std::fabs(kp) > 0 ? std::fabs(ki / kp) : 1 / samplingTime;
+            }
+            double gain = tracking * samplingTime;
+            if(gain > 1) {
+                gain = 1;
+            }
+            integrator = integrator + gain * (limited - controlVariable) / ki;
+        }
+        state.integrator = integrator;
+    }
+
+    if(Detailed) {
+        detail->setpoint = state.setpoint;
+        detail->processVariable = processVariable;
+        detail->error = error;
+        detail->proportional = kp * error;
+        detail->derivative = -(kd * differentiator);
+        if(state.algorithm == PIDController::VELOCITY) {
+            detail->integral = controlVariable - detail->proportional - detail->derivative;
+        }
+        else {
+            detail->integral = ki * state.integrator;
+        }
+        detail->samplingTime = samplingTime;
+    }
+
+    controlVariable = pidLimit(controlVariable, state.lowerOutputLimit, state.upperOutputLimit);
+    state.outputIncrement = controlVariable - state.lastControlVariable;
+    state.lastControlVariable = controlVariable;
+    state.lastError = error;
+    state.lastDifferentiator = differentiator;
+    state.lastSetpoint = state.setpoint;
+    state.lastProcessVariable = processVariable;
+
+    if(Detailed) {
+        detail->output = controlVariable;
+    }
+    return controlVariable;
+}
+
+#endif  /* PIDSTEP_H */
@@ -0,0 +1,255 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "RelayAutoTuner.h"
+#include <cmath>
+
+//------------------------------------------------------------------------------
+// Constructors
+//------------------------------------------------------------------------------
+
+// Relay amplitude 1, no hysteresis
+RelayAutoTuner::RelayAutoTuner() {
+    this->setAmplitude(1);
+    this->setHysteresis(0);
+    this->setCycles(3);
+    this->setTimeout(0);
+    this->setRule(ZIEGLER_NICHOLS_PID);
+    this->cancel();
+    state = IDLE;
+}
+
+// Relay amplitude and hysteresis
+RelayAutoTuner::RelayAutoTuner(double amplitude, double hysteresis) {
+    this->setAmplitude(amplitude);
+    this->setHysteresis(hysteresis);
+    this->setCycles(3);
+    this->setTimeout(0);
+    this->setRule(ZIEGLER_NICHOLS_PID);
+    this->cancel();
+    state = IDLE;
+}
+
+// Destructor
+RelayAutoTuner::~RelayAutoTuner() {
+}
+
+//------------------------------------------------------------------------------
+// Accessors
+//------------------------------------------------------------------------------
+
+RelayAutoTuner::State RelayAutoTuner::getState() {
+    return state;
+}
+
+// Ultimate gain, valid once FINISHED
+double RelayAutoTuner::getUltimateGain() {
+    return ultimateGain;
+}
+
+// Ultimate period in seconds, valid once FINISHED
+double RelayAutoTuner::getUltimatePeriod() {
+    return ultimatePeriod;
+}
+
+//------------------------------------------------------------------------------
+// getGains
+//------------------------------------------------------------------------------
+//
+// Return Value : bool
+// Parameters   : kp, ki, kd
+//
+// This function computes gains from the measured ultimate gain and period
+// with the rule set by setRule(), in the parallel form used by
+// PIDController (ki = kp/Ti, kd = kp*Td):
+//
+//     ZIEGLER_NICHOLS_PI      kp = 0.45 Ku, Ti = Tu/1.2
+//     ZIEGLER_NICHOLS_PID     kp = 0.6 Ku,  Ti = Tu/2,  Td = Tu/8
+//     SIMC_PI                 kp = Ku/pi,   Ti = 2 Tu
+//
+// SIMC_PI is the SIMC rule with tau_c = theta for an integrating process
+// with dead time theta, for which Tu = 4 theta and Ku = pi/(2 k theta); it
+// is more conservative than Ziegler-Nichols on lag-dominant plants. It
+// returns false and leaves the gains untouched unless tuning has finished.
+//------------------------------------------------------------------------------
+
+bool RelayAutoTuner::getGains(double& kp, double& ki, double& kd) {
+    if(state != FINISHED) {
+        return false;
+    }
+    double ultimateGain = amplitude < 0 ? -this->ultimateGain : this->ultimateGain;
+    switch(rule) {
+        case ZIEGLER_NICHOLS_PI:
+            kp = 0.45 * ultimateGain;
+            ki = kp / (ultimatePeriod / 1.2);
+            kd = 0;
+            break;
+        case SIMC_PI:
+            kp = ultimateGain / M_PI;
+            ki = kp / (2 * ultimatePeriod);
+            kd = 0;
+            break;
+        default:
+            kp = 0.6 * ultimateGain;
+            ki = kp / (ultimatePeriod / 2);
+            kd = kp * (ultimatePeriod / 8);
+            break;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// Mutators
+//------------------------------------------------------------------------------
+
+// Relay amplitude around the bias; negative for reverse-acting plants
+void RelayAutoTuner::setAmplitude(double amplitude) {
+    this->amplitude = amplitude;
+}
+
+// Half width of the band around the setpoint in which the relay holds
+void RelayAutoTuner::setHysteresis(double hysteresis) {
+    this->hysteresis = std::fabs(hysteresis);
+}
+
+// Cycles to measure after the discarded first one, at least 2
+void RelayAutoTuner::setCycles(unsigned cycles) {
+    this->cycles = cycles > 2 ? cycles : 2;
+}
+
+// Seconds after which tuning FAILS if the cycles have not settled; 0 for none
+void RelayAutoTuner::setTimeout(double timeout) {
+    this->timeout = timeout > 0 ? timeout : 0;
+}
+
+void RelayAutoTuner::setRule(Rule rule) {
+    this->rule = rule;
+}
+
+//------------------------------------------------------------------------------
+// Other Functions
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// start
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : bias
+//
+// This function starts a tuning run around the output 'bias', normally the
+// output the loop was holding.
+//------------------------------------------------------------------------------
+
+void RelayAutoTuner::start(double bias) {
+    this->cancel();
+    this->bias = bias;
+    state = RUNNING;
+}
+
+//------------------------------------------------------------------------------
+// cancel
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : None
+//
+// This function abandons a run and clears the measurements.
+//------------------------------------------------------------------------------
+
+void RelayAutoTuner::cancel() {
+    state = IDLE;
+    high = true;
+    elapsed = 0;
+    lastSwitchTime = -1;
+    completedCycles = 0;
+    maximum = -INFINITY;
+    minimum = INFINITY;
+    lastPeriod = 0;
+    lastHalfAmplitude = 0;
+    ultimateGain = 0;
+    ultimatePeriod = 0;
+}
+
+//------------------------------------------------------------------------------
+// step
+//------------------------------------------------------------------------------
+//
+// Return Value : double
+// Parameters   : setpoint, processVariable, samplingTime
+//
+// This function takes one sample while RUNNING and returns the relay output
+// to apply. In any other state it returns the bias.
+//------------------------------------------------------------------------------
+
+double RelayAutoTuner::step(double setpoint, double processVariable, double samplingTime) {
+    if(state != RUNNING) {
+        return bias;
+    }
+    
+    elapsed += samplingTime;
+    if(processVariable > maximum) {
+        maximum = processVariable;
+    }
+    if(processVariable < minimum) {
+        minimum = processVariable;
+    }
+    
+    double error = setpoint - processVariable;
+    if(!high && error > hysteresis) {
+        high = true;
+        this->completeCycle();
+    }
+    else if(high && error < -hysteresis) {
+        high = false;
+    }
+    
+    if(state == RUNNING && timeout > 0 && elapsed > timeout) {
+        state = FAILED;
+    }
+    if(state != RUNNING) {
+        return bias;
+    }
+    return high ? bias + amplitude : bias - amplitude;
+}
+
+//------------------------------------------------------------------------------
+// completeCycle
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : None
+//
+// This function closes the cycle ending at an upward relay switch, and
+// finishes the run once enough consistent cycles have been seen.
+//------------------------------------------------------------------------------
+
+void RelayAutoTuner::completeCycle() {
+    double period = elapsed - lastSwitchTime;
+    double halfAmplitude = (maximum - minimum) / 2;
+    bool measured = lastSwitchTime >= 0;
+    lastSwitchTime = elapsed;
+    maximum = -INFINITY;
+    minimum = INFINITY;
+    if(!measured) {
+        return;     // the first upward switch only opens a cycle
+    }
+    
+    completedCycles++;
+    bool consistent = completedCycles > 2
+                      && std::fabs(period - lastPeriod) <= 0.05 * period
+                      && std::fabs(halfAmplitude - lastHalfAmplitude) <= 0.05 * halfAmplitude;
+    lastPeriod = period;
+    lastHalfAmplitude = halfAmplitude;
+    
+    if(completedCycles > cycles && consistent) {
+        if(!(halfAmplitude > hysteresis)) {
+            state = FAILED;
+            return;
+        }
+        ultimatePeriod = period;
+        ultimateGain = 4 * std::fabs(amplitude) / (M_PI * std::sqrt(halfAmplitude * halfAmplitude - hysteresis * hysteresis));
+        state = FINISHED;
+    }
+}
@@ -0,0 +1,286 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "SharedControllerState.h"
+#include <cstring>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char SEGMENT_MAGIC[8] = { 'P', 'I', 'D', 'S', 'H', 'A', 'R', 'E' };
+
+// Attempts read() makes before giving up on a loop whose writer stopped in
+// the middle of a publish().
+static const unsigned READ_ATTEMPTS = 1000;
+
+// Attempts setParameters() makes to take a loop's writer lock, yielding in
+// between, before giving up on a writer that died holding it.
+static const unsigned WRITE_ATTEMPTS = 100000;
+
+static_assert(sizeof(SharedStateHeader) == 64, "shared state header must stay 64 bytes");
+static_assert(sizeof(SharedLoop) % 64 == 0, "shared loops must stay cache-line aligned");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "shared state needs address-free atomics");
+static_assert(std::atomic<unsigned>::is_always_lock_free, "shared parameter channels need address-free atomics");
+static_assert(std::is_standard_layout<PIDParameterChannel>::value && !std::is_polymorphic<PIDParameterChannel>::value,
+              "shared parameter channels must not hold a vtable pointer, which is only valid in one process");
+
+//------------------------------------------------------------------------------
+// Constructors
+//------------------------------------------------------------------------------
+
+// Not attached to a segment
+SharedControllerState::SharedControllerState() {
+    mapping = 0;
+    length = 0;
+    header = 0;
+    loops = 0;
+}
+
+// Destructor, unmaps the segment but leaves it in place for other processes
+SharedControllerState::~SharedControllerState() {
+    this->close();
+}
+
+//------------------------------------------------------------------------------
+// Accessors
+//------------------------------------------------------------------------------
+
+bool SharedControllerState::isOpen() {
+    return mapping != 0;
+}
+
+size_t SharedControllerState::size() {
+    return header ? header->loops : 0;
+}
+
+// Channel to attach to the controller of 'loop' with setParameterChannel()
+PIDParameterChannel* SharedControllerState::getChannel(size_t loop) {
+    return &loops[loop].channel;
+}
+
+//------------------------------------------------------------------------------
+// Other Functions
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// create
+//------------------------------------------------------------------------------
+//
+// Return Value : bool
+// Parameters   : name, loops
+//
+// This function creates the shared-memory segment 'name' (e.g. "/plant-pid")
+// with room for 'loops' controllers and maps it. A segment left behind under
+// the same name is replaced; processes that still map it keep the old one
+// until they open() again. It returns false if the segment cannot be created.
+//------------------------------------------------------------------------------
+
+bool SharedControllerState::create(const std::string& name, size_t loops) {
+    this->close();
+    shm_unlink(name.c_str());
+    int descriptor = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if(descriptor < 0) {
+        return false;
+    }
+    size_t length = sizeof(SharedStateHeader) + loops * sizeof(SharedLoop);
+    if(ftruncate(descriptor, length) != 0 || !this->map(descriptor, length)) {
+        ::close(descriptor);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    ::close(descriptor);
+    
+    std::memcpy(header->magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC));
+    header->version = SHARED_STATE_VERSION;
+    header->headerSize = sizeof(SharedStateHeader);
+    header->loopSize = sizeof(SharedLoop);
+    header->loops = loops;
+    for(size_t i = 0; i < loops; i++) {
+        SharedLoop* loop = new (&this->loops[i]) SharedLoop;
+        loop->sequence.store(0, std::memory_order_relaxed);
+        loop->writer.store(0, std::memory_order_relaxed);
+        loop->state = PIDState();
+    }
+    header->ready.store(1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// open
+//------------------------------------------------------------------------------
+//
+// Return Value : bool
+// Parameters   : name
+//
+// This function maps the existing segment 'name'. It returns false if there
+// is none, if it is still being created, or if its layout version or sizes
+// differ from this build's.
+//------------------------------------------------------------------------------
+
+bool SharedControllerState::open(const std::string& name) {
+    this->close();
+    int descriptor = shm_open(name.c_str(), O_RDWR, 0);
+    if(descriptor < 0) {
+        return false;
+    }
+    struct stat status;
+    if(fstat(descriptor, &status) != 0 || (size_t)status.st_size < sizeof(SharedStateHeader)
+            || !this->map(descriptor, status.st_size)) {
+        ::close(descriptor);
+        return false;
+    }
+    ::close(descriptor);
+    
+    if(header->ready.load(std::memory_order_acquire) != 1
+            || std::memcmp(header->magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) != 0
+            || header->version != SHARED_STATE_VERSION
+            || header->headerSize != sizeof(SharedStateHeader)
+            || header->loopSize != sizeof(SharedLoop)
+            || sizeof(SharedStateHeader) + (size_t)header->loops * sizeof(SharedLoop) > length) {
+        this->close();
+        return false;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// map
+//------------------------------------------------------------------------------
+//
+// Return Value : bool
+// Parameters   : descriptor, length
+//
+// This function maps 'length' bytes of the segment open on 'descriptor'.
+//------------------------------------------------------------------------------
+
+bool SharedControllerState::map(int descriptor, size_t length) {
+    void* address = mmap(0, length, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    if(address == MAP_FAILED) {
+        return false;
+    }
+    mapping = address;
+    this->length = length;
+    header = (SharedStateHeader*)address;
+    loops = (SharedLoop*)((unsigned char*)address + sizeof(SharedStateHeader));
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// close
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : None
+//
+// This function unmaps the segment. The segment itself stays until remove().
+//------------------------------------------------------------------------------
+
+void SharedControllerState::close() {
+    if(mapping) {
+        munmap(mapping, length);
+    }
+    mapping = 0;
+    length = 0;
+    header = 0;
+    loops = 0;
+}
+
+//------------------------------------------------------------------------------
+// remove
+//------------------------------------------------------------------------------
+//
+// Return Value : bool
+// Parameters   : name
+//
+// This function deletes the segment 'name' once every process has unmapped
+// it.
+//------------------------------------------------------------------------------
+
+bool SharedControllerState::remove(const std::string& name) {
+    return shm_unlink(name.c_str()) == 0;
+}
+
+//------------------------------------------------------------------------------
+// publish
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : loop, pid
+//
+// This function makes the current state of 'pid' visible as 'loop'. It is
+// wait-free: the sequence number is odd while the copy is being written, so
+// readers know to retry instead of the writer waiting for them.
+//------------------------------------------------------------------------------
+
+void SharedControllerState::publish(size_t loop, PIDController& pid) {
+    SharedLoop& shared = loops[loop];
+    PIDState state = pid.getState();
+    uint32_t sequence = shared.sequence.load(std::memory_order_relaxed);
+    shared.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&shared.state, &state, sizeof(state));
+    shared.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+// read
+//------------------------------------------------------------------------------
+//
+// Return Value : bool
+// Parameters   : loop, state
+//
+// This function copies the state last published for 'loop' into 'state'. It
+// returns false and leaves 'state' untouched if no consistent copy could be
+// taken, which only happens when the writer died during a publish().
+//------------------------------------------------------------------------------
+
+bool SharedControllerState::read(size_t loop, PIDState& state) {
+    SharedLoop& shared = loops[loop];
+    for(unsigned attempt = 0; attempt < READ_ATTEMPTS; attempt++) {
+        uint32_t before = shared.sequence.load(std::memory_order_acquire);
+        if(before & 1) {
+            continue;
+        }
+        PIDState copy;
+        std::memcpy(&copy, &shared.state, sizeof(copy));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(shared.sequence.load(std::memory_order_relaxed) == before) {
+            state = copy;
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+// setParameters
+//------------------------------------------------------------------------------
+//
+// Return Value : bool
+// Parameters   : loop, parameters
+//
+// This function sends a new setpoint, gains, and limits to the controller of
+// 'loop', which applies them at its next calc(). Writers in other processes
+// are waited for with the loop's writer lock. It returns false, sending
+// nothing, if the lock stays taken, which only happens when a writer died
+// during a setParameters(); create() the segment again to recover.
+//------------------------------------------------------------------------------
+
+bool SharedControllerState::setParameters(size_t loop, const PIDParameters& parameters) {
+    SharedLoop& shared = loops[loop];
+    for(unsigned attempt = 0; attempt < WRITE_ATTEMPTS; attempt++) {
+        uint32_t unlocked = 0;
+        if(shared.writer.compare_exchange_weak(unlocked, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            shared.channel.publish(parameters);
+            shared.writer.store(0, std::memory_order_release);
+            return true;
+        }
+        std::this_thread::yield();
+    }
+    return false;
+}
@@ -0,0 +1,165 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "StepResponseAnalyzer.h"
+#include <cmath>
+
+//------------------------------------------------------------------------------
+// Constructors
+//------------------------------------------------------------------------------
+
+// Settling band of 2% of the step
+StepResponseAnalyzer::StepResponseAnalyzer() {
+    this->setSettlingBand(0.02);
+    this->reset();
+}
+
+// Settling band as a fraction of the step
+StepResponseAnalyzer::StepResponseAnalyzer(double settlingBand) {
+    this->setSettlingBand(settlingBand);
+    this->reset();
+}
+
+// Destructor
+StepResponseAnalyzer::~StepResponseAnalyzer() {
+}
+
+//------------------------------------------------------------------------------
+// Accessors
+//------------------------------------------------------------------------------
+
+double StepResponseAnalyzer::getSettlingBand() {
+    return settlingBand;
+}
+
+// True while the process variable is within the settling band of the
+// current step.
+bool StepResponseAnalyzer::hasSettled() {
+    return metrics.settled;
+}
+
+StepResponseMetrics StepResponseAnalyzer::getMetrics() {
+    return metrics;
+}
+
+//------------------------------------------------------------------------------
+// Mutators
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// setSettlingBand
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : settlingBand
+//
+// This function sets the settling band as a fraction of the step size, e.g.
+// 0.02 for the usual 2% band. When the setpoint changes by nothing (after a
+// reset, or for disturbance rejection), the band is taken relative to the
+// setpoint instead. It takes effect at the next step.
+//------------------------------------------------------------------------------
+
+void StepResponseAnalyzer::setSettlingBand(double settlingBand) {
+    this->settlingBand = std::fabs(settlingBand);
+}
+
+//------------------------------------------------------------------------------
+// Other Functions
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// reset
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : None
+//
+// This function forgets the current step. The next update() starts a new one.
+//------------------------------------------------------------------------------
+
+void StepResponseAnalyzer::reset() {
+    started = false;
+    this->begin(0, 0);
+}
+
+//------------------------------------------------------------------------------
+// begin
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : setpoint, processVariable
+//
+// This function starts a step from 'processVariable' to 'setpoint'.
+//------------------------------------------------------------------------------
+
+void StepResponseAnalyzer::begin(double setpoint, double processVariable) {
+    const double infinity = INFINITY;
+    double step = setpoint - processVariable;
+    
+    metrics.initialValue = processVariable;
+    metrics.setpoint = setpoint;
+    metrics.elapsed = 0;
+    metrics.riseTime = infinity;
+    metrics.peak = 0;
+    metrics.peakTime = 0;
+    metrics.overshoot = 0;
+    metrics.settlingTime = infinity;
+    metrics.iae = 0;
+    metrics.ise = 0;
+    metrics.settled = false;
+    
+    bandWidth = settlingBand * std::fabs(step != 0 ? step : setpoint);
+    t10 = infinity;
+}
+
+//------------------------------------------------------------------------------
+// update
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : setpoint, processVariable, samplingTime
+//
+// This function takes one sample of the loop: the setpoint in effect, the
+// process variable, and the time since the previous sample. A changed
+// setpoint starts a new step at this sample; otherwise the metrics of the
+// current step are advanced by 'samplingTime'.
+//------------------------------------------------------------------------------
+
+void StepResponseAnalyzer::update(double setpoint, double processVariable, double samplingTime) {
+    if(!started || setpoint != metrics.setpoint) {
+        started = true;
+        this->begin(setpoint, processVariable);
+        return;
+    }
+    
+    metrics.elapsed += samplingTime;
+    double error = setpoint - processVariable;
+    metrics.iae += std::fabs(error) * samplingTime;
+    metrics.ise += error * error * samplingTime;
+    
+    double step = setpoint - metrics.initialValue;
+    if(step != 0) {
+        // Progress along the step, 0 at the initial value and 1 at the setpoint
+        double progress = (processVariable - metrics.initialValue) / step;
+        if(progress > metrics.peak) {
+            metrics.peak = progress;
+            metrics.peakTime = metrics.elapsed;
+            metrics.overshoot = progress > 1 ? (progress - 1) * 100 : 0;
+        }
+        if(t10 == INFINITY && progress >= 0.1) {
+            t10 = metrics.elapsed;
+        }
+        if(metrics.riseTime == INFINITY && progress >= 0.9) {
+            metrics.riseTime = metrics.elapsed - t10;
+        }
+    }
+    
+    metrics.settled = std::fabs(error) <= bandWidth;
+    if(!metrics.settled) {
+        metrics.settlingTime = INFINITY;
+    }
+    else if(metrics.settlingTime == INFINITY) {
+        metrics.settlingTime = metrics.elapsed;
+    }
+}
@@ -0,0 +1,501 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "Telemetry.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//------------------------------------------------------------------------------
+// File format
+//------------------------------------------------------------------------------
+
+static const char FILE_MAGIC[8] = { 'P', 'I', 'D', 'T', 'E', 'L', 'E', 'M' };
+static const uint32_t CHUNK_MAGIC = 0x4B4E4843;  // "CHNK"
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t columns;
+    uint64_t chunkRows;
+    uint64_t reserved;
+};
+
+struct ChunkHeader {
+    uint32_t magic;
+    uint32_t rows;
+    uint64_t firstRow;
+};
+
+static const size_t DEFAULT_CAPACITY = 65536;
+static const size_t DEFAULT_CHUNK_ROWS = 4096;
+
+//------------------------------------------------------------------------------
+// Constructors
+//------------------------------------------------------------------------------
+
+// Room for 65536 samples in the ring, 4096 rows per chunk
+TelemetryRecorder::TelemetryRecorder()
+    : head(0), cachedTail(0), dropped(0), tail(0), running(false),
+      writeErrors(0), writeFailed(false), chunkRows(DEFAULT_CHUNK_ROWS), chunkFill(0), rowsWritten(0), file(0) {
+    ring.resize(DEFAULT_CAPACITY);
+    mask = DEFAULT_CAPACITY - 1;
+}
+
+// Ring capacity, rounded up to a power of two, and rows per chunk
+TelemetryRecorder::TelemetryRecorder(size_t capacity, size_t chunkRows)
+    : head(0), cachedTail(0), dropped(0), tail(0), running(false),
+      writeErrors(0), writeFailed(false), chunkRows(chunkRows > 0 ? chunkRows : 1), chunkFill(0), rowsWritten(0), file(0) {
+    size_t size = 1;
+    while(size < capacity) {
+        size *= 2;
+    }
+    ring.resize(size);
+    mask = size - 1;
+}
+
+// Destructor
+TelemetryRecorder::~TelemetryRecorder() {
+    this->close();
+}
+
+// Nothing mapped
+TelemetryReader::TelemetryReader() : mapping(0), length(0), rows(0) {
+}
+
+// Destructor
+TelemetryReader::~TelemetryReader() {
+    this->close();
+}
+
+//------------------------------------------------------------------------------
+// Accessors
+//------------------------------------------------------------------------------
+
+bool TelemetryRecorder::isOpen() {
+    return file != 0;
+}
+
+// Samples accepted by record() so far.
+uint64_t TelemetryRecorder::getRecorded() {
+    return head.load(std::memory_order_relaxed);
+}
+
+// Samples record() dropped because the ring was full.
+uint64_t TelemetryRecorder::getDropped() {
+    return dropped.load(std::memory_order_relaxed);
+}
+
+// Samples the writer could not write to the file since open().
+uint64_t TelemetryRecorder::getWriteErrors() {
+    return writeErrors.load(std::memory_order_relaxed);
+}
+
+bool TelemetryReader::isOpen() {
+    return mapping != 0;
+}
+
+// Total number of rows.
+size_t TelemetryReader::size() {
+    return rows;
+}
+
+size_t TelemetryReader::getChunks() {
+    return chunkData.size();
+}
+
+size_t TelemetryReader::getRows(size_t chunk) {
+    return chunk < chunkRows.size() ? chunkRows[chunk] : 0;
+}
+
+//------------------------------------------------------------------------------
+// column
+//------------------------------------------------------------------------------
+//
+// Return Value : const double*
+// Parameters   : chunk, column
+//
+// This function returns the getRows(chunk) values of 'column' in 'chunk', or
+// null if there is no such chunk or column.
+//------------------------------------------------------------------------------
+
+const double* TelemetryReader::column(size_t chunk, TelemetryColumn column) {
+    if(chunk >= chunkData.size() || column < 0 || column >= TELEMETRY_COLUMNS) {
+        return 0;
+    }
+    return chunkData[chunk] + column * chunkRows[chunk];
+}
+
+//------------------------------------------------------------------------------
+// getSample
+//------------------------------------------------------------------------------
+//
+// Return Value : bool
+// Parameters   : index, sample
+//
+// This function reassembles row 'index' of the file into 'sample'. It returns
+// false if there is no such row.
+//------------------------------------------------------------------------------
+
+bool TelemetryReader::getSample(size_t index, TelemetrySample& sample) {
+    if(index >= rows) {
+        return false;
+    }
+    size_t chunk = std::upper_bound(firstRows.begin(), firstRows.end(), index) - firstRows.begin() - 1;
+    size_t row = index - firstRows[chunk];
+    size_t stride = chunkRows[chunk];
+    const double* values = chunkData[chunk] + row;
+    
+    sample.time = values[TELEMETRY_TIME * stride];
+    sample.channel = (uint32_t)values[TELEMETRY_CHANNEL * stride];
+    sample.setpoint = values[TELEMETRY_SETPOINT * stride];
+    sample.processVariable = values[TELEMETRY_PROCESS_VARIABLE * stride];
+    sample.error = values[TELEMETRY_ERROR * stride];
+    sample.proportional = values[TELEMETRY_PROPORTIONAL * stride];
+    sample.integral = values[TELEMETRY_INTEGRAL * stride];
+    sample.derivative = values[TELEMETRY_DERIVATIVE * stride];
+    sample.output = values[TELEMETRY_OUTPUT * stride];
+    sample.samplingTime = values[TELEMETRY_SAMPLING_TIME * stride];
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// columnName
+//------------------------------------------------------------------------------
+//
+// Return Value : const char*
+// Parameters   : column
+//
+// This function returns the name of 'column' as used in CSV headers.
+//------------------------------------------------------------------------------
+
+const char* TelemetryReader::columnName(TelemetryColumn column) {
+    switch(column) {
+        case TELEMETRY_TIME:                return "time";
+        case TELEMETRY_CHANNEL:             return "channel";
+        case TELEMETRY_SETPOINT:            return "setpoint";
+        case TELEMETRY_PROCESS_VARIABLE:    return "processVariable";
+        case TELEMETRY_ERROR:               return "error";
+        case TELEMETRY_PROPORTIONAL:        return "proportional";
+        case TELEMETRY_INTEGRAL:            return "integral";
+        case TELEMETRY_DERIVATIVE:          return "derivative";
+        case TELEMETRY_OUTPUT:              return "output";
+        case TELEMETRY_SAMPLING_TIME:       return "samplingTime";
+        default:                            return "";
+    }
+}
+
+//------------------------------------------------------------------------------
+// Mutators
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// record
+//------------------------------------------------------------------------------
+//
+// Return Value : bool
+// Parameters   : sample
+//
+// This function queues 'sample' for the writer. It never blocks: it returns
+// false and counts the sample as dropped if the ring is full. Samples
+// recorded before open() are written once the file is open.
+//------------------------------------------------------------------------------
+
+bool TelemetryRecorder::record(const TelemetrySample& sample) {
+    size_t position = head.load(std::memory_order_relaxed);
+    if(position - cachedTail > mask) {
+        cachedTail = tail.load(std::memory_order_acquire);
+        if(position - cachedTail > mask) {
+            dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    ring[position & mask] = sample;
+    head.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// record
+//------------------------------------------------------------------------------
+//
+// Return Value : bool
+// Parameters   : time, channel, output
+//
+// This function records the result of a PIDController::calcDetailed() taken
+// at 'time', like record(sample).
+//------------------------------------------------------------------------------
+
+bool TelemetryRecorder::record(double time, uint32_t channel, const PIDOutput& output) {
+    TelemetrySample sample;
+    sample.time = time;
+    sample.channel = channel;
+    sample.setpoint = output.setpoint;
+    sample.processVariable = output.processVariable;
+    sample.error = output.error;
+    sample.proportional = output.proportional;
+    sample.integral = output.integral;
+    sample.derivative = output.derivative;
+    sample.output = output.output;
+    sample.samplingTime = output.samplingTime;
+    return this->record(sample);
+}
+
+//------------------------------------------------------------------------------
+// Other Functions
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// open
+//------------------------------------------------------------------------------
+//
+// Return Value : bool
+// Parameters   : path
+//
+// This function creates the telemetry file at 'path', writes its header, and
+// starts the writer thread. It returns false if the recorder is already open
+// or the file cannot be created.
+//------------------------------------------------------------------------------
+
+bool TelemetryRecorder::open(const std::string& path) {
+    if(file) {
+        return false;
+    }
+    file = std::fopen(path.c_str(), "wb");
+    if(!file) {
+        return false;
+    }
+    
+    FileHeader header;
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.version = TELEMETRY_VERSION;
+    header.columns = TELEMETRY_COLUMNS;
+    header.chunkRows = chunkRows;
+    header.reserved = 0;
+    if(std::fwrite(&header, sizeof(header), 1, file) != 1) {
+        std::fclose(file);
+        file = 0;
+        return false;
+    }
+    
+    chunk.assign(chunkRows * TELEMETRY_COLUMNS, 0);
+    chunkFill = 0;
+    rowsWritten = 0;
+    writeErrors.store(0);
+    writeFailed = false;
+    running.store(true);
+    writer = std::thread(&TelemetryRecorder::run, this);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// close
+//------------------------------------------------------------------------------
+//
+// Return Value : bool
+// Parameters   : None
+//
+// This function stops the writer once it has written every sample recorded so
+// far, including a last partial chunk, and closes the file. It returns false
+// if any write failed, so that the file misses samples that getRecorded()
+// counts.
+//------------------------------------------------------------------------------
+
+bool TelemetryRecorder::close() {
+    if(!file) {
+        return true;
+    }
+    running.store(false);
+    if(writer.joinable()) {
+        writer.join();
+    }
+    if(std::fclose(file) != 0) {
+        writeFailed = true;
+    }
+    file = 0;
+    return !writeFailed;
+}
+
+//------------------------------------------------------------------------------
+// run
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : None
+//
+// This function is the writer thread: it drains the ring until asked to stop,
+// sleeping for a millisecond whenever it finds the ring empty, so the
+// recording side never has to wake it.
+//------------------------------------------------------------------------------
+
+void TelemetryRecorder::run() {
+    while(true) {
+        bool stopping = !running.load();
+        if(this->drain() == 0) {
+            if(stopping) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    if(chunkFill > 0) {
+        this->writeChunk();
+    }
+}
+
+//------------------------------------------------------------------------------
+// drain
+//------------------------------------------------------------------------------
+//
+// Return Value : size_t
+// Parameters   : None
+//
+// This function moves every queued sample from the ring into the chunk
+// columns, writing out each chunk as it fills. It returns the number of
+// samples moved.
+//------------------------------------------------------------------------------
+
+size_t TelemetryRecorder::drain() {
+    size_t first = tail.load(std::memory_order_relaxed);
+    size_t last = head.load(std::memory_order_acquire);
+    for(size_t position = first; position != last; position++) {
+        const TelemetrySample& sample = ring[position & mask];
+        double* row = &chunk[chunkFill];
+        row[TELEMETRY_TIME * chunkRows] = sample.time;
+        row[TELEMETRY_CHANNEL * chunkRows] = sample.channel;
+        row[TELEMETRY_SETPOINT * chunkRows] = sample.setpoint;
+        row[TELEMETRY_PROCESS_VARIABLE * chunkRows] = sample.processVariable;
+        row[TELEMETRY_ERROR * chunkRows] = sample.error;
+        row[TELEMETRY_PROPORTIONAL * chunkRows] = sample.proportional;
+        row[TELEMETRY_INTEGRAL * chunkRows] = sample.integral;
+        row[TELEMETRY_DERIVATIVE * chunkRows] = sample.derivative;
+        row[TELEMETRY_OUTPUT * chunkRows] = sample.output;
+        row[TELEMETRY_SAMPLING_TIME * chunkRows] = sample.samplingTime;
+        if(++chunkFill == chunkRows) {
+            this->writeChunk();
+        }
+    }
+    tail.store(last, std::memory_order_release);
+    return last - first;
+}
+
+//------------------------------------------------------------------------------
+// writeChunk
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : None
+//
+// This function writes the rows collected so far as one chunk, column after
+// column, and starts a new chunk. The chunk is flushed, so a failure is
+// counted against the rows that were lost. Once a write has failed, the rest
+// of the file could not be read back in step with the chunk headers, so the
+// rows of this and every later chunk are only counted as write errors.
+//------------------------------------------------------------------------------
+
+void TelemetryRecorder::writeChunk() {
+    if(!writeFailed) {
+        ChunkHeader header;
+        header.magic = CHUNK_MAGIC;
+        header.rows = chunkFill;
+        header.firstRow = rowsWritten;
+        writeFailed = std::fwrite(&header, sizeof(header), 1, file) != 1;
+        for(size_t column = 0; column < TELEMETRY_COLUMNS && !writeFailed; column++) {
+            writeFailed = std::fwrite(&chunk[column * chunkRows], sizeof(double), chunkFill, file) != chunkFill;
+        }
+        if(!writeFailed) {
+            writeFailed = std::fflush(file) != 0;
+        }
+    }
+    if(writeFailed) {
+        writeErrors.fetch_add(chunkFill, std::memory_order_relaxed);
+    }
+    rowsWritten += chunkFill;
+    chunkFill = 0;
+}
+
+//------------------------------------------------------------------------------
+// open
+//------------------------------------------------------------------------------
+//
+// Return Value : bool
+// Parameters   : path
+//
+// This function maps the telemetry file at 'path' and indexes its chunks,
+// stopping at the first incomplete one. It returns false if the file cannot
+// be mapped or is not a telemetry file of this version.
+//------------------------------------------------------------------------------
+
+bool TelemetryReader::open(const std::string& path) {
+    this->close();
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if(descriptor < 0) {
+        return false;
+    }
+    struct stat status;
+    if(fstat(descriptor, &status) != 0 || (size_t)status.st_size < sizeof(FileHeader)) {
+        ::close(descriptor);
+        return false;
+    }
+    length = status.st_size;
+    void* address = mmap(0, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+    if(address == MAP_FAILED) {
+        length = 0;
+        return false;
+    }
+    mapping = address;
+    
+    const unsigned char* bytes = (const unsigned char*)mapping;
+    FileHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+    if(std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0
+            || header.version != TELEMETRY_VERSION || header.columns != TELEMETRY_COLUMNS) {
+        this->close();
+        return false;
+    }
+    
+    size_t offset = sizeof(FileHeader);
+    while(offset + sizeof(ChunkHeader) <= length) {
+        ChunkHeader chunk;
+        std::memcpy(&chunk, bytes + offset, sizeof(chunk));
+        size_t data = offset + sizeof(ChunkHeader);
+        size_t end = data + (size_t)chunk.rows * TELEMETRY_COLUMNS * sizeof(double);
+        if(chunk.magic != CHUNK_MAGIC || chunk.firstRow != rows || end > length) {
+            break;
+        }
+        chunkData.push_back((const double*)(bytes + data));
+        chunkRows.push_back(chunk.rows);
+        firstRows.push_back(rows);
+        rows += chunk.rows;
+        offset = end;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// close
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : None
+//
+// This function unmaps the file. Column pointers from it become invalid.
+//------------------------------------------------------------------------------
+
+void TelemetryReader::close() {
+    if(mapping) {
+        munmap(mapping, length);
+    }
+    mapping = 0;
+    length = 0;
+    chunkData.clear();
+    chunkRows.clear();
+    firstRows.clear();
+    rows = 0;
+}
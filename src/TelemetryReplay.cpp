@@ -0,0 +1,252 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include "TelemetryReplay.h"
+#include <cmath>
+#include <limits>
+#include <thread>
+
+//------------------------------------------------------------------------------
+// Constructors
+//------------------------------------------------------------------------------
+
+// Any difference above 1e-9 counts as a divergence
+TelemetryReplay::TelemetryReplay() {
+    this->setTolerance(1e-9);
+}
+
+// A given divergence tolerance
+TelemetryReplay::TelemetryReplay(double tolerance) {
+    this->setTolerance(tolerance);
+}
+
+// Destructor
+TelemetryReplay::~TelemetryReplay() {
+}
+
+//------------------------------------------------------------------------------
+// Accessors
+//------------------------------------------------------------------------------
+
+double TelemetryReplay::getTolerance() {
+    return tolerance;
+}
+
+size_t TelemetryReplay::getControllers() {
+    return replays.size();
+}
+
+//------------------------------------------------------------------------------
+// getStatistics
+//------------------------------------------------------------------------------
+//
+// Return Value : ReplayStatistics
+// Parameters   : controller
+//
+// This function returns the divergence of controller number 'controller', in
+// the order they were added, from the last run(). An unknown controller has
+// no samples.
+//------------------------------------------------------------------------------
+
+ReplayStatistics TelemetryReplay::getStatistics(size_t controller) {
+    if(controller >= replays.size()) {
+        ReplayStatistics none = ReplayStatistics();
+        none.maxDifferenceTime = std::numeric_limits<double>::infinity();
+        none.firstDivergenceTime = std::numeric_limits<double>::infinity();
+        return none;
+    }
+    return replays[controller].statistics;
+}
+
+//------------------------------------------------------------------------------
+// Mutators
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// add
+//------------------------------------------------------------------------------
+//
+// Return Value : size_t
+// Parameters   : controller, channel
+//
+// This function adds 'controller' to replay the samples recorded on
+// 'channel'. Several controllers may replay the same channel, e.g. one per
+// gain variant. The controller is not configured or reset: set it up, and
+// turn it on, the way the recorded loop was. It returns the number of
+// controllers added so far.
+//------------------------------------------------------------------------------
+
+size_t TelemetryReplay::add(PIDController* controller, uint32_t channel) {
+    if(!controller) {
+        return replays.size();
+    }
+    Replay replay = Replay();
+    replay.controller = controller;
+    replay.channel = channel;
+    replays.push_back(replay);
+    return replays.size();
+}
+
+// Removes every controller.
+void TelemetryReplay::clear() {
+    replays.clear();
+}
+
+//------------------------------------------------------------------------------
+// setTolerance
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : tolerance
+//
+// This function sets the largest |difference| that is not counted as a
+// divergence. It applies to the next run().
+//------------------------------------------------------------------------------
+
+void TelemetryReplay::setTolerance(double tolerance) {
+    this->tolerance = std::fabs(tolerance);
+}
+
+//------------------------------------------------------------------------------
+// Other Functions
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+// run
+//------------------------------------------------------------------------------
+//
+// Return Value : bool
+// Parameters   : reader
+//
+// This function replays 'reader' with one worker thread per hardware thread.
+//------------------------------------------------------------------------------
+
+bool TelemetryReplay::run(TelemetryReader& reader) {
+    return this->run(reader, std::thread::hardware_concurrency());
+}
+
+//------------------------------------------------------------------------------
+// run
+//------------------------------------------------------------------------------
+//
+// Return Value : bool
+// Parameters   : reader, threads
+//
+// This function replays every recorded sample of 'reader' through the
+// controllers of its channel, on at most 'threads' worker threads (0 means
+// one), and returns when all of them are done. The controllers are divided
+// into contiguous shares, one per thread, and each thread walks the file
+// chunk by chunk, so a chunk is read from memory once per thread rather than
+// once per controller. It returns false, replaying nothing, if 'reader' is
+// not open.
+//------------------------------------------------------------------------------
+
+bool TelemetryReplay::run(TelemetryReader& reader, unsigned threads) {
+    if(!reader.isOpen()) {
+        return false;
+    }
+    if(threads == 0) {
+        threads = 1;
+    }
+    if(threads > replays.size()) {
+        threads = replays.size();
+    }
+    if(threads <= 1) {
+        this->replay(&reader, 0, replays.size());
+        return true;
+    }
+
+    std::vector<std::thread> workers;
+    for(unsigned i = 0; i < threads; i++) {
+        size_t first = replays.size() * i / threads;
+        size_t last = replays.size() * (i + 1) / threads;
+        workers.push_back(std::thread(&TelemetryReplay::replay, this, &reader, first, last));
+    }
+    for(size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// replay
+//------------------------------------------------------------------------------
+//
+// Return Value : None
+// Parameters   : reader, first, last
+//
+// Worker body: replays the whole file through controllers [first, last). The
+// sums are kept in locals for each chunk so that threads do not write to
+// neighbouring replays in the inner loop.
+//------------------------------------------------------------------------------
+
+void TelemetryReplay::replay(TelemetryReader* reader, size_t first, size_t last) {
+    const double infinity = std::numeric_limits<double>::infinity();
+    for(size_t i = first; i < last; i++) {
+        replays[i].statistics = ReplayStatistics();
+        replays[i].statistics.maxDifferenceTime = infinity;
+        replays[i].statistics.firstDivergenceTime = infinity;
+        replays[i].sumDifference = 0;
+        replays[i].sumSquares = 0;
+    }
+
+    for(size_t chunk = 0; chunk < reader->getChunks(); chunk++) {
+        size_t rows = reader->getRows(chunk);
+        const double* time = reader->column(chunk, TELEMETRY_TIME);
+        const double* channel = reader->column(chunk, TELEMETRY_CHANNEL);
+        const double* setpoint = reader->column(chunk, TELEMETRY_SETPOINT);
+        const double* processVariable = reader->column(chunk, TELEMETRY_PROCESS_VARIABLE);
+        const double* output = reader->column(chunk, TELEMETRY_OUTPUT);
+        const double* samplingTime = reader->column(chunk, TELEMETRY_SAMPLING_TIME);
+
+        for(size_t i = first; i < last; i++) {
+            Replay& replay = replays[i];
+            PIDController* controller = replay.controller;
+            double replayChannel = replay.channel;
+            ReplayStatistics statistics = replay.statistics;
+            double sumDifference = 0;
+            double sumSquares = 0;
+
+            for(size_t row = 0; row < rows; row++) {
+                if(channel[row] != replayChannel || !(samplingTime[row] > 0)) {
+                    continue;
+                }
+                double replayed = controller->track(setpoint[row], processVariable[row], samplingTime[row]);
+                double difference = std::fabs(replayed - output[row]);
+                if(!(difference <= infinity)) {
+                    // NaN, from a NaN output or from inf - inf. Equal
+                    // outputs, or NaN on both sides, were reproduced;
+                    // anything else is the largest divergence there is.
+                    bool reproduced = replayed == output[row] || (std::isnan(replayed) && std::isnan(output[row]));
+                    difference = reproduced ? 0 : infinity;
+                }
+                statistics.samples++;
+                sumDifference += difference;
+                sumSquares += difference * difference;
+                if(difference > statistics.maxDifference) {
+                    statistics.maxDifference = difference;
+                    statistics.maxDifferenceTime = time[row];
+                }
+                if(difference > tolerance) {
+                    if(statistics.diverged == 0) {
+                        statistics.firstDivergenceTime = time[row];
+                    }
+                    statistics.diverged++;
+                }
+            }
+
+            replay.statistics = statistics;
+            replay.sumDifference += sumDifference;
+            replay.sumSquares += sumSquares;
+        }
+    }
+
+    for(size_t i = first; i < last; i++) {
+        ReplayStatistics& statistics = replays[i].statistics;
+        if(statistics.samples > 0) {
+            statistics.meanDifference = replays[i].sumDifference / statistics.samples;
+            statistics.rmsDifference = std::sqrt(replays[i].sumSquares / statistics.samples);
+        }
+    }
+}
@@ -0,0 +1,98 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <PIDController.h>
+#include <gtest/gtest.h>
+#include <cstring>
+
+//------------------------------------------------------------------------------
+// calcDetailed() reports the terms of the one computation calc() would do, in
+// every mode, and they add up to the output while it is not limited.
+//------------------------------------------------------------------------------
+
+class CalcDetailedModes : public ::testing::TestWithParam<std::tuple<int, int, int>> {
+};
+
+TEST_P(CalcDetailedModes, TermsAddUpToTheOutput) {
+    PIDController detailed(1.5, 4, 0.02, -100, 100), plain(1.5, 4, 0.02, -100, 100);
+    PIDController* both[] = { &detailed, &plain };
+    for(PIDController* pid : both) {
+        pid->setAlgorithm((PIDController::Algorithm)std::get<0>(GetParam()));
+        pid->setDerivativeMode((PIDController::DerivativeMode)std::get<1>(GetParam()));
+        pid->setAntiWindup((PIDController::AntiWindup)std::get<2>(GetParam()));
+        pid->targetSetpoint(1);
+        pid->on();
+    }
+    double plant = 0;
+    for(int k = 0; k < 500; k++) {
+        PIDOutput terms = detailed.calcDetailed(plant, 0.01);
+        ASSERT_EQ(plain.calc(plant, 0.01), terms.output) << "step " << k;
+        EXPECT_EQ(1, terms.setpoint);
+        EXPECT_EQ(plant, terms.processVariable);
+        EXPECT_EQ(0.01, terms.samplingTime);
+        EXPECT_EQ(1 - plant, terms.error);
+        EXPECT_EQ(1.5 * terms.error, terms.proportional);
+        EXPECT_NEAR(terms.output, terms.proportional + terms.integral + terms.derivative, 1e-12) << "step " << k;
+        plant += 0.01 * (terms.output - plant) / 0.1;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(AllModes, CalcDetailedModes,
+    ::testing::Combine(::testing::Values((int)PIDController::POSITIONAL, (int)PIDController::VELOCITY),
+                       ::testing::Values((int)PIDController::DERIVATIVE_ON_SETPOINT, (int)PIDController::DERIVATIVE_ON_MEASUREMENT),
+                       ::testing::Values((int)PIDController::OUTPUT_CLAMP, (int)PIDController::CONDITIONAL_INTEGRATION,
+                                         (int)PIDController::BACK_CALCULATION, (int)PIDController::INTEGRATOR_CLAMP)));
+
+TEST(CalcDetailed, OutputIsLimitedButTheTermsAreNot) {
+    PIDController pid(10, 0, 0, -1, 1);
+    pid.targetSetpoint(1);
+    pid.on();
+    PIDOutput terms = pid.calcDetailed(0, 0.01);
+    EXPECT_EQ(10, terms.proportional);
+    EXPECT_EQ(1, terms.output);
+}
+
+//------------------------------------------------------------------------------
+// PIDState is plain data: a memcpy of a snapshot restores a controller that
+// continues exactly where the original is.
+//------------------------------------------------------------------------------
+
+TEST(PIDState, MemcpySnapshotResumesBitForBit) {
+    PIDController pid(2, 3, 0.05, -5, 5);
+    pid.setDerivativeMode(PIDController::DERIVATIVE_ON_MEASUREMENT);
+    pid.setDerivativeFilter(0.02);
+    pid.setAntiWindup(PIDController::BACK_CALCULATION);
+    pid.targetSetpoint(2);
+    pid.on();
+    for(int k = 0; k < 200; k++) {
+        pid.calc(0.001 * k, 0.01);
+    }
+    
+    unsigned char checkpoint[sizeof(PIDState)];
+    PIDState snapshot = pid.getState();
+    std::memcpy(checkpoint, &snapshot, sizeof(checkpoint));
+    PIDState restored;
+    std::memcpy(&restored, checkpoint, sizeof(restored));
+    PIDController standby;
+    standby.setState(restored);
+    
+    EXPECT_EQ(PIDController::DERIVATIVE_ON_MEASUREMENT, standby.getDerivativeMode());
+    EXPECT_EQ(PIDController::BACK_CALCULATION, standby.getAntiWindup());
+    for(int k = 0; k < 200; k++) {
+        ASSERT_EQ(pid.calc(0.2 + 0.002 * k, 0.01), standby.calc(0.2 + 0.002 * k, 0.01)) << "step " << k;
+    }
+}
+
+TEST(PIDState, OutOfRangeModesFallBackToTheDefaults) {
+    PIDController pid;
+    PIDState snapshot = pid.getState();
+    snapshot.algorithm = 200;
+    snapshot.derivativeMode = 200;
+    snapshot.antiWindup = 200;
+    PIDController restored;
+    restored.setState(snapshot);
+    EXPECT_EQ(PIDController::POSITIONAL, restored.getAlgorithm());
+    EXPECT_EQ(PIDController::DERIVATIVE_ON_SETPOINT, restored.getDerivativeMode());
+    EXPECT_EQ(PIDController::OUTPUT_CLAMP, restored.getAntiWindup());
+}
@@ -0,0 +1,110 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <CascadeController.h>
+#include <PIDController.h>
+#include <gtest/gtest.h>
+#include <cmath>
+
+typedef pid::PIDController<double, pid::OutputLimits, pid::FixedTimestep> Loop;
+
+//------------------------------------------------------------------------------
+// A cascade steps like the same loops chained by hand, for header-only and
+// compiled stages alike.
+//------------------------------------------------------------------------------
+
+template <class Stage>
+static void expectCascadeMatchesChainedLoops() {
+    pid::CascadeController<Stage, Stage> cascade;
+    Stage outer, inner;
+    cascade.outer().setGains(2, 1, 0);
+    cascade.inner().setGains(5, 20, 0.01);
+    cascade.outer().setOutputLimits(-3, 3);
+    cascade.inner().setOutputLimits(-10, 10);
+    outer.setGains(2, 1, 0);
+    inner.setGains(5, 20, 0.01);
+    outer.setOutputLimits(-3, 3);
+    inner.setOutputLimits(-10, 10);
+    cascade.on();
+    outer.on();
+    inner.on();
+    cascade.targetSetpoint(1);
+    outer.targetSetpoint(1);
+    
+    double slow = 0, fast = 0;
+    for(int k = 0; k < 2000; k++) {
+        double chained = inner.track(outer.calc(slow, 0.01), fast, 0.01);
+        ASSERT_EQ(chained, cascade.calc(slow, fast, 0.01)) << "step " << k;
+        fast += 0.01 * (chained - fast) / 0.05;
+        slow += 0.01 * (fast - slow) / 0.5;
+    }
+    EXPECT_NEAR(1, slow, 1e-3);
+}
+
+TEST(CascadeController, HeaderOnlyStagesMatchChainedLoops) {
+    expectCascadeMatchesChainedLoops<Loop>();
+}
+
+TEST(CascadeController, CompiledStagesMatchChainedLoops) {
+    expectCascadeMatchesChainedLoops<PIDController>();
+}
+
+TEST(CascadeController, OffHoldsBothLoops) {
+    pid::CascadeController<PIDController, PIDController> cascade;
+    cascade.outer().setGains(1, 0, 0);
+    cascade.inner().setGains(1, 0, 0);
+    cascade.on();
+    cascade.targetSetpoint(1);
+    double held = cascade.calc(0, 0, 0.01);
+    cascade.off();
+    EXPECT_EQ(held, cascade.calc(0.5, 0.5, 0.01));
+}
+
+//------------------------------------------------------------------------------
+// FeedForward adds its terms to the stage's output and limits the sum.
+//------------------------------------------------------------------------------
+
+TEST(FeedForward, AddsBothTermsBeforeLimiting) {
+    pid::FeedForward<Loop> stage;
+    Loop feedback;
+    stage.controller().setGains(2, 0, 0);
+    feedback.setGains(2, 0, 0);
+    stage.setSetpointGain(0.5);
+    stage.setFeedForward(0.25);
+    stage.on();
+    feedback.on();
+    EXPECT_EQ(feedback.track(2, 1.5, 0.01) + 0.5 * 2 + 0.25, stage.track(2, 1.5, 0.01));
+    
+    stage.setOutputLimits(-1, 1);
+    EXPECT_EQ(1, stage.track(2, 1.5, 0.01));
+    stage.setFeedForward(-10);
+    EXPECT_EQ(-1, stage.track(2, 1.5, 0.01));
+}
+
+TEST(FeedForward, CalcUsesTheStageSetpoint) {
+    pid::FeedForward<Loop> a, b;
+    a.controller().setGains(1, 0, 0);
+    b.controller().setGains(1, 0, 0);
+    a.setSetpointGain(2);
+    b.setSetpointGain(2);
+    a.on();
+    b.on();
+    a.targetSetpoint(3);
+    EXPECT_EQ(b.track(3, 1, 0.01), a.calc(1, 0.01));
+}
+
+TEST(FeedForward, SetpointGainRemovesTheSteadyStateOffsetOfAPController) {
+    // Plant y' = (u - y)/tau has unit DC gain, so a setpoint gain of 1 lets a
+    // P-only loop hold its setpoint without an integrator.
+    pid::FeedForward<Loop> stage;
+    stage.controller().setGains(3, 0, 0);
+    stage.setSetpointGain(1);
+    stage.on();
+    double plant = 0;
+    for(int k = 0; k < 5000; k++) {
+        double output = stage.track(2, plant, 0.001);
+        plant += 0.001 * (output - plant) / 0.1;
+    }
+    EXPECT_NEAR(2, plant, 1e-9);
+}
@@ -0,0 +1,87 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <CompactPIDController.h>
+#include <PIDController.h>
+#include <gtest/gtest.h>
+#include <cstring>
+
+//------------------------------------------------------------------------------
+// CompactPIDController and PIDController share one step, so they must agree
+// bit for bit in every mode: both are run in closed loop through setpoint
+// steps, varying sampling times, and an off/on cycle, and the snapshots of
+// one must resume the other exactly.
+//------------------------------------------------------------------------------
+
+static const int STEPS = 20000;
+
+class CompactModes : public ::testing::TestWithParam<std::tuple<int, int, int, bool> > {};
+
+TEST_P(CompactModes, MatchesPIDControllerBitForBit) {
+    PIDController pid(2.0, 1.5, 0.05, -5, 5, -1, 1);
+    CompactPIDController compact(2.0, 1.5, 0.05, -5, 5, -1, 1);
+    pid.setAlgorithm((PIDController::Algorithm)std::get<0>(GetParam()));
+    compact.setAlgorithm((PIDController::Algorithm)std::get<0>(GetParam()));
+    pid.setDerivativeMode((PIDController::DerivativeMode)std::get<1>(GetParam()));
+    compact.setDerivativeMode((PIDController::DerivativeMode)std::get<1>(GetParam()));
+    pid.setAntiWindup((PIDController::AntiWindup)std::get<2>(GetParam()));
+    compact.setAntiWindup((PIDController::AntiWindup)std::get<2>(GetParam()));
+    if(std::get<3>(GetParam())) {
+        pid.setDerivativeFilter(0.01);
+        compact.setDerivativeFilter(0.01);
+    }
+    pid.setIntegratorLimits(-0.5, 0.5);
+    compact.setIntegratorLimits(-0.5, 0.5);
+    pid.setSamplingPeriod(0.001);
+    compact.setSamplingPeriod(0.001);
+    pid.on();
+    compact.on();
+    double plant = 0;
+    for(int k = 0; k < STEPS; k++) {
+        if(k % 3000 == 0) {
+            double setpoint = (k / 3000) % 2 ? -3 : 1;
+            pid.targetSetpoint(setpoint);
+            compact.targetSetpoint(setpoint);
+        }
+        double samplingTime = 0.001 * (1 + ((k * 7) % 5) * 0.1);
+        double expected = k % 2 ? pid.calc(plant, samplingTime) : pid.calc(plant);
+        double output = k % 2 ? compact.calc(plant, samplingTime) : compact.calc(plant);
+        ASSERT_EQ(0, std::memcmp(&expected, &output, sizeof(double)))
+            << "step " << k << ": " << expected << " != " << output;
+        if(k == 7000) {
+            pid.off();
+            compact.off();
+        }
+        if(k == 7500) {
+            pid.on();
+            compact.on();
+        }
+        plant += 0.001 * (expected - plant) / 0.2;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(AllModes, CompactModes,
+    ::testing::Combine(::testing::Values((int)PIDController::POSITIONAL, (int)PIDController::VELOCITY),
+                       ::testing::Values((int)PIDController::DERIVATIVE_ON_SETPOINT, (int)PIDController::DERIVATIVE_ON_MEASUREMENT),
+                       ::testing::Values((int)PIDController::OUTPUT_CLAMP, (int)PIDController::CONDITIONAL_INTEGRATION,
+                                         (int)PIDController::BACK_CALCULATION, (int)PIDController::INTEGRATOR_CLAMP),
+                       ::testing::Bool()));
+
+TEST(CompactPIDController, SnapshotsResumeEitherWay) {
+    PIDController pid(1, 2, 0.1, 0.001);
+    pid.targetSetpoint(1);
+    pid.on();
+    for(int k = 0; k < 100; k++) {
+        pid.calc(0.3);
+    }
+    CompactPIDController compact(pid.getState());
+    for(int k = 0; k < 1000; k++) {
+        ASSERT_EQ(pid.calc(0.4), compact.calc(0.4)) << "step " << k;
+    }
+    PIDController resumed;
+    resumed.setState(compact.getState());
+    for(int k = 0; k < 10; k++) {
+        ASSERT_EQ(pid.calc(0.5), resumed.calc(0.5)) << "step " << k;
+    }
+}
@@ -0,0 +1,56 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <ControlScheduler.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// The workers step their own copies of the controllers and write them back
+// on stop(), so after a run the added controllers hold the state that
+// produced the last output their sinks received.
+//------------------------------------------------------------------------------
+
+TEST(ControlScheduler, StopWritesTheWorkersStateBack) {
+    const size_t loops = 6;
+    std::vector<PIDController> controllers(loops);
+    std::vector<std::shared_ptr<std::vector<double> > > outputs(loops);
+    ControlScheduler scheduler(2);
+    for(size_t i = 0; i < loops; i++) {
+        controllers[i].setGains(1.0 + i, 0.5, 0);
+        controllers[i].on();
+        controllers[i].targetSetpoint(1.0);
+        outputs[i] = std::make_shared<std::vector<double> >();
+        std::shared_ptr<std::vector<double> > output = outputs[i];
+        scheduler.add(&controllers[i], 500, [] { return 0.25; },
+                      [output](double value) { output->push_back(value); });
+    }
+    ASSERT_TRUE(scheduler.start());
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    scheduler.stop();
+    EXPECT_EQ(0, scheduler.getError());
+    
+    for(size_t i = 0; i < loops; i++) {
+        ASSERT_FALSE(outputs[i]->empty());
+        // The last output the sink saw is the added controller's output now.
+        EXPECT_EQ(outputs[i]->back(), controllers[i].getState().lastControlVariable) << "loop " << i;
+        // And the controller was stepped, not left as it was added.
+        EXPECT_GT(controllers[i].getState().integrator, 0) << "loop " << i;
+    }
+}
+
+TEST(ControlScheduler, IgnoresRatesWithoutAWholeNanosecondPeriod) {
+    PIDController controller;
+    ControlScheduler scheduler(1);
+    const double rates[] = { 0, -1, 2e9, std::numeric_limits<double>::infinity(),
+                             std::numeric_limits<double>::quiet_NaN(), 1e-20 };
+    for(size_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+        EXPECT_EQ(0u, scheduler.add(&controller, rates[i], [] { return 0.0; }, [](double) {})) << "rate " << rates[i];
+    }
+    EXPECT_EQ(1u, scheduler.add(&controller, 1e9, [] { return 0.0; }, [](double) {}));
+}
@@ -0,0 +1,83 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <PIDController.h>
+#include <gtest/gtest.h>
+#include <cmath>
+
+// A derivative-only controller, so calcDetailed().derivative is the output.
+static void setUpDerivative(PIDController& pid, PIDController::DerivativeMode mode, double timeConstant) {
+    pid.setGains(0, 0, 0.5);
+    pid.setDerivativeMode(mode);
+    pid.setDerivativeFilter(timeConstant);
+    pid.on();
+}
+
+//------------------------------------------------------------------------------
+// The derivative follows the measurement, not the setpoint, and a positive
+// time constant passes it through a first-order low-pass filter.
+//------------------------------------------------------------------------------
+
+TEST(DerivativeOnMeasurement, SetpointStepCausesNoKick) {
+    PIDController onMeasurement, onSetpoint;
+    setUpDerivative(onMeasurement, PIDController::DERIVATIVE_ON_MEASUREMENT, 0);
+    setUpDerivative(onSetpoint, PIDController::DERIVATIVE_ON_SETPOINT, 0);
+    onMeasurement.calc(0, 0.01);
+    onSetpoint.calc(0, 0.01);
+    onMeasurement.targetSetpoint(1);
+    onSetpoint.targetSetpoint(1);
+    EXPECT_EQ(0, onMeasurement.calcDetailed(0, 0.01).derivative);
+    EXPECT_NE(0, onSetpoint.calcDetailed(0, 0.01).derivative);
+}
+
+TEST(DerivativeOnMeasurement, RampGivesKdTimesSlope) {
+    const double slope = 3, samplingTime = 0.01;
+    PIDController pid;
+    setUpDerivative(pid, PIDController::DERIVATIVE_ON_MEASUREMENT, 0);
+    for(int k = 1; k <= 100; k++) {
+        PIDOutput terms = pid.calcDetailed(slope * k * samplingTime, samplingTime);
+        ASSERT_NEAR(-0.5 * slope, terms.derivative, 1e-9) << "step " << k;
+    }
+}
+
+TEST(DerivativeOnMeasurement, FilteredRampApproachesSlopeAsFirstOrderLag) {
+    const double slope = 3, samplingTime = 0.01, timeConstant = 0.05;
+    PIDController pid;
+    setUpDerivative(pid, PIDController::DERIVATIVE_ON_MEASUREMENT, timeConstant);
+    EXPECT_EQ(timeConstant, pid.getDerivativeFilter());
+    // d[k] = (Tf d[k-1] + slope T)/(Tf + T), so d[k] = slope (1 - a^k) with
+    // a = Tf/(Tf + T).
+    const double a = timeConstant / (timeConstant + samplingTime);
+    for(int k = 1; k <= 200; k++) {
+        PIDOutput terms = pid.calcDetailed(slope * k * samplingTime, samplingTime);
+        ASSERT_NEAR(-0.5 * slope * (1 - std::pow(a, k)), terms.derivative, 1e-9) << "step " << k;
+    }
+}
+
+TEST(DerivativeOnMeasurement, FilterAttenuatesSampleToSampleNoise) {
+    const double samplingTime = 0.001;
+    PIDController raw, filtered;
+    setUpDerivative(raw, PIDController::DERIVATIVE_ON_MEASUREMENT, 0);
+    setUpDerivative(filtered, PIDController::DERIVATIVE_ON_MEASUREMENT, 10 * samplingTime);
+    double rawPeak = 0, filteredPeak = 0;
+    for(int k = 0; k < 1000; k++) {
+        double noise = (k % 2) ? 0.01 : -0.01;
+        if(k >= 100) {
+            rawPeak = std::fmax(rawPeak, std::fabs(raw.calc(noise, samplingTime)));
+            filteredPeak = std::fmax(filteredPeak, std::fabs(filtered.calc(noise, samplingTime)));
+        }
+        else {
+            raw.calc(noise, samplingTime);
+            filtered.calc(noise, samplingTime);
+        }
+    }
+    // An alternating input is attenuated by T/(2 Tf + T) = 1/21.
+    EXPECT_NEAR(rawPeak / 21, filteredPeak, rawPeak * 1e-3);
+}
+
+TEST(DerivativeOnMeasurement, NonPositiveTimeConstantMeansNoFilter) {
+    PIDController pid;
+    pid.setDerivativeFilter(-1);
+    EXPECT_EQ(0, pid.getDerivativeFilter());
+}
@@ -0,0 +1,41 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <DiscretePlant.h>
+#include <gtest/gtest.h>
+#include <cmath>
+
+//------------------------------------------------------------------------------
+// zeroOrderHold() against the closed-form discretization of a first-order
+// plant, and on ill-formed plants, which must come back NaN rather than hang
+// the exponential's scaling loop.
+//------------------------------------------------------------------------------
+
+TEST(ZeroOrderHold, MatchesClosedFormFirstOrderPlant) {
+    // dx/dt = -a x + a u, so x[k+1] = exp(-aT) x[k] + (1 - exp(-aT)) u[k].
+    const double a = 5, samplingTime = 0.01;
+    double A[1][1] = { { -a } }, B[1] = { a }, C[1] = { 1 };
+    pid::StateSpacePlant<1> plant = pid::zeroOrderHold(A, B, C, samplingTime);
+    double x = 0;
+    for(int k = 0; k < 1000; k++) {
+        x = std::exp(-a * samplingTime) * x + (1 - std::exp(-a * samplingTime)) * 1.0;
+        EXPECT_NEAR(x, plant.step(1.0), 1e-12) << "at step " << k;
+    }
+}
+
+TEST(ZeroOrderHold, LargeNormsAreScaledDown) {
+    double A[1][1] = { { -2000 } }, B[1] = { 2000 }, C[1] = { 1 };
+    pid::StateSpacePlant<1> plant = pid::zeroOrderHold(A, B, C, 0.5);
+    EXPECT_NEAR(1.0, plant.step(1.0), 1e-12);
+}
+
+TEST(ZeroOrderHold, NonFinitePlantsGiveNaN) {
+    double B[2] = { 0, 1 }, C[2] = { 1, 0 };
+    double infinite[2][2] = { { 0, 1 }, { -INFINITY, -3 } };
+    double nan[2][2] = { { 0, 1 }, { NAN, -3 } };
+    double finite[2][2] = { { 0, 1 }, { -2, -3 } };
+    EXPECT_TRUE(std::isnan(pid::zeroOrderHold(infinite, B, C, 0.01).step(1.0)));
+    EXPECT_TRUE(std::isnan(pid::zeroOrderHold(nan, B, C, 0.01).step(1.0)));
+    EXPECT_TRUE(std::isnan(pid::zeroOrderHold(finite, B, C, INFINITY).step(1.0)));
+}
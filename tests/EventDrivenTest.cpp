@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <PIDController.h>
+#include <PIDParameterChannel.h>
+#include <gtest/gtest.h>
+#include <cmath>
+
+//------------------------------------------------------------------------------
+// Event-driven controllers, with a clock that the test advances by one
+// sampling period per sample. The process variable settles, sits within the
+// deadband for a while, so that samples are skipped, and is then disturbed.
+// Whichever of calc() and calcDetailed() is used, and whether the sampling
+// time is measured or fixed, the outputs must be the same.
+//------------------------------------------------------------------------------
+
+static const double SAMPLING_TIME = 0.01;
+static const int STEPS = 3000;
+static const double DEADBAND = 0.005;
+
+static double now = 0;
+
+static double testClock() {
+    return now;
+}
+
+static double processVariableAt(int step) {
+    if(step < 1000) {
+        return 1.0 - std::exp(-step * SAMPLING_TIME);
+    }
+    if(step < 2000) {
+        return 1.0 + 0.001 * std::sin(step * 0.1);
+    }
+    return 0.8;
+}
+
+static void configure(PIDController& pid, bool measured) {
+    pid.setGains(1.5, 0.8, 0.05);
+    if(measured) {
+        pid.setClock(testClock);
+    }
+    else {
+        pid.setSamplingPeriod(SAMPLING_TIME);
+    }
+    pid.setEventThresholds(DEADBAND, 0);
+    pid.on();
+    pid.targetSetpoint(1.0);
+}
+
+TEST(EventDriven, CalcDetailedMatchesCalcWithMeasuredSamplingTime) {
+    now = 0;
+    PIDController pid, detailed;
+    configure(pid, true);
+    configure(detailed, true);
+    int skipped = 0;
+    for(int k = 0; k < STEPS; k++) {
+        now += SAMPLING_TIME;
+        double output = pid.calc(processVariableAt(k));
+        bool changed = pid.hasOutputChanged();
+        ASSERT_EQ(output, detailed.calcDetailed(processVariableAt(k)).output) << "at step " << k;
+        ASSERT_EQ(changed, detailed.hasOutputChanged()) << "at step " << k;
+        skipped += !changed;
+    }
+    // The idle stretch must actually have been skipped.
+    EXPECT_GT(skipped, 500);
+}
+
+TEST(EventDriven, CalcDetailedMatchesCalcWithFixedSamplingTime) {
+    PIDController pid, detailed;
+    configure(pid, false);
+    configure(detailed, false);
+    for(int k = 0; k < STEPS; k++) {
+        double output = pid.calc(processVariableAt(k));
+        ASSERT_EQ(output, detailed.calcDetailed(processVariableAt(k)).output) << "at step " << k;
+        ASSERT_EQ(pid.hasOutputChanged(), detailed.hasOutputChanged()) << "at step " << k;
+    }
+}
+
+TEST(EventDriven, MeasuredSamplingTimeMatchesFixed) {
+    // Skipped samples get an even share of the measured interval, so the
+    // measured controllers match the fixed one to rounding, also when the
+    // clock-reading calls are mixed.
+    now = 0;
+    PIDController fixed, measured, mixed;
+    configure(fixed, false);
+    configure(measured, true);
+    configure(mixed, true);
+    for(int k = 0; k < STEPS; k++) {
+        now += SAMPLING_TIME;
+        double expected = fixed.calc(processVariableAt(k));
+        ASSERT_NEAR(expected, measured.calcDetailed(processVariableAt(k)).output, 1e-9) << "at step " << k;
+        double output = k % 2 ? mixed.calc(processVariableAt(k)) : mixed.calcDetailed(processVariableAt(k)).output;
+        ASSERT_NEAR(expected, output, 1e-9) << "at step " << k;
+    }
+}
+
+TEST(EventDriven, ChannelSetpointEndsIdleStretchWithMeasuredSamplingTime) {
+    // A setpoint published during an idle stretch must end it with the
+    // measured interval split over the skipped samples, not restart the
+    // interval and compute over a zero sampling time.
+    now = 0;
+    PIDController fixed, measured;
+    configure(fixed, false);
+    configure(measured, true);
+    PIDParameterChannel channel;
+    measured.setParameterChannel(&channel);
+    PIDParameters parameters = { 1.5, 1.5, 0.8, 0.05, -1, -1, -1, -1 };
+    int skipped = 0;
+    for(int k = 0; k < STEPS; k++) {
+        now += SAMPLING_TIME;
+        if(k == 1500) {
+            channel.publish(parameters);
+            fixed.targetSetpoint(parameters.setpoint);
+        }
+        double expected = fixed.calc(processVariableAt(k));
+        PIDOutput output = measured.calcDetailed(processVariableAt(k));
+        skipped += k < 1500 && !measured.hasOutputChanged();
+        ASSERT_TRUE(std::isfinite(output.output)) << "at step " << k;
+        ASSERT_NEAR(expected, output.output, 1e-9) << "at step " << k;
+        if(k == 1500) {
+            EXPECT_NEAR(SAMPLING_TIME, output.samplingTime, 1e-12);
+        }
+    }
+    EXPECT_GT(skipped, 100);
+}
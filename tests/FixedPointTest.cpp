@@ -0,0 +1,161 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <FixedPoint.h>
+#include <PIDControllerTemplate.h>
+#include <gtest/gtest.h>
+#include <cmath>
+
+//------------------------------------------------------------------------------
+// Every operation saturates instead of overflowing, including division at the
+// edges of the range, where the wide intermediate is closest to overflow.
+//------------------------------------------------------------------------------
+
+template <class T>
+class FixedPointFormats : public ::testing::Test {};
+
+typedef ::testing::Types<pid::Q15, pid::Q31, pid::Q16_16> Formats;
+TYPED_TEST_SUITE(FixedPointFormats, Formats);
+
+TYPED_TEST(FixedPointFormats, DivisionByTheSmallestNegativeStepSaturates) {
+    typedef TypeParam Q;
+    EXPECT_EQ(Q::max(), Q::lowest() / Q::fromRaw(-1));
+    EXPECT_EQ(Q::lowest(), Q::max() / Q::fromRaw(-1));
+    EXPECT_EQ(Q(), Q() / Q::fromRaw(-1));
+    EXPECT_EQ(Q::max(), Q::lowest() / Q::fromRaw(-2));
+}
+
+TYPED_TEST(FixedPointFormats, DivisionByZeroSaturatesTowardsTheDividend) {
+    typedef TypeParam Q;
+    EXPECT_EQ(Q::max(), Q::epsilon() / Q());
+    EXPECT_EQ(Q::lowest(), -Q::epsilon() / Q());
+    EXPECT_EQ(Q::lowest(), Q::lowest() / Q());
+}
+
+TYPED_TEST(FixedPointFormats, DivisionRoundsToNearest) {
+    typedef TypeParam Q;
+    // 0.5/0.75 = 2/3, within half a step of the exact quotient.
+    double quotient = (Q(0.5) / Q(0.75)).toDouble();
+    EXPECT_NEAR(2.0 / 3.0, quotient, Q::epsilon().toDouble() / 2);
+}
+
+static_assert(pid::Q31::lowest() / pid::Q31::fromRaw(-1) == pid::Q31::max(), "division saturates at compile time");
+
+//------------------------------------------------------------------------------
+// The tolerance FixedPoint.h states: while nothing saturates, a fixed-point
+// controller stays within (1.5 + |kd|/2 + |ki|*N/2) LSB of the double
+// controller fed the same quantized gains, limits, and inputs after N steps.
+// Once a value saturates, it stays pinned to the edge of the range, and the
+// integrator clamp to the output limits still applies.
+//------------------------------------------------------------------------------
+
+static const int STEPS = 4000;
+
+// Gains, setpoint and process variable amplitudes, output limit, and a
+// sampling time that every format represents exactly.
+struct LoopScale {
+    double kp, ki, kd;
+    double setpoint, amplitude;
+    double limit;
+    double samplingTime;
+};
+
+template <class Q>
+static void expectWithinStatedTolerance(const LoopScale& scale) {
+    typedef pid::PIDController<Q, pid::OutputLimits, pid::Derivative, pid::FixedTimestep> FixedLoop;
+    typedef pid::PIDController<double, pid::OutputLimits, pid::Derivative, pid::FixedTimestep> DoubleLoop;
+    Q kp(scale.kp), ki(scale.ki), kd(scale.kd), limit(scale.limit), samplingTime(scale.samplingTime);
+    FixedLoop fixed(kp, ki, kd);
+    DoubleLoop reference(kp.toDouble(), ki.toDouble(), kd.toDouble());
+    fixed.setOutputLimits(-limit, limit);
+    reference.setOutputLimits(-limit.toDouble(), limit.toDouble());
+    fixed.setSamplingPeriod(samplingTime);
+    reference.setSamplingPeriod(samplingTime.toDouble());
+    fixed.on();
+    reference.on();
+
+    const double lsb = Q::epsilon().toDouble();
+    for(int k = 1; k <= STEPS; k++) {
+        // Setpoint steps every 500 samples, so the derivative term is used.
+        Q setpoint((k / 500) % 2 ? -scale.setpoint : scale.setpoint);
+        Q processVariable(scale.amplitude * std::sin(k * 0.01));
+        fixed.targetSetpoint(setpoint);
+        reference.targetSetpoint(setpoint.toDouble());
+        double output = fixed.calc(processVariable).toDouble();
+        double expected = reference.calc(processVariable.toDouble());
+        double bound = (1.5 + std::fabs(kd.toDouble()) / 2 + std::fabs(ki.toDouble()) * k / 2) * lsb;
+        ASSERT_NEAR(expected, output, bound) << "at step " << k;
+        ASSERT_LT(std::fabs(output), limit.toDouble() + lsb) << "at step " << k;
+    }
+}
+
+TEST(FixedPointController, Q15StaysWithinStatedTolerance) {
+    LoopScale scale = { 0.5, 0.25, 0.005, 0.125, 0.3, 0.9, 0.5 };
+    expectWithinStatedTolerance<pid::Q15>(scale);
+}
+
+TEST(FixedPointController, Q31StaysWithinStatedTolerance) {
+    LoopScale scale = { 0.5, 0.25, 0.005, 0.125, 0.3, 0.9, 0.5 };
+    expectWithinStatedTolerance<pid::Q31>(scale);
+}
+
+TEST(FixedPointController, Q16_16StaysWithinStatedTolerance) {
+    LoopScale scale = { 11.5, 2.0, 0.05, 3, 2, 100, 0.015625 };
+    expectWithinStatedTolerance<pid::Q16_16>(scale);
+}
+
+TYPED_TEST(FixedPointFormats, SaturatedIntegratorStaysAtTheEdgeOfTheRange) {
+    // Output limits at the edges of the range: an error pinned at max() winds
+    // the integrator up to max() and no further, so when the error reverses
+    // the output follows from an integrator of exactly max(), not a wrapped
+    // one.
+    typedef TypeParam Q;
+    pid::PIDController<Q, pid::OutputLimits, pid::FixedTimestep> loop(Q(0.5), Q(0.5), Q(0));
+    loop.setOutputLimits(Q::lowest(), Q::max());
+    loop.setSamplingPeriod(Q(0.5));
+    loop.targetSetpoint(Q::max());
+    loop.on();
+    Q output;
+    for(int k = 0; k < 10000; k++) {
+        output = loop.calc(Q::lowest());
+        ASSERT_GE(output, Q(0)) << "at step " << k;
+    }
+    EXPECT_EQ(Q::max(), output);
+    loop.targetSetpoint(Q(0));
+    Q error = Q(-0.25);
+    Q expected = Q(0.5) * error + Q(0.5) * (Q::max() + error * Q(0.5));
+    EXPECT_EQ(expected, loop.calc(Q(0.25)));
+
+    loop.targetSetpoint(Q::lowest());
+    for(int k = 0; k < 10000; k++) {
+        output = loop.calc(Q::max());
+        ASSERT_LE(output, Q(0)) << "at step " << k;
+    }
+    EXPECT_EQ(Q::lowest(), output);
+}
+
+TYPED_TEST(FixedPointFormats, IntegratorIsClampedToTheOutputLimits) {
+    // With output limits inside the range, a saturated error clamps the
+    // integrator to the limit, so the output leaves the limit on the first
+    // sample after the error reverses.
+    typedef TypeParam Q;
+    pid::PIDController<Q, pid::OutputLimits, pid::FixedTimestep> loop(Q(0.5), Q(0.5), Q(0));
+    loop.setOutputLimits(Q(-0.5), Q(0.5));
+    loop.setSamplingPeriod(Q(0.5));
+    loop.targetSetpoint(Q::max());
+    loop.on();
+    for(int k = 0; k < 10000; k++) {
+        ASSERT_EQ(Q(0.5), loop.calc(Q::lowest())) << "at step " << k;
+    }
+    loop.targetSetpoint(Q(0));
+    Q error = Q(-0.125);
+    Q expected = Q(0.5) * error + Q(0.5) * (Q(0.5) + error * Q(0.5));
+    EXPECT_EQ(expected, loop.calc(Q(0.125)));
+    EXPECT_LT(expected, Q(0.5));
+
+    loop.targetSetpoint(Q::lowest());
+    for(int k = 0; k < 10000; k++) {
+        ASSERT_EQ(Q(-0.5), loop.calc(Q::max())) << "at step " << k;
+    }
+}
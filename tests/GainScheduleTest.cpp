@@ -0,0 +1,124 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <GainSchedule.h>
+#include <PIDController.h>
+#include <gtest/gtest.h>
+#include <cmath>
+
+// Piecewise-linear reference over 'points', held beyond the ends.
+static double referenceKp(const GainSchedulePoint* points, size_t count, double variable) {
+    if(variable <= points[0].variable) {
+        return points[0].kp;
+    }
+    for(size_t i = 1; i < count; i++) {
+        if(variable <= points[i].variable) {
+            double fraction = (variable - points[i - 1].variable) / (points[i].variable - points[i - 1].variable);
+            return points[i - 1].kp + fraction * (points[i].kp - points[i - 1].kp);
+        }
+    }
+    return points[count - 1].kp;
+}
+
+//------------------------------------------------------------------------------
+// Lookup on uniform and non-uniform grids against the piecewise-linear
+// reference, and the rows the table refuses.
+//------------------------------------------------------------------------------
+
+TEST(GainSchedule, UniformGridInterpolatesAndHoldsTheEnds) {
+    const GainSchedulePoint points[] = { { 0, 1, 10, 100 }, { 2, 3, 30, 300 }, { 4, 2, 20, 200 }, { 6, 5, 50, 500 } };
+    GainSchedule schedule;
+    ASSERT_TRUE(schedule.setPoints(points, 4));
+    EXPECT_TRUE(schedule.isUniform());
+    EXPECT_EQ(4u, schedule.size());
+    for(double variable = -2; variable <= 8; variable += 0.125) {
+        double kp = 0, ki = 0, kd = 0;
+        schedule.lookup(variable, kp, ki, kd);
+        double expected = referenceKp(points, 4, variable);
+        EXPECT_NEAR(expected, kp, 1e-12) << "at " << variable;
+        EXPECT_NEAR(10 * expected, ki, 1e-11) << "at " << variable;
+        EXPECT_NEAR(100 * expected, kd, 1e-10) << "at " << variable;
+    }
+}
+
+TEST(GainSchedule, NonUniformGridInterpolatesAndHoldsTheEnds) {
+    const GainSchedulePoint points[] = { { -1, 4, 0, 0 }, { 0.5, 1, 0, 0 }, { 1, 2, 0, 0 }, { 10, -3, 0, 0 }, { 10.25, 0, 0, 0 } };
+    GainSchedule schedule;
+    ASSERT_TRUE(schedule.setPoints(points, 5));
+    EXPECT_FALSE(schedule.isUniform());
+    for(double variable = -3; variable <= 12; variable += 0.0625) {
+        double kp = 0, ki = 0, kd = 0;
+        schedule.lookup(variable, kp, ki, kd);
+        EXPECT_NEAR(referenceKp(points, 5, variable), kp, 1e-12) << "at " << variable;
+    }
+}
+
+TEST(GainSchedule, RejectsUnsortedOrNonFiniteRowsAndKeepsTheTable) {
+    const GainSchedulePoint good[] = { { 0, 1, 0, 0 }, { 1, 2, 0, 0 } };
+    const GainSchedulePoint unsorted[] = { { 0, 5, 0, 0 }, { 0, 6, 0, 0 } };
+    const GainSchedulePoint nonFinite[] = { { 0, 5, 0, 0 }, { NAN, 6, 0, 0 } };
+    GainSchedule schedule;
+    ASSERT_TRUE(schedule.setPoints(good, 2));
+    EXPECT_FALSE(schedule.setPoints(unsorted, 2));
+    EXPECT_FALSE(schedule.setPoints(nonFinite, 2));
+    double kp = 0, ki = 0, kd = 0;
+    schedule.lookup(0.5, kp, ki, kd);
+    EXPECT_EQ(1.5, kp);
+}
+
+TEST(GainSchedule, EmptyTableLeavesTheGainsAndOneRowIsConstant) {
+    GainSchedule schedule;
+    double kp = 7, ki = 8, kd = 9;
+    schedule.lookup(1, kp, ki, kd);
+    EXPECT_EQ(7, kp);
+    EXPECT_EQ(8, ki);
+    EXPECT_EQ(9, kd);
+    const GainSchedulePoint one[] = { { 3, 1, 2, 3 } };
+    ASSERT_TRUE(schedule.setPoints(one, 1));
+    schedule.lookup(-100, kp, ki, kd);
+    EXPECT_EQ(1, kp);
+    EXPECT_EQ(2, ki);
+    EXPECT_EQ(3, kd);
+}
+
+//------------------------------------------------------------------------------
+// A scheduled controller picks its gains up in calc() and keeps the integral
+// term continuous when ki changes.
+//------------------------------------------------------------------------------
+
+TEST(GainSchedule, ControllerSchedulesOnTheExternalVariable) {
+    const GainSchedulePoint points[] = { { 0, 1, 1, 0 }, { 10, 3, 4, 0 } };
+    GainSchedule schedule;
+    ASSERT_TRUE(schedule.setPoints(points, 2));
+    PIDController pid(1, 1, 0, -100, 100);
+    pid.setGainSchedule(&schedule, PIDController::SCHEDULE_ON_EXTERNAL);
+    pid.targetSetpoint(1);
+    pid.on();
+    pid.setSchedulingVariable(0);
+    PIDOutput before;
+    for(int k = 0; k < 100; k++) {
+        before = pid.calcDetailed(0.5, 0.01);
+    }
+    pid.setSchedulingVariable(5);
+    // With no error the integral term must not jump when ki changes.
+    PIDOutput after = pid.calcDetailed(1, 0.01);
+    EXPECT_EQ(2, pid.getKp());
+    EXPECT_EQ(2.5, pid.getKi());
+    EXPECT_NEAR(before.integral, after.integral, 1e-12);
+}
+
+TEST(GainSchedule, ControllerSchedulesOnTheProcessVariableOrSetpoint) {
+    const GainSchedulePoint points[] = { { 0, 1, 0, 0 }, { 10, 11, 0, 0 } };
+    GainSchedule schedule;
+    ASSERT_TRUE(schedule.setPoints(points, 2));
+    PIDController pid(0, 0, 0, -100, 100);
+    pid.targetSetpoint(4);
+    pid.on();
+    pid.setGainSchedule(&schedule, PIDController::SCHEDULE_ON_PROCESS_VARIABLE);
+    pid.calc(2, 0.01);
+    EXPECT_EQ(3, pid.getKp());
+    pid.setGainSchedule(&schedule, PIDController::SCHEDULE_ON_SETPOINT);
+    pid.calc(2, 0.01);
+    EXPECT_EQ(5, pid.getKp());
+}
@@ -0,0 +1,49 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <DiscretePlant.h>
+#include <GainTuner.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// The candidates' random streams must be independent: no candidate's draws
+// may reappear, shifted, as a neighbour's, or the Monte-Carlo samples are
+// correlated. Every range is the same, so a shared draw shows up as equal
+// gains.
+//------------------------------------------------------------------------------
+
+static std::vector<pid::TuningResult> sampleCandidates(size_t candidates, uint64_t seed, unsigned threads) {
+    // y[k+1] = 0.9 y[k] + 0.1 u[k]
+    double numerator[1] = { 0.1 }, denominator[1] = { -0.9 };
+    pid::DiscreteTransferFunction<1> plant(numerator, denominator);
+    pid::GainTuner<pid::DiscreteTransferFunction<1> > tuner(plant, 0.01, 0.1);
+    pid::GainSearchSpace space = { 0, 1, 0, 1, 0, 1 };
+    return tuner.sample(space, candidates, seed, threads);
+}
+
+TEST(GainTuner, CandidateDrawsDoNotOverlap) {
+    for(uint64_t seed = 0; seed < 4; seed++) {
+        std::vector<pid::TuningResult> results = sampleCandidates(200, seed, 1);
+        std::vector<double> draws;
+        for(size_t i = 0; i < results.size(); i++) {
+            draws.push_back(results[i].gains.kp);
+            draws.push_back(results[i].gains.ki);
+            draws.push_back(results[i].gains.kd);
+        }
+        std::sort(draws.begin(), draws.end());
+        EXPECT_TRUE(std::adjacent_find(draws.begin(), draws.end()) == draws.end()) << "seed " << seed;
+    }
+}
+
+TEST(GainTuner, CandidatesDoNotDependOnThreads) {
+    std::vector<pid::TuningResult> one = sampleCandidates(50, 7, 1);
+    std::vector<pid::TuningResult> three = sampleCandidates(50, 7, 3);
+    for(size_t i = 0; i < one.size(); i++) {
+        EXPECT_EQ(one[i].gains.kp, three[i].gains.kp);
+        EXPECT_EQ(one[i].gains.ki, three[i].gains.ki);
+        EXPECT_EQ(one[i].gains.kd, three[i].gains.kd);
+    }
+}
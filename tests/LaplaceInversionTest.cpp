@@ -0,0 +1,132 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <LaplaceInversion.h>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+// F(s) = 1/(s + 1), so f(t) = exp(-t).
+static cmplex firstOrderLag(const cmplex& s) {
+    return 1.0 / (s + 1.0);
+}
+
+//------------------------------------------------------------------------------
+// LaplaceWorkspace is sized to its order, and LaplaceInversion() gives the
+// same result from any workspace of that order, on any thread.
+//------------------------------------------------------------------------------
+
+TEST(LaplaceWorkspace, IsSizedToItsOrder) {
+    for(int M : { 1, 16, 40, MAX_LAPORDER }) {
+        LaplaceWorkspace w(M);
+        EXPECT_EQ(M, w.M);
+        EXPECT_EQ((size_t)((2 * M + 1) * (M + 1)), w.e.size());
+        EXPECT_EQ((size_t)((2 * M + 1) * (M + 1)), w.q.size());
+        EXPECT_EQ((size_t)(2 * M + 1), w.Fctrl.size());
+        EXPECT_EQ((size_t)(2 * M + 1), w.d.size());
+        EXPECT_EQ((size_t)(2 * M + 2), w.A.size());
+        EXPECT_EQ((size_t)(2 * M + 2), w.B.size());
+    }
+    // The figures in the LaplaceWorkspace comment: about 111 KB for M=40,
+    // 106 KB of it in e and q.
+    LaplaceWorkspace w(40);
+    size_t tables = (w.e.size() + w.q.size()) * sizeof(cmplex);
+    size_t rest = (w.Fctrl.size() + w.d.size() + w.A.size() + w.B.size()) * sizeof(cmplex);
+    EXPECT_EQ(106u, tables / 1000);
+    EXPECT_EQ(111u, (tables + rest) / 1000);
+}
+
+TEST(LaplaceInversion, ReusedWorkspaceGivesTheSameResult) {
+    LaplaceWorkspace reused(40);
+    for(double t : { 0.1, 1.0, 3.0, 0.5 }) {
+        LaplaceWorkspace fresh(40);
+        double expected = LaplaceInversion(firstOrderLag, t, 1e-8, fresh);
+        EXPECT_EQ(expected, LaplaceInversion(firstOrderLag, t, 1e-8, reused)) << "at t = " << t;
+        EXPECT_EQ(expected, LaplaceInversion(firstOrderLag, t, 1e-8)) << "at t = " << t;
+        EXPECT_NEAR(std::exp(-t), expected, 1e-7) << "at t = " << t;
+    }
+}
+
+TEST(LaplaceInversion, SweepOnSeveralThreadsMatchesOneThread) {
+    std::vector<double> t(200), serial(200), parallel(200);
+    for(size_t k = 0; k < t.size(); k++) {
+        t[k] = 0.05 * (k + 1);
+    }
+    LaplaceInversionSweep(firstOrderLag, &t[0], &serial[0], t.size(), 1e-8, 1);
+    LaplaceInversionSweep(firstOrderLag, &t[0], &parallel[0], t.size(), 1e-8, 4);
+    for(size_t k = 0; k < t.size(); k++) {
+        ASSERT_EQ(serial[k], parallel[k]) << "at t = " << t[k];
+    }
+}
+
+//------------------------------------------------------------------------------
+// LaplaceInverter clamps its order to 1..MAX_LAPORDER, since evaluation keeps
+// its recurrence terms on the stack.
+//------------------------------------------------------------------------------
+
+TEST(LaplaceInverter, OrderIsClampedToTheSupportedRange) {
+    LaplaceInverter tooHigh(firstOrderLag, 8, 1e-8, 24, 10 * MAX_LAPORDER);
+    LaplaceInverter highest(firstOrderLag, 8, 1e-8, 24, MAX_LAPORDER);
+    LaplaceInverter tooLow(firstOrderLag, 8, 1e-8, 24, -5);
+    LaplaceInverter lowest(firstOrderLag, 8, 1e-8, 24, 1);
+    for(double t : { 0.1, 1.0, 5.0 }) {
+        EXPECT_EQ(highest(t), tooHigh(t)) << "at t = " << t;
+        EXPECT_EQ(lowest(t), tooLow(t)) << "at t = " << t;
+    }
+    EXPECT_NEAR(std::exp(-1.0), highest(1.0), 1e-7);
+}
+
+//------------------------------------------------------------------------------
+// LaplaceInverter against the closed form, the octave chosen for times outside
+// (0, tmax), and interpolate() without a table.
+//------------------------------------------------------------------------------
+
+TEST(LaplaceInverter, MatchesClosedFormOverTheHorizon) {
+    LaplaceInverter inverter(firstOrderLag, 8, 1e-8);
+    for(double t = 0.05; t <= 8; t *= 1.5) {
+        EXPECT_NEAR(std::exp(-t), inverter(t), 1e-7) << "at t = " << t;
+    }
+}
+
+TEST(LaplaceInverter, TimesBelowTheLastOctaveUseTheLastOctave) {
+    // The last of 4 octaves below tmax = 8 has the period of the only octave
+    // below tmax = 1, so both must give the same f(t) there and below it.
+    LaplaceInverter fourOctaves(firstOrderLag, 8, 1e-8, 4);
+    LaplaceInverter lastOctave(firstOrderLag, 1, 1e-8, 1);
+    for(double t : { 0.75, 0.5, 0.01, 0.0, -1.0 }) {
+        EXPECT_EQ(lastOctave(t), fourOctaves(t)) << "at t = " << t;
+    }
+}
+
+TEST(LaplaceInverter, TimesFromTheHorizonOnUseTheFirstOctave) {
+    LaplaceInverter manyOctaves(firstOrderLag, 8, 1e-8, 4);
+    LaplaceInverter firstOctave(firstOrderLag, 8, 1e-8, 1);
+    for(double t : { 8.0, 12.0, 100.0 }) {
+        EXPECT_EQ(firstOctave(t), manyOctaves(t)) << "at t = " << t;
+    }
+}
+
+TEST(LaplaceInverter, NoOctavesStillPrecomputesOne) {
+    LaplaceInverter inverter(firstOrderLag, 8, 1e-8, 0);
+    EXPECT_NEAR(std::exp(-4.0), inverter(4.0), 1e-7);
+}
+
+TEST(LaplaceInverter, InterpolatesInTheTable) {
+    LaplaceInverter inverter(firstOrderLag, 8, 1e-8);
+    inverter.tabulate(1, 2, 2);
+    EXPECT_NEAR(0.5 * (std::exp(-1.0) + std::exp(-2.0)), inverter.interpolate(1.5), 1e-7);
+    EXPECT_EQ(inverter(1.0), inverter.interpolate(0.0));
+    EXPECT_EQ(inverter(2.0), inverter.interpolate(3.0));
+}
+
+TEST(LaplaceInverter, InterpolateWithoutATableIsNaN) {
+    LaplaceInverter inverter(firstOrderLag, 8, 1e-8);
+    EXPECT_TRUE(std::isnan(inverter.interpolate(1.0)));
+    inverter.tabulate(0, 8, 1);
+    EXPECT_TRUE(std::isnan(inverter.interpolate(1.0)));
+    inverter.tabulate(0, 8, 9);
+    EXPECT_FALSE(std::isnan(inverter.interpolate(1.0)));
+    inverter.tabulate(0, 8, 0);
+    EXPECT_TRUE(std::isnan(inverter.interpolate(1.0)));
+}
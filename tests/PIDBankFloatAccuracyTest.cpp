@@ -0,0 +1,84 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <PIDBankFloat.h>
+#include <PIDController.h>
+#include <gtest/gtest.h>
+#include <cmath>
+
+//------------------------------------------------------------------------------
+// A float lane against a double PIDController, both in closed loop on their
+// own plant. The plant has a large offset, so the integrator carries a value
+// of about 100 while the error that feeds it stays small, tracking a slow
+// sine: each increment is near the float resolution of the integrator, which
+// is where plain float summation drifts. The horizon is 2^24 samples, 4.6
+// hours at 1 kHz.
+//
+// Tolerances, on the output (of about 100), are about three times the
+// deviation measured on x86-64: 3.7e-3 with plain summation and 3.2e-5 with
+// compensated summation, which is near float resolution at 100 (7.6e-6).
+//------------------------------------------------------------------------------
+
+static const double SAMPLING_TIME = 0.001;
+static const long STEPS = 1L << 24;
+static const double PLAIN_TOLERANCE = 1e-2;
+static const double COMPENSATED_TOLERANCE = 1e-4;
+
+// Returns the largest output deviation over the horizon.
+static double maximumDeviation(bool compensated, long steps) {
+    PIDController pid;
+    pid.setGains(1.5, 0.8, 0);
+    pid.on();
+    PIDBankFloat bank(1);
+    bank.setCompensatedSummation(compensated);
+    bank.setGains(0, 1.5f, 0.8f, 0);
+    bank.on(0);
+
+    double processVariable = 0;
+    float floatProcessVariable = 0;
+    float floatControlVariable;
+    double deviation = 0;
+    for(long k = 0; k < steps; k++) {
+        double setpoint = 1 + 0.5 * std::sin(0.01 * k * SAMPLING_TIME);
+        pid.targetSetpoint(setpoint);
+        bank.targetSetpoint(0, (float)setpoint);
+        double controlVariable = pid.calc(processVariable, SAMPLING_TIME);
+        bank.calcAll(&floatProcessVariable, &floatControlVariable, 1, (float)SAMPLING_TIME);
+        processVariable += 0.01 * (controlVariable - 100 - processVariable);
+        floatProcessVariable += 0.01f * (floatControlVariable - 100 - floatProcessVariable);
+        deviation = std::fmax(deviation, std::fabs(controlVariable - floatControlVariable));
+        // A NaN must fail the test rather than be ignored by fmax.
+        if(!std::isfinite(floatControlVariable)) {
+            return INFINITY;
+        }
+    }
+    return deviation;
+}
+
+// Each horizon takes a while, so both are run once for all the tests.
+class PIDBankFloatAccuracy : public ::testing::Test {
+    protected:
+        static double plain;
+        static double compensated;
+
+        static void SetUpTestSuite() {
+            plain = maximumDeviation(false, STEPS);
+            compensated = maximumDeviation(true, STEPS);
+        }
+};
+
+double PIDBankFloatAccuracy::plain;
+double PIDBankFloatAccuracy::compensated;
+
+TEST_F(PIDBankFloatAccuracy, PlainSummationStaysWithinTolerance) {
+    EXPECT_LT(plain, PLAIN_TOLERANCE);
+}
+
+TEST_F(PIDBankFloatAccuracy, CompensatedSummationStaysWithinTolerance) {
+    EXPECT_LT(compensated, COMPENSATED_TOLERANCE);
+}
+
+TEST_F(PIDBankFloatAccuracy, CompensatedSummationDriftsLessThanPlain) {
+    EXPECT_LT(10 * compensated, plain);
+}
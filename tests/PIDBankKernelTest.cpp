@@ -0,0 +1,194 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <PIDBank.h>
+#include <PIDBankFloat.h>
+#include <PIDController.h>
+#include <gtest/gtest.h>
+#include <cstring>
+#include <random>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Every PIDBank kernel must give bit-identical results: the vector kernels
+// against the scalar one, and the scalar one against PIDController. Lanes get
+// mixed gains, limits, and tracking gains, a lane count that leaves a
+// remainder for every vector width, and a setpoint change halfway, so that
+// the limited and unlimited paths of every mode are exercised.
+//------------------------------------------------------------------------------
+
+static const size_t LANES = 37;
+static const int STEPS = 3000;
+static const double SAMPLING_TIME = 0.01;
+
+static const PIDBank::Isa VECTOR_ISAS[] = { PIDBank::ISA_AVX2, PIDBank::ISA_AVX512, PIDBank::ISA_NEON };
+
+// Configures lane i of the bank and, when given, an equivalent controller.
+static void configureLane(PIDBank& bank, PIDController* pid, size_t i, std::mt19937& random) {
+    std::uniform_real_distribution<double> uniform(-2, 2);
+    double kp = i % 5 == 0 ? 0 : uniform(random) + 2.5;
+    double ki = i % 7 == 0 ? 0 : uniform(random) + 2.5;
+    double kd = uniform(random) * 0.01;
+    double setpoint = uniform(random) * 4;
+    bank.setGains(i, kp, ki, kd);
+    if(pid) {
+        pid->setGains(kp, ki, kd);
+    }
+    if(i % 4) {
+        bank.setOutputLimits(i, -3, 3);
+        if(pid) {
+            pid->setOutputLimits(-3, 3);
+        }
+    }
+    if(i % 3) {
+        bank.setIntegratorLimits(i, -1, 1.5);
+        if(pid) {
+            pid->setIntegratorLimits(-1, 1.5);
+        }
+    }
+    if(i % 2) {
+        bank.setTrackingGain(i, 5);
+        if(pid) {
+            pid->setTrackingGain(5);
+        }
+    }
+    bank.on(i);
+    bank.targetSetpoint(i, setpoint);
+    if(pid) {
+        pid->setSamplingPeriod(SAMPLING_TIME);
+        pid->on();
+        pid->targetSetpoint(setpoint);
+    }
+}
+
+// Runs a bank on its own plants and returns every output of every step.
+static std::vector<double> runBank(PIDBank::Isa isa, PIDBank::Algorithm algorithm, PIDBank::AntiWindup antiWindup, bool& supported) {
+    PIDBank bank(LANES);
+    supported = bank.setIsa(isa);
+    bank.setAlgorithm(algorithm);
+    bank.setAntiWindup(antiWindup);
+    std::mt19937 random(5);
+    for(size_t i = 0; i < LANES; i++) {
+        configureLane(bank, 0, i, random);
+    }
+    std::uniform_real_distribution<double> uniform(-2, 2);
+    std::vector<double> plant(LANES, 0), output(LANES), outputs;
+    for(int k = 0; k < STEPS; k++) {
+        if(k == STEPS / 2) {
+            for(size_t i = 0; i < LANES; i++) {
+                bank.targetSetpoint(i, uniform(random));
+            }
+        }
+        bank.calcAll(&plant[0], &output[0], LANES, SAMPLING_TIME);
+        for(size_t i = 0; i < LANES; i++) {
+            plant[i] += 0.05 * (output[i] - plant[i]);
+        }
+        outputs.insert(outputs.end(), output.begin(), output.end());
+    }
+    return outputs;
+}
+
+class PIDBankKernels : public ::testing::TestWithParam<std::tuple<int, int> > {
+    protected:
+        PIDBank::Algorithm algorithm() { return (PIDBank::Algorithm)std::get<0>(GetParam()); }
+        PIDBank::AntiWindup antiWindup() { return (PIDBank::AntiWindup)std::get<1>(GetParam()); }
+};
+
+TEST_P(PIDBankKernels, VectorKernelsMatchScalarBitForBit) {
+    bool supported;
+    std::vector<double> scalar = runBank(PIDBank::ISA_SCALAR, algorithm(), antiWindup(), supported);
+    ASSERT_TRUE(supported);
+    for(size_t j = 0; j < sizeof(VECTOR_ISAS) / sizeof(VECTOR_ISAS[0]); j++) {
+        std::vector<double> vector = runBank(VECTOR_ISAS[j], algorithm(), antiWindup(), supported);
+        if(!supported) {
+            continue;
+        }
+        ASSERT_EQ(scalar.size(), vector.size());
+        for(size_t n = 0; n < scalar.size(); n++) {
+            ASSERT_EQ(0, std::memcmp(&scalar[n], &vector[n], sizeof(double)))
+                << "isa " << VECTOR_ISAS[j] << ", step " << n / LANES << ", lane " << n % LANES
+                << ": " << scalar[n] << " != " << vector[n];
+        }
+    }
+}
+
+TEST_P(PIDBankKernels, ScalarKernelMatchesPIDControllerBitForBit) {
+    PIDBank bank(LANES);
+    ASSERT_TRUE(bank.setIsa(PIDBank::ISA_SCALAR));
+    bank.setAlgorithm(algorithm());
+    bank.setAntiWindup(antiWindup());
+    std::vector<PIDController> pids(LANES);
+    std::mt19937 random(5);
+    for(size_t i = 0; i < LANES; i++) {
+        pids[i].setAlgorithm((PIDController::Algorithm)algorithm());
+        pids[i].setAntiWindup((PIDController::AntiWindup)antiWindup());
+        configureLane(bank, &pids[i], i, random);
+    }
+    std::uniform_real_distribution<double> uniform(-2, 2);
+    std::vector<double> plant(LANES, 0), output(LANES);
+    for(int k = 0; k < STEPS; k++) {
+        if(k == STEPS / 2) {
+            for(size_t i = 0; i < LANES; i++) {
+                double setpoint = uniform(random);
+                bank.targetSetpoint(i, setpoint);
+                pids[i].targetSetpoint(setpoint);
+            }
+        }
+        bank.calcAll(&plant[0], &output[0], LANES, SAMPLING_TIME);
+        for(size_t i = 0; i < LANES; i++) {
+            double expected = pids[i].calc(plant[i]);
+            ASSERT_EQ(0, std::memcmp(&expected, &output[i], sizeof(double)))
+                << "step " << k << ", lane " << i << ": " << expected << " != " << output[i];
+            plant[i] += 0.05 * (expected - plant[i]);
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(AllModes, PIDBankKernels,
+    ::testing::Combine(::testing::Values((int)PIDBank::POSITIONAL, (int)PIDBank::VELOCITY),
+                       ::testing::Values((int)PIDBank::OUTPUT_CLAMP, (int)PIDBank::CONDITIONAL_INTEGRATION,
+                                         (int)PIDBank::BACK_CALCULATION, (int)PIDBank::INTEGRATOR_CLAMP)));
+
+//------------------------------------------------------------------------------
+// Same for PIDBankFloat, with and without compensated summation.
+//------------------------------------------------------------------------------
+
+static std::vector<float> runFloatBank(PIDBank::Isa isa, bool compensated, bool& supported) {
+    PIDBankFloat bank(LANES);
+    supported = bank.setIsa(isa);
+    bank.setCompensatedSummation(compensated);
+    for(size_t i = 0; i < LANES; i++) {
+        bank.setGains(i, 1.0f + 0.1f * i, 0.5f + 0.05f * i, 0.001f * i);
+        if(i % 2) {
+            bank.setOutputLimits(i, -2.0f, 2.0f);
+        }
+        bank.on(i);
+        bank.targetSetpoint(i, i % 3 ? 1.0f : -1.5f);
+    }
+    std::vector<float> plant(LANES, 0), output(LANES), outputs;
+    for(int k = 0; k < STEPS; k++) {
+        bank.calcAll(&plant[0], &output[0], LANES, (float)SAMPLING_TIME);
+        for(size_t i = 0; i < LANES; i++) {
+            plant[i] += 0.05f * (output[i] - plant[i]);
+        }
+        outputs.insert(outputs.end(), output.begin(), output.end());
+    }
+    return outputs;
+}
+
+TEST(PIDBankFloatKernels, VectorKernelsMatchScalarBitForBit) {
+    for(int compensated = 0; compensated < 2; compensated++) {
+        bool supported;
+        std::vector<float> scalar = runFloatBank(PIDBank::ISA_SCALAR, compensated != 0, supported);
+        ASSERT_TRUE(supported);
+        for(size_t j = 0; j < sizeof(VECTOR_ISAS) / sizeof(VECTOR_ISAS[0]); j++) {
+            std::vector<float> vector = runFloatBank(VECTOR_ISAS[j], compensated != 0, supported);
+            if(!supported) {
+                continue;
+            }
+            ASSERT_EQ(0, std::memcmp(&scalar[0], &vector[0], scalar.size() * sizeof(float)))
+                << "isa " << VECTOR_ISAS[j] << ", compensated " << compensated;
+        }
+    }
+}
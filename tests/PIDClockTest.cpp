@@ -0,0 +1,74 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <PIDClock.h>
+#include <PIDController.h>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#if defined(PID_HAVE_TSC_CLOCK)
+
+//------------------------------------------------------------------------------
+// TscClock is calibrated before main(), so now() never calibrates, and reads
+// from many threads see the same rate.
+//------------------------------------------------------------------------------
+
+TEST(TscClock, IsCalibratedAtStartup) {
+    double nanosecondsPerTick = pid::TscClock::nanosecondsPerTick();
+    EXPECT_GT(nanosecondsPerTick, 0);
+    EXPECT_EQ(nanosecondsPerTick, pid::TscClock::calibrate());
+}
+
+TEST(TscClock, NowNeverWaits) {
+    // A calibration takes 10 ms; a thousand reads take well under that.
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(int i = 0; i < 1000; i++) {
+        pid::TscClock::now();
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(5));
+}
+
+TEST(TscClock, MeasuresLikeSteadyClock) {
+    std::vector<std::thread> threads;
+    std::vector<double> ratios(4);
+    for(size_t i = 0; i < ratios.size(); i++) {
+        threads.emplace_back([&ratios, i] {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            pid::TscClock::time_point startTicks = pid::TscClock::now();
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            pid::TscClock::time_point stopTicks = pid::TscClock::now();
+            ratios[i] = std::chrono::duration<double>(stopTicks - startTicks).count()
+                      / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        });
+    }
+    for(size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    for(size_t i = 0; i < ratios.size(); i++) {
+        EXPECT_NEAR(1.0, ratios[i], 0.05);
+    }
+}
+
+#endif  /* PID_HAVE_TSC_CLOCK */
+
+//------------------------------------------------------------------------------
+// SimulatedClock only moves when told to, and through clockSeconds() it gives
+// a PIDController its sampling time.
+//------------------------------------------------------------------------------
+
+TEST(SimulatedClock, DrivesMeasuredSamplingTime) {
+    pid::SimulatedClock::set(pid::SimulatedClock::time_point());
+    PIDController simulated(1, 2, 0), reference(1, 2, 0);
+    simulated.setClock(&pid::clockSeconds<pid::SimulatedClock>);
+    simulated.targetSetpoint(1);
+    reference.targetSetpoint(1);
+    simulated.on();
+    reference.on();
+    for(int k = 0; k < 100; k++) {
+        pid::SimulatedClock::advance(std::chrono::milliseconds(5));
+        EXPECT_NEAR(reference.calc(0.5, 0.005), simulated.calc(0.5), 1e-12) << "step " << k;
+    }
+    EXPECT_EQ(0.5, pid::clockSeconds<pid::SimulatedClock>());
+}
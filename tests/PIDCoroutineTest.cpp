@@ -0,0 +1,232 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <PIDCoroutine.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// Allocations made anywhere in the process, to check that the steady state
+// of the executor makes none.
+static std::atomic<long> allocations(0);
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void* memory = std::malloc(size ? size : 1);
+    if(!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+// Outputs of a set of tasks, collected from the worker threads.
+class Outputs {
+    public:
+        explicit Outputs(size_t tasks) : values(tasks), count(0) {
+            for(size_t i = 0; i < tasks; i++) {
+                values[i].reserve(1000);
+            }
+        }
+        
+        pid::ControlExecutor::ActuatorSink sink(size_t task) {
+            return [this, task](double output) {
+                std::lock_guard<std::mutex> lock(mutex);
+                values[task].push_back(output);
+                count++;
+                changed.notify_all();
+            };
+        }
+        
+        // Waits until 'total' outputs have arrived over all tasks.
+        bool waitFor(size_t total) {
+            std::unique_lock<std::mutex> lock(mutex);
+            return changed.wait_for(lock, std::chrono::seconds(10), [&]() { return count >= total; });
+        }
+        
+        std::vector<std::vector<double> > values;
+        
+    private:
+        std::mutex mutex;
+        std::condition_variable changed;
+        size_t count;
+};
+
+// Yields the value and the samplingTime of every sample.
+static pid::ControlTask recordSamples() {
+    for(;;) {
+        pid::Sample sample = co_await pid::nextSample();
+        co_yield sample.value;
+        co_yield sample.samplingTime;
+    }
+}
+
+// Returns after its first sample.
+static pid::ControlTask oneSample() {
+    pid::Sample sample = co_await pid::nextSample();
+    co_yield sample.value;
+}
+
+// Tasks that yield on every sample, one on each worker, spawned after the
+// tasks under test. A worker runs its tasks in the order their samples
+// arrived, so once a marker has yielded, every sample posted to that
+// worker's other tasks before the marker's has been taken.
+class Markers {
+    public:
+        Markers(pid::ControlExecutor& executor)
+            : executor(executor), outputs(executor.getWorkers()), first(executor.getTasks()), rounds(0) {
+            for(size_t i = 0; i < executor.getWorkers(); i++) {
+                executor.spawn(recordSamples(), outputs.sink(i));
+            }
+        }
+        
+        bool sync() {
+            rounds++;
+            for(size_t i = 0; i < executor.getWorkers(); i++) {
+                executor.post(first + i, 0, rounds);
+            }
+            return outputs.waitFor(2 * executor.getWorkers() * rounds);
+        }
+        
+    private:
+        pid::ControlExecutor& executor;
+        Outputs outputs;
+        size_t first;
+        size_t rounds;
+};
+
+//------------------------------------------------------------------------------
+// controlLoop() tasks on a pool of workers step their controllers as direct
+// calc() calls would, with the time between timestamps as samplingTime.
+//------------------------------------------------------------------------------
+
+TEST(ControlExecutor, ManyLoopsMatchDirectCalc) {
+    const size_t loops = 500;
+    const int samples = 50;
+    std::vector<PIDController> controllers(loops, PIDController(2, 1, 0.01, -10, 10));
+    std::vector<PIDController> references(loops, PIDController(2, 1, 0.01, -10, 10));
+    Outputs outputs(loops);
+    pid::ControlExecutor executor(3);
+    for(size_t i = 0; i < loops; i++) {
+        controllers[i].targetSetpoint(1 + 0.01 * i);
+        controllers[i].on();
+        references[i].targetSetpoint(1 + 0.01 * i);
+        references[i].on();
+        ASSERT_EQ(i, executor.spawn(pid::controlLoop(controllers[i]), outputs.sink(i)));
+    }
+    EXPECT_EQ(3u, executor.getWorkers());
+    EXPECT_EQ(loops, executor.getTasks());
+    Markers markers(executor);
+    ASSERT_TRUE(executor.start());
+    EXPECT_FALSE(executor.start());
+    
+    // One round at a time, so no sample replaces an unread one. The first
+    // sample of each task only sets its time base and yields nothing.
+    for(int k = 0; k < samples; k++) {
+        for(size_t i = 0; i < loops; i++) {
+            ASSERT_TRUE(executor.post(i, 0.01 * k, 0.5 + 0.001 * k));
+        }
+        ASSERT_TRUE(k > 0 ? outputs.waitFor(loops * k) : markers.sync());
+    }
+    executor.stop();
+    EXPECT_FALSE(executor.isRunning());
+    
+    for(size_t i = 0; i < loops; i++) {
+        ASSERT_EQ((size_t)samples - 1, outputs.values[i].size()) << "loop " << i;
+        for(int k = 1; k < samples; k++) {
+            double samplingTime = (0.5 + 0.001 * k) - (0.5 + 0.001 * (k - 1));
+            ASSERT_EQ(references[i].calc(0.01 * k, samplingTime), outputs.values[i][k - 1]) << "loop " << i << " sample " << k;
+        }
+    }
+}
+
+TEST(ControlExecutor, SteadyStateDoesNotAllocate) {
+    const size_t loops = 64;
+    std::vector<PIDController> controllers(loops, PIDController(1, 1, 0));
+    Outputs outputs(loops);
+    pid::ControlExecutor executor(2);
+    for(size_t i = 0; i < loops; i++) {
+        controllers[i].on();
+        executor.spawn(pid::controlLoop(controllers[i]), outputs.sink(i));
+    }
+    Markers markers(executor);
+    ASSERT_TRUE(executor.start());
+    long before = 0;
+    for(int k = 0; k < 200; k++) {
+        if(k == 10) {
+            before = allocations.load();
+        }
+        for(size_t i = 0; i < loops; i++) {
+            executor.post(i, 0.5, 0.001 * k);
+        }
+        ASSERT_TRUE(k > 0 ? outputs.waitFor(loops * k) : markers.sync());
+    }
+    long after = allocations.load();
+    executor.stop();
+    EXPECT_EQ(before, after);
+}
+
+//------------------------------------------------------------------------------
+// Mailbox semantics: a newer sample replaces one the task has not taken, and
+// its samplingTime spans the whole interval.
+//------------------------------------------------------------------------------
+
+TEST(ControlExecutor, NewerSampleReplacesAnUnreadOne) {
+    Outputs outputs(1);
+    pid::ControlExecutor executor(1);
+    ASSERT_EQ(0u, executor.spawn(recordSamples(), outputs.sink(0)));
+    ASSERT_TRUE(executor.start());
+    ASSERT_TRUE(executor.post(0, 1, 10));
+    ASSERT_TRUE(outputs.waitFor(2));
+    executor.stop();
+    
+    // While stopped, the second post replaces the first.
+    ASSERT_TRUE(executor.post(0, 2, 11));
+    ASSERT_TRUE(executor.post(0, 3, 12.5));
+    ASSERT_TRUE(executor.start());
+    ASSERT_TRUE(outputs.waitFor(4));
+    executor.stop();
+    
+    ASSERT_EQ(4u, outputs.values[0].size());
+    EXPECT_EQ(1, outputs.values[0][0]);
+    EXPECT_EQ(0, outputs.values[0][1]);
+    EXPECT_EQ(3, outputs.values[0][2]);
+    EXPECT_EQ(2.5, outputs.values[0][3]);
+}
+
+TEST(ControlExecutor, RefusesUnknownFinishedAndLateTasks) {
+    Outputs outputs(2);
+    pid::ControlExecutor executor(1);
+    EXPECT_EQ(0u, executor.spawn(pid::ControlTask(), outputs.sink(0)));
+    ASSERT_EQ(0u, executor.spawn(oneSample(), outputs.sink(0)));
+    ASSERT_TRUE(executor.start());
+    EXPECT_EQ(1u, executor.spawn(recordSamples(), outputs.sink(1)));
+    EXPECT_EQ(1u, executor.getTasks());
+    EXPECT_FALSE(executor.post(1, 0, 0));
+    
+    ASSERT_TRUE(executor.post(0, 7, 0));
+    ASSERT_TRUE(outputs.waitFor(1));
+    // The task returns after its output; posts fail once the worker sees it.
+    bool refused = false;
+    for(int attempt = 0; attempt < 10000 && !refused; attempt++) {
+        refused = !executor.post(0, 8, 1);
+        std::this_thread::yield();
+    }
+    executor.stop();
+    EXPECT_TRUE(refused);
+    ASSERT_EQ(1u, outputs.values[0].size());
+    EXPECT_EQ(7, outputs.values[0][0]);
+}
@@ -0,0 +1,127 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <PIDController.h>
+#include <PIDInstrumentation.h>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// With a fixed sampling period, the instrumentation must see how regularly the
+// loop really runs, not the nominal period it computes with. The exported
+// histograms must stay cumulative even when the snapshot's sample counter is
+// out of step with its bins.
+//------------------------------------------------------------------------------
+
+static const double SAMPLING_TIME = 0.01;
+
+static double now = 0;
+
+static double testClock() {
+    return now;
+}
+
+TEST(PIDInstrumentation, FixedPeriodRecordsMeasuredIntervals) {
+    PIDInstrumentation instrumentation(SAMPLING_TIME, SAMPLING_TIME / 2);
+    PIDController pid(1, 0.5, 0, SAMPLING_TIME);
+    pid.setClock(testClock);
+    pid.setInstrumentation(&instrumentation);
+    pid.targetSetpoint(1);
+    pid.on();
+    now = 0;
+    for(int k = 0; k < 100; k++) {
+        // One late sample, three periods after the previous one.
+        now += k == 50 ? 3 * SAMPLING_TIME : SAMPLING_TIME;
+        pid.calc(0);
+    }
+    PIDInstrumentationSnapshot snapshot = instrumentation.snapshot();
+    EXPECT_EQ(100u, snapshot.samples);
+    EXPECT_EQ(1u, snapshot.deadlineMisses);
+    EXPECT_NEAR(2 * SAMPLING_TIME, snapshot.maxJitter, 1e-12);
+}
+
+TEST(PIDInstrumentation, ExportedBucketsNeverDecrease) {
+    PIDInstrumentation instrumentation;
+    for(int k = 0; k < 10; k++) {
+        instrumentation.recordSample(1e-3);
+        instrumentation.recordExecution(1e3);
+    }
+    PIDInstrumentationSnapshot snapshot = instrumentation.snapshot();
+    // As if the counters had been copied before the last samples' bins.
+    snapshot.samples = 7;
+    snapshot.executions = 7;
+    std::ostringstream text;
+    PIDInstrumentation::exportText(snapshot, "test", text);
+
+    std::istringstream lines(text.str());
+    std::string line, metric;
+    double last = 0;
+    int infinities = 0;
+    while(std::getline(lines, line)) {
+        size_t space = line.rfind(' ');
+        double value = std::stod(line.substr(space + 1));
+        if(line.find("_bucket{") != std::string::npos) {
+            std::string name = line.substr(0, line.find('{'));
+            if(name != metric) {
+                metric = name;
+                last = 0;
+            }
+            EXPECT_GE(value, last) << line;
+            last = value;
+            if(line.find("+Inf") != std::string::npos) {
+                EXPECT_EQ(10, value) << line;
+                infinities++;
+            }
+        }
+        else if(line.find("_count{") != std::string::npos) {
+            EXPECT_EQ(10, value) << line;
+        }
+    }
+    EXPECT_EQ(2, infinities);
+}
+
+//------------------------------------------------------------------------------
+// A bin's exported bucket bound is inclusive: a duration equal to it is
+// counted in that bucket and the next larger duration in the following one.
+//------------------------------------------------------------------------------
+
+TEST(PIDInstrumentation, BucketBoundsAreInclusive) {
+    std::ostringstream text;
+    PIDInstrumentation::exportText(PIDInstrumentation().snapshot(), "bounds", text);
+    std::istringstream lines(text.str());
+    std::string line;
+    std::vector<double> bounds;
+    while(std::getline(lines, line)) {
+        size_t le = line.find("pid_sampling_time_seconds_bucket{loop=\"bounds\",le=\"");
+        if(le != std::string::npos && line.find("+Inf") == std::string::npos) {
+            size_t begin = line.find("le=\"") + 4;
+            bounds.push_back(std::stod(line.substr(begin, line.find('"', begin) - begin)));
+        }
+    }
+    ASSERT_EQ(PIDInstrumentationSnapshot::BINS - 1, bounds.size());
+    
+    for(unsigned k = 0; k < bounds.size(); k++) {
+        EXPECT_EQ(std::ldexp(1.0, k + 1) * 1e-9, bounds[k]) << "bucket " << k;
+        PIDInstrumentation instrumentation;
+        instrumentation.recordSample(bounds[k]);
+        instrumentation.recordSample(std::nextafter(bounds[k], INFINITY));
+        PIDInstrumentationSnapshot snapshot = instrumentation.snapshot();
+        EXPECT_EQ(1u, snapshot.samplingTimeHistogram[k]) << "bucket " << k;
+        EXPECT_EQ(1u, snapshot.samplingTimeHistogram[k + 1]) << "bucket " << k;
+    }
+}
+
+TEST(PIDInstrumentation, OutOfRangeDurationsGoToTheEndBins) {
+    PIDInstrumentation instrumentation;
+    instrumentation.recordExecution(0);
+    instrumentation.recordExecution(1e-12);
+    instrumentation.recordExecution(1e6);
+    instrumentation.recordExecution(INFINITY);
+    PIDInstrumentationSnapshot snapshot = instrumentation.snapshot();
+    EXPECT_EQ(2u, snapshot.executionTimeHistogram[0]);
+    EXPECT_EQ(2u, snapshot.executionTimeHistogram[PIDInstrumentationSnapshot::BINS - 1]);
+}
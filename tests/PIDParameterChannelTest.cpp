@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <PIDParameterChannel.h>
+#include <PIDController.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+
+// A parameter set whose every field is 'value', so a torn read shows up as
+// fields that disagree.
+static PIDParameters uniform(double value) {
+    PIDParameters parameters;
+    parameters.setpoint = value;
+    parameters.kp = value;
+    parameters.ki = value;
+    parameters.kd = value;
+    parameters.lowerInputLimit = value;
+    parameters.upperInputLimit = value;
+    parameters.lowerOutputLimit = value;
+    parameters.upperOutputLimit = value;
+    return parameters;
+}
+
+static bool isUniform(const PIDParameters& parameters) {
+    const double value = parameters.setpoint;
+    return parameters.kp == value && parameters.ki == value && parameters.kd == value
+        && parameters.lowerInputLimit == value && parameters.upperInputLimit == value
+        && parameters.lowerOutputLimit == value && parameters.upperOutputLimit == value;
+}
+
+//------------------------------------------------------------------------------
+// Single-threaded hand-off.
+//------------------------------------------------------------------------------
+
+TEST(PIDParameterChannel, ConsumeReturnsOnlyFreshSets) {
+    PIDParameterChannel channel;
+    PIDParameters parameters = uniform(-1);
+    EXPECT_FALSE(channel.consume(parameters));
+    EXPECT_EQ(-1, parameters.kp);
+    
+    channel.publish(uniform(1));
+    channel.publish(uniform(2));
+    ASSERT_TRUE(channel.consume(parameters));
+    EXPECT_EQ(2, parameters.kp);
+    EXPECT_TRUE(isUniform(parameters));
+    EXPECT_FALSE(channel.consume(parameters));
+}
+
+TEST(PIDParameterChannel, InitialSetIsFresh) {
+    PIDParameterChannel channel(uniform(3));
+    PIDParameters parameters;
+    ASSERT_TRUE(channel.consume(parameters));
+    EXPECT_TRUE(isUniform(parameters));
+    EXPECT_EQ(3, parameters.setpoint);
+}
+
+TEST(PIDParameterChannel, ControllerAppliesTheSetAtTheNextCalc) {
+    PIDController controller(0, 0, 0, -10, 10, -100, 100);
+    controller.on();
+    PIDParameterChannel channel;
+    controller.setParameterChannel(&channel);
+    PIDParameters parameters = { 2, 1.5, 0.5, 0, -10, 10, -5, 5 };
+    channel.publish(parameters);
+    EXPECT_EQ(0, controller.getKp());
+    controller.calc(0, 0.01);
+    EXPECT_EQ(1.5, controller.getKp());
+    EXPECT_EQ(0.5, controller.getKi());
+    EXPECT_EQ(0, controller.getKd());
+    EXPECT_EQ(2, controller.getSetpoint());
+}
+
+//------------------------------------------------------------------------------
+// One writer and one reader running concurrently: every consumed set must be
+// one that was published whole, and the sets must arrive in publish order,
+// ending with the last one.
+//------------------------------------------------------------------------------
+
+TEST(PIDParameterChannel, ConcurrentReaderNeverSeesATornOrStaleSet) {
+    const int publishes = 200000;
+    PIDParameterChannel channel;
+    std::atomic<bool> done(false);
+    std::thread writer([&]() {
+        for(int i = 1; i <= publishes; i++) {
+            channel.publish(uniform(i));
+        }
+        done.store(true);
+    });
+    
+    double last = 0;
+    long consumed = 0, torn = 0, reordered = 0;
+    PIDParameters parameters;
+    for(;;) {
+        bool finished = done.load();
+        while(channel.consume(parameters)) {
+            consumed++;
+            if(!isUniform(parameters)) {
+                torn++;
+            }
+            if(!(parameters.setpoint > last)) {
+                reordered++;
+            }
+            last = parameters.setpoint;
+        }
+        if(finished) {
+            break;
+        }
+    }
+    writer.join();
+    
+    EXPECT_EQ(0, torn);
+    EXPECT_EQ(0, reordered);
+    EXPECT_GT(consumed, 0);
+    EXPECT_EQ(publishes, last);
+}
@@ -0,0 +1,188 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <RelayAutoTuner.h>
+#include <PIDController.h>
+#include <PIDBank.h>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+// First-order plant with dead time, gain/(tau s + 1) e^(-delay s), discretized
+// exactly for a zero-order hold input.
+class DeadTimePlant {
+    public:
+        DeadTimePlant(double gain, double tau, double delay, double samplingTime)
+            : gain(gain), pole(std::exp(-samplingTime / tau)), inputs((size_t)std::lround(delay / samplingTime), 0.0), next(0), output(0) {}
+        
+        double value() const { return output; }
+        
+        double step(double input) {
+            double delayed = input;
+            if(!inputs.empty()) {
+                delayed = inputs[next];
+                inputs[next] = input;
+                next = (next + 1) % inputs.size();
+            }
+            output = pole * output + (1 - pole) * gain * delayed;
+            return output;
+        }
+        
+    private:
+        double gain, pole;
+        std::vector<double> inputs;
+        size_t next;
+        double output;
+};
+
+static const double samplingTime = 1e-3, tau = 1, delay = 0.2;
+
+// Limit cycle of an ideal relay of amplitude d around this plant:
+// a = gain d (1 - e^(-L/tau)) and Tu = 2L + 2 tau ln(2 - e^(-L/tau)).
+static const double cycleAmplitude = 1 - std::exp(-delay / tau);
+static const double ultimatePeriod = 2 * delay + 2 * tau * std::log(2 - std::exp(-delay / tau));
+static const double ultimateGain = 4 / (M_PI * cycleAmplitude);
+
+//------------------------------------------------------------------------------
+// The tuner on its own, against the analytic limit cycle.
+//------------------------------------------------------------------------------
+
+TEST(RelayAutoTuner, MeasuresTheLimitCycleOfADeadTimePlant) {
+    DeadTimePlant plant(1, tau, delay, samplingTime);
+    RelayAutoTuner tuner(1, 0);
+    tuner.start(0);
+    EXPECT_EQ(RelayAutoTuner::RUNNING, tuner.getState());
+    int k = 0;
+    for(; k < 100000 && tuner.getState() == RelayAutoTuner::RUNNING; k++) {
+        plant.step(tuner.step(0, plant.value(), samplingTime));
+    }
+    ASSERT_EQ(RelayAutoTuner::FINISHED, tuner.getState());
+    EXPECT_NEAR(ultimatePeriod, tuner.getUltimatePeriod(), 0.01 * ultimatePeriod);
+    EXPECT_NEAR(ultimateGain, tuner.getUltimateGain(), 0.01 * ultimateGain);
+    // At least the discarded cycle plus three measured ones.
+    EXPECT_GT(k * samplingTime, 4 * ultimatePeriod);
+}
+
+TEST(RelayAutoTuner, RulesFollowTheUltimatePoint) {
+    DeadTimePlant plant(1, tau, delay, samplingTime);
+    RelayAutoTuner tuner(1, 0);
+    tuner.start(0);
+    for(int k = 0; k < 100000 && tuner.getState() == RelayAutoTuner::RUNNING; k++) {
+        plant.step(tuner.step(0, plant.value(), samplingTime));
+    }
+    double ku = tuner.getUltimateGain(), tu = tuner.getUltimatePeriod();
+    double kp, ki, kd;
+    tuner.setRule(RelayAutoTuner::ZIEGLER_NICHOLS_PID);
+    ASSERT_TRUE(tuner.getGains(kp, ki, kd));
+    EXPECT_DOUBLE_EQ(0.6 * ku, kp);
+    EXPECT_DOUBLE_EQ(0.6 * ku / (tu / 2), ki);
+    EXPECT_DOUBLE_EQ(0.6 * ku * tu / 8, kd);
+    tuner.setRule(RelayAutoTuner::ZIEGLER_NICHOLS_PI);
+    ASSERT_TRUE(tuner.getGains(kp, ki, kd));
+    EXPECT_DOUBLE_EQ(0.45 * ku, kp);
+    EXPECT_DOUBLE_EQ(0.45 * ku / (tu / 1.2), ki);
+    EXPECT_EQ(0, kd);
+    tuner.setRule(RelayAutoTuner::SIMC_PI);
+    ASSERT_TRUE(tuner.getGains(kp, ki, kd));
+    EXPECT_DOUBLE_EQ(ku / M_PI, kp);
+    EXPECT_DOUBLE_EQ(ku / M_PI / (2 * tu), ki);
+    EXPECT_EQ(0, kd);
+}
+
+TEST(RelayAutoTuner, ReverseActingPlantGivesNegativeGains) {
+    DeadTimePlant plant(-1, tau, delay, samplingTime);
+    RelayAutoTuner tuner(-1, 0);
+    tuner.start(0);
+    for(int k = 0; k < 100000 && tuner.getState() == RelayAutoTuner::RUNNING; k++) {
+        plant.step(tuner.step(0, plant.value(), samplingTime));
+    }
+    ASSERT_EQ(RelayAutoTuner::FINISHED, tuner.getState());
+    EXPECT_NEAR(ultimateGain, tuner.getUltimateGain(), 0.01 * ultimateGain);
+    double kp, ki, kd;
+    ASSERT_TRUE(tuner.getGains(kp, ki, kd));
+    EXPECT_LT(kp, 0);
+    EXPECT_LT(ki, 0);
+}
+
+TEST(RelayAutoTuner, TimeoutFailsWithoutGains) {
+    RelayAutoTuner tuner(1, 0);
+    tuner.setTimeout(1);
+    tuner.start(0.5);
+    // A plant that never crosses the setpoint gives no cycles.
+    for(int k = 0; k < 2000; k++) {
+        tuner.step(1, 0, samplingTime);
+    }
+    EXPECT_EQ(RelayAutoTuner::FAILED, tuner.getState());
+    EXPECT_EQ(0.5, tuner.step(1, 0, samplingTime));
+    double kp, ki, kd;
+    EXPECT_FALSE(tuner.getGains(kp, ki, kd));
+}
+
+//------------------------------------------------------------------------------
+// Attached to a controller or to bank lanes, the tuner drives the output and
+// hands over to the tuned gains, which then hold the setpoint.
+//------------------------------------------------------------------------------
+
+TEST(RelayAutoTuner, ControllerAppliesTheTunedGains) {
+    DeadTimePlant plant(1, tau, delay, samplingTime);
+    PIDController pid(0, 0, 0, -5, 5);
+    RelayAutoTuner tuner(1, 0);
+    tuner.setRule(RelayAutoTuner::ZIEGLER_NICHOLS_PI);
+    pid.autoTune(&tuner);
+    for(int k = 0; k < 100000 && tuner.getState() == RelayAutoTuner::RUNNING; k++) {
+        plant.step(pid.calc(plant.value(), samplingTime));
+    }
+    ASSERT_EQ(RelayAutoTuner::FINISHED, tuner.getState());
+    double kp, ki, kd;
+    ASSERT_TRUE(tuner.getGains(kp, ki, kd));
+    EXPECT_EQ(kp, pid.getKp());
+    EXPECT_EQ(ki, pid.getKi());
+    
+    pid.targetSetpoint(1);
+    for(int k = 0; k < 30000; k++) {
+        plant.step(pid.calc(plant.value(), samplingTime));
+    }
+    EXPECT_NEAR(1, plant.value(), 1e-3);
+}
+
+TEST(RelayAutoTuner, BankLanesTuneAtOnceWhileOthersRun) {
+    PIDBank bank(3);
+    std::vector<DeadTimePlant> plants(3, DeadTimePlant(1, tau, delay, samplingTime));
+    plants[2] = DeadTimePlant(2, tau, delay, samplingTime);
+    bank.setGains(1, 1, 1, 0);
+    bank.on(1);
+    bank.targetSetpoint(1, 0.5);
+    RelayAutoTuner tuners[2];
+    bank.autoTune(0, &tuners[0]);
+    bank.autoTune(2, &tuners[1]);
+    std::vector<double> processVariable(3), controlVariable(3);
+    auto step = [&]() {
+        for(size_t lane = 0; lane < 3; lane++) {
+            processVariable[lane] = plants[lane].value();
+        }
+        bank.calcAll(&processVariable[0], &controlVariable[0], 3, samplingTime);
+        for(size_t lane = 0; lane < 3; lane++) {
+            plants[lane].step(controlVariable[lane]);
+        }
+    };
+    for(int k = 0; k < 100000 && (tuners[0].getState() == RelayAutoTuner::RUNNING || tuners[1].getState() == RelayAutoTuner::RUNNING); k++) {
+        step();
+    }
+    ASSERT_EQ(RelayAutoTuner::FINISHED, tuners[0].getState());
+    ASSERT_EQ(RelayAutoTuner::FINISHED, tuners[1].getState());
+    // The second plant has twice the gain, so half the ultimate gain.
+    EXPECT_NEAR(ultimateGain, tuners[0].getUltimateGain(), 0.01 * ultimateGain);
+    EXPECT_NEAR(ultimateGain / 2, tuners[1].getUltimateGain(), 0.01 * ultimateGain);
+    double kp, ki, kd;
+    ASSERT_TRUE(tuners[0].getGains(kp, ki, kd));
+    EXPECT_EQ(kp, bank.getKp(0));
+    EXPECT_EQ(1, bank.getKp(1));
+    
+    for(int k = 0; k < 30000; k++) {
+        step();
+    }
+    EXPECT_NEAR(0, plants[0].value(), 1e-3);
+    EXPECT_NEAR(0.5, plants[1].value(), 1e-3);
+    EXPECT_NEAR(0, plants[2].value(), 1e-3);
+}
@@ -0,0 +1,103 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <SharedControllerState.h>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+//------------------------------------------------------------------------------
+// The segment is mapped several times in one process, at different
+// addresses, as separate processes would map it. Several writers send
+// parameters to one loop at once; the controller side must only ever see
+// complete sets, each as one writer sent it.
+//------------------------------------------------------------------------------
+
+class SharedControllerStateTest : public ::testing::Test {
+    protected:
+        std::string name;
+
+        void SetUp() {
+            name = "/pid-test-" + std::to_string(getpid());
+        }
+
+        void TearDown() {
+            SharedControllerState::remove(name);
+        }
+};
+
+// A set whose every field is 'value', so that a torn set is easy to spot.
+static PIDParameters uniformParameters(double value) {
+    PIDParameters parameters = { value, value, value, value, value, value, value, value };
+    return parameters;
+}
+
+static bool isUniform(const PIDParameters& parameters) {
+    const double* field = &parameters.setpoint;
+    for(size_t i = 1; i < sizeof(parameters) / sizeof(double); i++) {
+        if(field[i] != field[0]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_F(SharedControllerStateTest, PublishedStateIsReadThroughAnotherMapping) {
+    SharedControllerState owner, reader;
+    ASSERT_TRUE(owner.create(name, 4));
+    ASSERT_TRUE(reader.open(name));
+    PIDController pid(1.5, 0.8, 0.01, 0.01);
+    pid.on();
+    pid.targetSetpoint(2.0);
+    pid.calc(0.5);
+    owner.publish(2, pid);
+    PIDState state;
+    ASSERT_TRUE(reader.read(2, state));
+    PIDState published = pid.getState();
+    EXPECT_EQ(0, std::memcmp(&state, &published, sizeof(state)));
+}
+
+TEST_F(SharedControllerStateTest, ConcurrentWritersNeverTearParameterSets) {
+    SharedControllerState owner;
+    ASSERT_TRUE(owner.create(name, 1));
+    const int writers = 3, sets = 20000;
+    std::vector<SharedControllerState> mappings(writers);
+    for(int i = 0; i < writers; i++) {
+        ASSERT_TRUE(mappings[i].open(name));
+    }
+
+    std::atomic<int> running(writers);
+    std::vector<std::thread> threads;
+    for(int i = 0; i < writers; i++) {
+        threads.emplace_back([&mappings, &running, i] {
+            for(int k = 1; k <= sets; k++) {
+                EXPECT_TRUE(mappings[i].setParameters(0, uniformParameters(i * sets + k)));
+            }
+            running--;
+        });
+    }
+    PIDParameterChannel* channel = owner.getChannel(0);
+    PIDParameters parameters;
+    size_t consumed = 0, torn = 0;
+    while(running.load() > 0) {
+        if(channel->consume(parameters)) {
+            consumed++;
+            torn += !isUniform(parameters);
+        }
+        std::this_thread::yield();
+    }
+    for(size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    if(channel->consume(parameters)) {
+        consumed++;
+        torn += !isUniform(parameters);
+    }
+    EXPECT_GT(consumed, 0u);
+    EXPECT_EQ(0u, torn) << "of " << consumed;
+}
@@ -0,0 +1,97 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <StaticPIDController.h>
+#include <FixedPoint.h>
+#include <PIDController.h>
+#include <gtest/gtest.h>
+
+static constexpr pid::StaticGains<double> pi = { 2.0, 0.5, 0.0, -1.0, 1.0, 0.01 };
+static constexpr pid::StaticGains<double> pidGains = { 1.5, 4.0, 0.02, -10.0, 10.0, 0.001 };
+static constexpr pid::StaticGains<double> unlimited = { 1.0, 1.0, 0.0, 0.0, 0.0, 0.0 };
+static constexpr pid::StaticGains<float> piFloat = { 2.0f, 0.5f, 0.0f, -1.0f, 1.0f, 0.01f };
+static constexpr pid::StaticGains<pid::Q31> piQ31 = { pid::Q31(0.5), pid::Q31(0.25), pid::Q31(0), pid::Q31(-0.5), pid::Q31(0.5), pid::Q31(0.125) };
+
+//------------------------------------------------------------------------------
+// Every member is constexpr, so whole runs can be checked at compile time.
+//------------------------------------------------------------------------------
+
+template <const auto& Gains>
+constexpr auto stepsTowards(typename pid::StaticPIDController<Gains>::Scalar setpoint,
+                            typename pid::StaticPIDController<Gains>::Scalar processVariable, int steps) {
+    pid::StaticPIDController<Gains> loop;
+    loop.targetSetpoint(setpoint);
+    loop.on();
+    typename pid::StaticPIDController<Gains>::Scalar output = loop.calc(processVariable);
+    for(int k = 1; k < steps; k++) {
+        output = loop.calc(processVariable);
+    }
+    return output;
+}
+
+// kp e + ki (e T) for e = 0.25 and T = 0.01 on the first step, then the
+// integrator winds up until the output clamps at the upper limit.
+static_assert(stepsTowards<pi>(0.5, 0.25, 1) == 2.0 * 0.25 + 0.5 * (0.25 * 0.01), "first step of a PI loop");
+static_assert(stepsTowards<pi>(0.5, 0.25, 1000) == 1.0, "the output clamps at the upper limit");
+static_assert(stepsTowards<pi>(-0.5, 0.25, 1000) == -1.0, "the output clamps at the lower limit");
+static_assert(stepsTowards<piQ31>(pid::Q31(0.25), pid::Q31(0), 1) == pid::Q31(0.5) * pid::Q31(0.25) + pid::Q31(0.25) * (pid::Q31(0.25) * pid::Q31(0.125)),
+              "first step of a Q31 PI loop");
+// The integrator stops at the output limit, which holds the Q31 output below it.
+static_assert(stepsTowards<piQ31>(pid::Q31(0.25), pid::Q31(0), 10000) == pid::Q31(0.5) * pid::Q31(0.25) + pid::Q31(0.25) * pid::Q31(0.5),
+              "the Q31 integrator clamps");
+
+// Only the setpoint and the running state are stored.
+static_assert(sizeof(pid::StaticPIDController<pi>) == 32, "double PI loop");
+static_assert(sizeof(pid::StaticPIDController<piFloat>) == 16, "float PI loop");
+static_assert(sizeof(pid::StaticPIDController<piQ31>) == 16, "Q31 PI loop");
+static_assert(pid::StaticPIDController<pi>::hasOutputLimits && !pid::StaticPIDController<pi>::hasDerivative, "compiled-in terms");
+static_assert(!pid::StaticPIDController<unlimited>::hasOutputLimits && !pid::StaticPIDController<unlimited>::hasFixedTimestep, "unlimited loop");
+
+//------------------------------------------------------------------------------
+// At run time, a static loop computes what ::PIDController does with the
+// same settings.
+//------------------------------------------------------------------------------
+
+template <const auto& Gains>
+static void expectMatchesPIDController() {
+    pid::StaticPIDController<Gains> loop;
+    PIDController reference(Gains.kp, Gains.ki, Gains.kd, Gains.lowerOutputLimit, Gains.upperOutputLimit);
+    loop.on();
+    reference.on();
+    double plant = 0;
+    for(int k = 0; k < 5000; k++) {
+        if(k % 1000 == 0) {
+            loop.targetSetpoint(k % 2000 ? -0.5 : 2.0);
+            reference.targetSetpoint(k % 2000 ? -0.5 : 2.0);
+        }
+        double output = loop.calc(plant, 0.001);
+        ASSERT_EQ(reference.calc(plant, 0.001), output) << "step " << k;
+        plant += 0.001 * (output - plant) / 0.05;
+    }
+}
+
+TEST(StaticPIDController, MatchesPIDControllerWithOutputLimits) {
+    expectMatchesPIDController<pi>();
+}
+
+TEST(StaticPIDController, MatchesPIDControllerWithDerivative) {
+    expectMatchesPIDController<pidGains>();
+}
+
+TEST(StaticPIDController, MatchesPIDControllerWithoutLimits) {
+    expectMatchesPIDController<unlimited>();
+}
+
+TEST(StaticPIDController, OffHoldsAndOnResumesBumplessly) {
+    pid::StaticPIDController<pi> loop;
+    loop.targetSetpoint(0.5);
+    loop.on();
+    double held = loop.calc(0.25);
+    loop.off();
+    EXPECT_EQ(held, loop.calc(0));
+    loop.on();
+    loop.targetSetpoint(0);
+    // With no error, the integrator restarts from the held output.
+    EXPECT_EQ(0.5 * held, loop.calc(0));
+}
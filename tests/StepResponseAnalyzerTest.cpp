@@ -0,0 +1,105 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <StepResponseAnalyzer.h>
+#include <PIDController.h>
+#include <gtest/gtest.h>
+#include <cmath>
+
+//------------------------------------------------------------------------------
+// The online metrics against the closed forms of first- and second-order step
+// responses, sampled from the sample at which the setpoint changes.
+//------------------------------------------------------------------------------
+
+TEST(StepResponseAnalyzer, FirstOrderResponse) {
+    const double tau = 0.5, samplingTime = 1e-4;
+    StepResponseAnalyzer analyzer(0.02);
+    for(int k = 0; k <= 50000; k++) {
+        analyzer.update(1, 1 - std::exp(-k * samplingTime / tau), samplingTime);
+    }
+    StepResponseMetrics metrics = analyzer.getMetrics();
+    EXPECT_EQ(0, metrics.initialValue);
+    EXPECT_EQ(1, metrics.setpoint);
+    EXPECT_NEAR(5, metrics.elapsed, 1e-9);
+    EXPECT_NEAR(tau * std::log(9.0), metrics.riseTime, 2 * samplingTime);
+    EXPECT_EQ(0, metrics.overshoot);
+    EXPECT_NEAR(tau * std::log(50.0), metrics.settlingTime, 2 * samplingTime);
+    EXPECT_NEAR(tau, metrics.iae, 1e-3);
+    EXPECT_NEAR(tau / 2, metrics.ise, 1e-3);
+    EXPECT_TRUE(metrics.settled);
+    EXPECT_TRUE(analyzer.hasSettled());
+}
+
+TEST(StepResponseAnalyzer, UnderdampedSecondOrderResponse) {
+    const double zeta = 0.3, omega = 10, samplingTime = 1e-5;
+    const double omegaD = omega * std::sqrt(1 - zeta * zeta);
+    StepResponseAnalyzer analyzer;
+    // A step from 2 to 4, so peak and overshoot are relative to the step.
+    for(int k = 0; k <= 300000; k++) {
+        double t = k * samplingTime;
+        double response = 1 - std::exp(-zeta * omega * t) * (std::cos(omegaD * t) + zeta / std::sqrt(1 - zeta * zeta) * std::sin(omegaD * t));
+        analyzer.update(4, 2 + 2 * response, samplingTime);
+    }
+    StepResponseMetrics metrics = analyzer.getMetrics();
+    const double overshoot = 100 * std::exp(-M_PI * zeta / std::sqrt(1 - zeta * zeta));
+    EXPECT_EQ(2, metrics.initialValue);
+    EXPECT_NEAR(1 + overshoot / 100, metrics.peak, 1e-6);
+    EXPECT_NEAR(M_PI / omegaD, metrics.peakTime, 2 * samplingTime);
+    EXPECT_NEAR(overshoot, metrics.overshoot, 1e-4);
+    EXPECT_LT(metrics.riseTime, metrics.peakTime);
+    // The response stays within 2% once its envelope does, after about 1.3 s.
+    EXPECT_GT(metrics.settlingTime, 0.8);
+    EXPECT_LT(metrics.settlingTime, std::log(50.0 / std::sqrt(1 - zeta * zeta)) / (zeta * omega));
+    EXPECT_TRUE(metrics.settled);
+}
+
+TEST(StepResponseAnalyzer, LeavingTheBandClearsTheSettlingTime) {
+    StepResponseAnalyzer analyzer(0.1);
+    analyzer.update(1, 0, 0.1);
+    analyzer.update(1, 0.95, 0.1);
+    EXPECT_NEAR(0.1, analyzer.getMetrics().settlingTime, 1e-12);
+    analyzer.update(1, 0.5, 0.1);
+    EXPECT_FALSE(analyzer.hasSettled());
+    EXPECT_EQ(INFINITY, analyzer.getMetrics().settlingTime);
+    analyzer.update(1, 1, 0.1);
+    EXPECT_NEAR(0.3, analyzer.getMetrics().settlingTime, 1e-12);
+}
+
+TEST(StepResponseAnalyzer, SetpointChangeStartsANewStep) {
+    StepResponseAnalyzer analyzer;
+    analyzer.update(1, 0, 0.1);
+    analyzer.update(1, 1.5, 0.1);
+    EXPECT_EQ(50, std::round(analyzer.getMetrics().overshoot));
+    analyzer.update(2, 1.5, 0.1);
+    StepResponseMetrics metrics = analyzer.getMetrics();
+    EXPECT_EQ(1.5, metrics.initialValue);
+    EXPECT_EQ(2, metrics.setpoint);
+    EXPECT_EQ(0, metrics.elapsed);
+    EXPECT_EQ(0, metrics.overshoot);
+    EXPECT_EQ(INFINITY, metrics.riseTime);
+    EXPECT_EQ(0, metrics.iae);
+}
+
+//------------------------------------------------------------------------------
+// Attached to a controller, every calc() updates it, and hasSettled() reports
+// the analyzer's band instead of the fixed rate test.
+//------------------------------------------------------------------------------
+
+TEST(StepResponseAnalyzer, ControllerUpdatesTheAttachedAnalyzer) {
+    PIDController pid(2, 5, 0, -10, 10);
+    StepResponseAnalyzer analyzer(0.02);
+    pid.setStepResponseAnalyzer(&analyzer);
+    pid.targetSetpoint(1);
+    pid.on();
+    double plant = 0;
+    for(int k = 0; k < 5000; k++) {
+        double output = pid.calc(plant, 0.001);
+        plant += 0.001 * (output - plant) / 0.2;
+    }
+    StepResponseMetrics metrics = analyzer.getMetrics();
+    EXPECT_NEAR(4.999, metrics.elapsed, 1e-9);
+    EXPECT_TRUE(metrics.settled);
+    EXPECT_TRUE(pid.hasSettled());
+    EXPECT_LT(metrics.riseTime, metrics.settlingTime);
+}
@@ -0,0 +1,59 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <Telemetry.h>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+//------------------------------------------------------------------------------
+// Every recorded sample must either reach the file or be reported: a full
+// device (/dev/full) makes close() fail and counts the lost samples, while a
+// healthy file reads back with every sample.
+//------------------------------------------------------------------------------
+
+static const int SAMPLES = 1000;
+static const size_t CHUNK_ROWS = 64;
+
+static void recordSamples(TelemetryRecorder& recorder) {
+    for(int k = 0; k < SAMPLES; k++) {
+        TelemetrySample sample = TelemetrySample();
+        sample.time = k * 0.01;
+        sample.output = k;
+        ASSERT_TRUE(recorder.record(sample));
+    }
+}
+
+TEST(TelemetryRecorder, ReportsSamplesLostOnAFullDevice) {
+    if(access("/dev/full", W_OK) != 0) {
+        GTEST_SKIP() << "no /dev/full";
+    }
+    TelemetryRecorder recorder(SAMPLES, CHUNK_ROWS);
+    ASSERT_TRUE(recorder.open("/dev/full"));
+    recordSamples(recorder);
+    EXPECT_FALSE(recorder.close());
+    EXPECT_EQ((uint64_t)SAMPLES, recorder.getRecorded());
+    EXPECT_EQ((uint64_t)SAMPLES, recorder.getWriteErrors());
+}
+
+TEST(TelemetryRecorder, WritesEverySampleToAHealthyFile) {
+    char name[] = "/tmp/pid-telemetry-XXXXXX";
+    int descriptor = mkstemp(name);
+    ASSERT_GE(descriptor, 0);
+    close(descriptor);
+    TelemetryRecorder recorder(SAMPLES, CHUNK_ROWS);
+    ASSERT_TRUE(recorder.open(name));
+    recordSamples(recorder);
+    EXPECT_TRUE(recorder.close());
+    EXPECT_EQ(0u, recorder.getWriteErrors());
+    TelemetryReader reader;
+    ASSERT_TRUE(reader.open(name));
+    EXPECT_EQ((size_t)SAMPLES, reader.size());
+    TelemetrySample sample;
+    ASSERT_TRUE(reader.getSample(SAMPLES - 1, sample));
+    EXPECT_EQ(SAMPLES - 1, sample.output);
+    reader.close();
+    std::remove(name);
+}
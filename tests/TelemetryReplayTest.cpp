@@ -0,0 +1,99 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <Telemetry.h>
+#include <TelemetryReplay.h>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+//------------------------------------------------------------------------------
+// A loop is recorded to a temporary file and replayed: the same gains must
+// reproduce it exactly, and a controller that outputs NaN must be reported
+// as diverged, not as a perfect match.
+//------------------------------------------------------------------------------
+
+static const int SAMPLES = 2000;
+static const double SAMPLING_TIME = 0.01;
+
+class TelemetryReplayTest : public ::testing::Test {
+    protected:
+        std::string path;
+
+        void SetUp() {
+            char name[] = "/tmp/pid-telemetry-XXXXXX";
+            int descriptor = mkstemp(name);
+            ASSERT_GE(descriptor, 0);
+            close(descriptor);
+            path = name;
+        }
+
+        void TearDown() {
+            std::remove(path.c_str());
+        }
+
+        // Records a loop of 'pid' on a first-order plant, with the recorded
+        // output replaced by 'recordedOutput' from sample 'from' on.
+        void record(PIDController& pid, int from = SAMPLES, double recordedOutput = 0) {
+            TelemetryRecorder recorder(SAMPLES, 256);
+            ASSERT_TRUE(recorder.open(path));
+            double processVariable = 0;
+            for(int k = 0; k < SAMPLES; k++) {
+                PIDOutput output = pid.calcDetailed(processVariable, SAMPLING_TIME);
+                processVariable += 0.05 * (output.output - processVariable);
+                if(k >= from) {
+                    output.output = recordedOutput;
+                }
+                ASSERT_TRUE(recorder.record(k * SAMPLING_TIME, 0, output));
+            }
+            ASSERT_TRUE(recorder.close());
+        }
+
+        ReplayStatistics replay(double kp, double ki, double kd) {
+            TelemetryReader reader;
+            EXPECT_TRUE(reader.open(path));
+            PIDController pid(kp, ki, kd);
+            pid.on();
+            TelemetryReplay replay;
+            replay.add(&pid, 0);
+            EXPECT_TRUE(replay.run(reader, 1));
+            return replay.getStatistics(0);
+        }
+};
+
+static PIDController recordedController() {
+    PIDController pid(1.5, 0.8, 0.01);
+    pid.on();
+    pid.targetSetpoint(1.0);
+    return pid;
+}
+
+TEST_F(TelemetryReplayTest, SameGainsReproduceTheRecording) {
+    PIDController pid = recordedController();
+    record(pid);
+    ReplayStatistics statistics = replay(1.5, 0.8, 0.01);
+    EXPECT_EQ((uint64_t)SAMPLES, statistics.samples);
+    EXPECT_EQ(0u, statistics.diverged);
+    EXPECT_EQ(0, statistics.maxDifference);
+}
+
+TEST_F(TelemetryReplayTest, NaNOutputsDiverge) {
+    PIDController pid = recordedController();
+    record(pid);
+    ReplayStatistics statistics = replay(NAN, 0.8, 0.01);
+    EXPECT_EQ((uint64_t)SAMPLES, statistics.diverged);
+    EXPECT_EQ(INFINITY, statistics.maxDifference);
+    EXPECT_EQ(0, statistics.firstDivergenceTime);
+}
+
+TEST_F(TelemetryReplayTest, RecordedNaNsAreMatchedOnlyByNaNs) {
+    PIDController pid = recordedController();
+    record(pid, SAMPLES / 2, NAN);
+    ReplayStatistics statistics = replay(1.5, 0.8, 0.01);
+    EXPECT_EQ((uint64_t)SAMPLES / 2, statistics.diverged);
+    EXPECT_EQ(INFINITY, statistics.maxDifference);
+    EXPECT_DOUBLE_EQ(SAMPLES / 2 * SAMPLING_TIME, statistics.firstDivergenceTime);
+}
@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <PIDController.h>
+#include <PIDBank.h>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// The positional and velocity forms are the same controller as long as the
+// output is not limited: the velocity form sums the increments of the
+// positional output. Both are run side by side in closed loop on their own
+// first-order plant, through setpoint steps, and must agree to rounding.
+//------------------------------------------------------------------------------
+
+static const double SAMPLING_TIME = 0.001;
+static const int STEPS = 20000;
+// Outputs are of order 10; the two forms round differently, and the
+// difference grows with the number of accumulated increments.
+static const double TOLERANCE = 1e-9;
+
+static double setpointAt(int step) {
+    return (step / 5000) % 2 ? -2.0 : 1.5;
+}
+
+static void configure(PIDController& pid, PIDController::Algorithm algorithm) {
+    pid.setGains(2.0, 1.2, 0.02);
+    pid.setSamplingPeriod(SAMPLING_TIME);
+    pid.setAlgorithm(algorithm);
+    pid.on();
+}
+
+static void expectFormsAgree(PIDController& positional, PIDController& velocity) {
+    double positionalPlant = 0, velocityPlant = 0;
+    for(int k = 0; k < STEPS; k++) {
+        positional.targetSetpoint(setpointAt(k));
+        velocity.targetSetpoint(setpointAt(k));
+        double positionalOutput = positional.calc(positionalPlant);
+        double velocityOutput = velocity.calc(velocityPlant);
+        ASSERT_NEAR(positionalOutput, velocityOutput, TOLERANCE) << "at step " << k;
+        positionalPlant += SAMPLING_TIME * (positionalOutput - positionalPlant) / 0.2;
+        velocityPlant += SAMPLING_TIME * (velocityOutput - velocityPlant) / 0.2;
+    }
+}
+
+TEST(VelocityForm, MatchesPositionalWithoutSaturation) {
+    PIDController positional, velocity;
+    configure(positional, PIDController::POSITIONAL);
+    configure(velocity, PIDController::VELOCITY);
+    expectFormsAgree(positional, velocity);
+}
+
+TEST(VelocityForm, MatchesPositionalWithFilteredDerivativeOnMeasurement) {
+    PIDController positional, velocity;
+    configure(positional, PIDController::POSITIONAL);
+    configure(velocity, PIDController::VELOCITY);
+    positional.setDerivativeMode(PIDController::DERIVATIVE_ON_MEASUREMENT);
+    velocity.setDerivativeMode(PIDController::DERIVATIVE_ON_MEASUREMENT);
+    positional.setDerivativeFilter(0.01);
+    velocity.setDerivativeFilter(0.01);
+    expectFormsAgree(positional, velocity);
+}
+
+TEST(VelocityForm, MatchesPositionalWithinWideOutputLimits) {
+    PIDController positional, velocity;
+    configure(positional, PIDController::POSITIONAL);
+    configure(velocity, PIDController::VELOCITY);
+    // Never reached, so neither form is limited.
+    positional.setOutputLimits(-1000, 1000);
+    velocity.setOutputLimits(-1000, 1000);
+    expectFormsAgree(positional, velocity);
+}
+
+TEST(VelocityForm, BankMatchesPositionalOnEveryIsa) {
+    const size_t lanes = 19;
+    for(int isa = PIDBank::ISA_SCALAR; isa <= PIDBank::ISA_NEON; isa++) {
+        PIDBank positional(lanes), velocity(lanes);
+        if(!positional.setIsa((PIDBank::Isa)isa) || !velocity.setIsa((PIDBank::Isa)isa)) {
+            continue;
+        }
+        velocity.setAlgorithm(PIDBank::VELOCITY);
+        for(size_t i = 0; i < lanes; i++) {
+            double kp = 1.0 + 0.1 * i, ki = 0.5 + 0.05 * i, kd = 0.001 * i;
+            positional.setGains(i, kp, ki, kd);
+            velocity.setGains(i, kp, ki, kd);
+            positional.on(i);
+            velocity.on(i);
+        }
+        std::vector<double> positionalPlant(lanes, 0), velocityPlant(lanes, 0);
+        std::vector<double> positionalOutput(lanes), velocityOutput(lanes);
+        for(int k = 0; k < STEPS; k++) {
+            for(size_t i = 0; i < lanes; i++) {
+                positional.targetSetpoint(i, setpointAt(k));
+                velocity.targetSetpoint(i, setpointAt(k));
+            }
+            positional.calcAll(&positionalPlant[0], &positionalOutput[0], lanes, SAMPLING_TIME);
+            velocity.calcAll(&velocityPlant[0], &velocityOutput[0], lanes, SAMPLING_TIME);
+            for(size_t i = 0; i < lanes; i++) {
+                ASSERT_NEAR(positionalOutput[i], velocityOutput[i], TOLERANCE)
+                    << "isa " << isa << ", lane " << i << ", step " << k;
+                positionalPlant[i] += SAMPLING_TIME * (positionalOutput[i] - positionalPlant[i]) / 0.2;
+                velocityPlant[i] += SAMPLING_TIME * (velocityOutput[i] - velocityPlant[i]) / 0.2;
+            }
+        }
+    }
+}
@@ -0,0 +1,64 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <Telemetry.h>
+#include <cstdio>
+
+//------------------------------------------------------------------------------
+// Converts a telemetry file to CSV, one row per sample with a header line:
+//
+//     telemetry2csv PIDexample.tlm > PIDexample.csv
+//     telemetry2csv PIDexample.tlm PIDexample.csv
+//------------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    if(argc < 2 || argc > 3) {
+        std::fprintf(stderr, "usage: %s <telemetry file> [csv file]\n", argv[0]);
+        return 2;
+    }
+    
+    TelemetryReader reader;
+    if(!reader.open(argv[1])) {
+        std::fprintf(stderr, "%s: cannot read telemetry file %s\n", argv[0], argv[1]);
+        return 1;
+    }
+    
+    std::FILE* out = stdout;
+    if(argc == 3) {
+        out = std::fopen(argv[2], "w");
+        if(!out) {
+            std::fprintf(stderr, "%s: cannot create %s\n", argv[0], argv[2]);
+            return 1;
+        }
+    }
+    
+    for(int c = 0; c < TELEMETRY_COLUMNS; c++) {
+        std::fprintf(out, c == 0 ? "%s" : ",%s", TelemetryReader::columnName((TelemetryColumn)c));
+    }
+    std::fputc('\n', out);
+    
+    for(size_t chunk = 0; chunk < reader.getChunks(); chunk++) {
+        const double* columns[TELEMETRY_COLUMNS];
+        for(int c = 0; c < TELEMETRY_COLUMNS; c++) {
+            columns[c] = reader.column(chunk, (TelemetryColumn)c);
+        }
+        for(size_t row = 0; row < reader.getRows(chunk); row++) {
+            for(int c = 0; c < TELEMETRY_COLUMNS; c++) {
+                if(c == TELEMETRY_CHANNEL) {
+                    std::fprintf(out, ",%u", (unsigned)columns[c][row]);
+                }
+                else {
+                    std::fprintf(out, c == 0 ? "%.17g" : ",%.17g", columns[c][row]);
+                }
+            }
+            std::fputc('\n', out);
+        }
+    }
+    
+    if(out != stdout) {
+        std::fclose(out);
+    }
+    return 0;
+}
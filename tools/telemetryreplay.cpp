@@ -0,0 +1,132 @@
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+
+#include <TelemetryReplay.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+
+//------------------------------------------------------------------------------
+// Replays a telemetry file through one controller per gain variant and
+// reports how far each one's output is from the recorded output:
+//
+//     telemetryreplay [-c channel] [-j threads] [-t tolerance]
+//                     [-l lower,upper] <telemetry file> kp,ki,kd [kp,ki,kd ...]
+//
+//     telemetryreplay -l -10,10 PIDexample.tlm 1.5,0.8,0.01 1.6,0.8,0.01
+//
+// The variants replay the samples of 'channel' (default 0) with output limits
+// 'lower,upper' (default none), spread over 'threads' threads (default one
+// per hardware thread). The exit status is 0 if no variant diverged by more
+// than 'tolerance' (default 1e-9), 3 if one did, 1 on errors and 2 on bad
+// usage, so a gain change or upgrade can be checked in a script.
+//------------------------------------------------------------------------------
+
+static bool parseList(const char* text, double* values, int count)
+{
+    for(int i = 0; i < count; i++) {
+        char* end;
+        values[i] = std::strtod(text, &end);
+        if(end == text || *end != (i + 1 < count ? ',' : '\0')) {
+            return false;
+        }
+        text = end + 1;
+    }
+    return true;
+}
+
+static int usage(const char* program)
+{
+    std::fprintf(stderr, "usage: %s [-c channel] [-j threads] [-t tolerance] [-l lower,upper]"
+            " <telemetry file> kp,ki,kd [kp,ki,kd ...]\n", program);
+    return 2;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned long channel = 0;
+    unsigned threads = 0;
+    double tolerance = 1e-9;
+    double limits[2] = { 0, 0 };
+
+    int arg = 1;
+    for(; arg + 1 < argc && argv[arg][0] == '-'; arg += 2) {
+        const char* value = argv[arg + 1];
+        char* end = 0;
+        bool valid;
+        if(std::strcmp(argv[arg], "-c") == 0) {
+            channel = std::strtoul(value, &end, 10);
+        }
+        else if(std::strcmp(argv[arg], "-j") == 0) {
+            threads = (unsigned)std::strtoul(value, &end, 10);
+        }
+        else if(std::strcmp(argv[arg], "-t") == 0) {
+            tolerance = std::strtod(value, &end);
+        }
+        else if(std::strcmp(argv[arg], "-l") != 0) {
+            return usage(argv[0]);
+        }
+        if(end) {
+            valid = end != value && *end == '\0';
+        }
+        else {
+            valid = parseList(value, limits, 2);
+        }
+        if(!valid) {
+            return usage(argv[0]);
+        }
+    }
+    if(argc - arg < 2) {
+        return usage(argv[0]);
+    }
+
+    TelemetryReader reader;
+    if(!reader.open(argv[arg])) {
+        std::fprintf(stderr, "%s: cannot read telemetry file %s\n", argv[0], argv[arg]);
+        return 1;
+    }
+
+    // A deque never moves its elements, so the replay can keep pointers.
+    std::deque<PIDController> controllers;
+    TelemetryReplay replay(tolerance);
+    for(int i = arg + 1; i < argc; i++) {
+        double gains[3];
+        if(!parseList(argv[i], gains, 3)) {
+            std::fprintf(stderr, "%s: bad gains %s, expected kp,ki,kd\n", argv[0], argv[i]);
+            return 2;
+        }
+        controllers.emplace_back(gains[0], gains[1], gains[2]);
+        controllers.back().setOutputLimits(limits[0], limits[1]);
+        controllers.back().on();
+        replay.add(&controllers.back(), (uint32_t)channel);
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if(threads > 0) {
+        replay.run(reader, threads);
+    }
+    else {
+        replay.run(reader);
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    bool diverged = false;
+    std::printf("%-24s %12s %12s %12s %12s %12s %14s\n",
+            "kp,ki,kd", "samples", "diverged", "max", "rms", "mean", "first at");
+    for(size_t i = 0; i < replay.getControllers(); i++) {
+        ReplayStatistics statistics = replay.getStatistics(i);
+        std::printf("%-24s %12llu %12llu %12.4g %12.4g %12.4g %14.6g\n", argv[arg + 1 + i],
+                (unsigned long long)statistics.samples, (unsigned long long)statistics.diverged,
+                statistics.maxDifference, statistics.rmsDifference, statistics.meanDifference,
+                statistics.firstDivergenceTime);
+        diverged = diverged || statistics.diverged > 0;
+    }
+
+    double bytes = (double)reader.size() * TELEMETRY_COLUMNS * sizeof(double);
+    std::fprintf(stderr, "%zu samples (%.1f MB) through %zu controllers in %.3f s, %.2f GB/s\n",
+            reader.size(), bytes / 1e6, replay.getControllers(), elapsed, bytes / 1e9 / elapsed);
+    return diverged ? 3 : 0;
+}